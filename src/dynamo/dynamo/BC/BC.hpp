@@ -33,6 +33,8 @@ namespace dynamo {
 class IntEvent;
 class Simulation;
 class Particle;
+class CheckpointWriter;
+class CheckpointReader;
 
 /*! \brief The base class for the Boundary Conditions of the simulation.
 
@@ -95,6 +97,15 @@ public:
   /*! \brief Stream the boundary conditions forward in time.*/
   virtual void update(const double &) {};
 
+  /*! \brief Write any state of the boundary condition which is not
+      stored exactly in the configuration file to a checkpoint (see
+      Simulation::writeCheckpoint).
+   */
+  virtual void saveCheckpoint(CheckpointWriter &) const {}
+
+  //! \brief Restore the state written by saveCheckpoint().
+  virtual void loadCheckpoint(CheckpointReader &) {}
+
   /*! \brief Load the Boundary condition from an XML file. */
   virtual void operator<<(const magnet::xml::Node &) = 0;
 
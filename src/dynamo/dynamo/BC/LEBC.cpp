@@ -17,6 +17,7 @@
 
 #include <cmath>
 #include <dynamo/BC/LEBC.hpp>
+#include <dynamo/checkpoint.hpp>
 #include <dynamo/simulation.hpp>
 #include <magnet/xmlreader.hpp>
 #include <magnet/xmlwriter.hpp>
@@ -52,20 +53,10 @@ void BCLeesEdwards::operator<<(const magnet::xml::Node &XML) {
   _shearRate /= Sim->units.unitTime();
 }
 
-void BCLeesEdwards::applyBC(Vector &pos) const {
-  // Shift the x distance due to the Lee's Edwards conditions
-  pos[0] -= rint(pos[1] / Sim->primaryCellSize[1]) * _dxd;
-
-  for (size_t n = 0; n < NDIM; ++n)
-    pos[n] = std::remainder(pos[n], Sim->primaryCellSize[n]);
-}
+void BCLeesEdwards::applyBC(Vector &pos) const { minimumImage(pos); }
 
 void BCLeesEdwards::applyBC(Vector &pos, Vector &vel) const {
-  // Adjust the velocity due to the box shift
-  vel[0] -= rint(pos[1] / Sim->primaryCellSize[1]) * _shearRate *
-            Sim->primaryCellSize[1];
-
-  applyBC(pos);
+  minimumImage(pos, vel);
 }
 
 void BCLeesEdwards::applyBC(Vector &posVec, const double &dt) const {
@@ -86,6 +77,12 @@ void BCLeesEdwards::update(const double &dt) {
   _dxd -= floor(_dxd / Sim->primaryCellSize[0]) * Sim->primaryCellSize[0];
 }
 
+void BCLeesEdwards::saveCheckpoint(CheckpointWriter &out) const {
+  out.write(_dxd);
+}
+
+void BCLeesEdwards::loadCheckpoint(CheckpointReader &in) { in.read(_dxd); }
+
 Vector BCLeesEdwards::getStreamVelocity(const Particle &part) const {
   return Vector{part.getPosition()[1] * _shearRate, 0, 0};
 }
@@ -16,7 +16,9 @@
 */
 
 #pragma once
+#include <cmath>
 #include <dynamo/BC/PBC.hpp>
+#include <dynamo/simulation.hpp>
 
 namespace dynamo {
 class Particle;
@@ -49,6 +51,10 @@ public:
 
   virtual void update(const double &);
 
+  virtual void saveCheckpoint(CheckpointWriter &) const;
+
+  virtual void loadCheckpoint(CheckpointReader &);
+
   /*! \brief Returns the shear rate of the boundaries. */
   inline double getShearRate() const { return _shearRate; }
 
@@ -83,6 +89,28 @@ public:
 
   double getBoundaryDisplacement() const { return _dxd; }
 
+  /*! \brief The minimum image of a separation and relative velocity.
+
+    This is applyBC(Vector &, Vector &) without the virtual call, so
+    that it may be inlined into the pair tests of the dynamics (see
+    DynNewtonian). The images are counted once for the position and
+    velocity shifts.
+   */
+  inline void minimumImage(Vector &rij, Vector &vij) const {
+    const double images = std::rint(rij[1] / Sim->primaryCellSize[1]);
+    vij[0] -= images * _shearRate * Sim->primaryCellSize[1];
+    rij[0] -= images * _dxd;
+    for (size_t n = 0; n < NDIM; ++n)
+      rij[n] = std::remainder(rij[n], Sim->primaryCellSize[n]);
+  }
+
+  //! \brief The minimum image of a separation (see above).
+  inline void minimumImage(Vector &rij) const {
+    rij[0] -= std::rint(rij[1] / Sim->primaryCellSize[1]) * _dxd;
+    for (size_t n = 0; n < NDIM; ++n)
+      rij[n] = std::remainder(rij[n], Sim->primaryCellSize[n]);
+  }
+
 protected:
   /*! \brief The amount neighboring periodic images have slid against
       each other.
@@ -0,0 +1,169 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <cstdint>
+#include <istream>
+#include <magnet/exception.hpp>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace dynamo {
+/*! \brief Writes the binary state of a simulation for a fast restart
+    (see Simulation::writeCheckpoint).
+
+  Values are written as raw bytes in the native layout, so a
+  checkpoint may only be restored by the same build of DynamO on the
+  same platform. Each section of the checkpoint begins with a named
+  tag, which is checked on loading to catch mismatched sections
+  early.
+
+  Sections which may be absent when the checkpoint is restored (e.g.,
+  a System which is only added by dynarun for one run) are written
+  as length-prefixed blocks using beginBlock() and endBlock(), so they
+  can be skipped.
+ */
+class CheckpointWriter {
+public:
+  CheckpointWriter(std::ostream &os) : _os(os) {}
+
+  template <class T> void write(const T &val) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only trivially copyable types can be written directly");
+    stream().write(reinterpret_cast<const char *>(&val), sizeof(T));
+  }
+
+  template <class T> void write(const std::vector<T> &vec) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only vectors of trivially copyable types can be written");
+    write<uint64_t>(vec.size());
+    stream().write(reinterpret_cast<const char *>(vec.data()),
+                   vec.size() * sizeof(T));
+  }
+
+  void write(const std::string &str) {
+    write<uint64_t>(str.size());
+    stream().write(str.data(), str.size());
+  }
+
+  void writeTag(const std::string &tag) { write(tag); }
+
+  bool good() const { return bool(_os); }
+
+  /*! \brief Starts a block, whose contents are buffered until
+      endBlock() is called.
+   */
+  void beginBlock(const std::string &name) {
+    _blocks.push_back(std::make_pair(name, std::ostringstream()));
+  }
+
+  void endBlock() {
+    if (_blocks.empty())
+      M_throw() << "No checkpoint block to end";
+    const std::string name = _blocks.back().first;
+    const std::string data = _blocks.back().second.str();
+    _blocks.pop_back();
+    write(name);
+    write(data);
+  }
+
+private:
+  //! The stream to write to, the innermost open block (if any).
+  std::ostream &stream() {
+    return _blocks.empty() ? _os : _blocks.back().second;
+  }
+
+  std::ostream &_os;
+  std::vector<std::pair<std::string, std::ostringstream>> _blocks;
+};
+
+/*! \brief Reads the binary state of a simulation written by a
+    CheckpointWriter.
+ */
+class CheckpointReader {
+public:
+  CheckpointReader(std::istream &is) : _is(is) {}
+
+  template <class T> void read(T &val) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only trivially copyable types can be read directly");
+    stream().read(reinterpret_cast<char *>(&val), sizeof(T));
+    check();
+  }
+
+  template <class T> T read() {
+    T val;
+    read(val);
+    return val;
+  }
+
+  template <class T> void read(std::vector<T> &vec) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only vectors of trivially copyable types can be read");
+    vec.resize(read<uint64_t>());
+    stream().read(reinterpret_cast<char *>(vec.data()),
+                  vec.size() * sizeof(T));
+    check();
+  }
+
+  void read(std::string &str) {
+    str.resize(read<uint64_t>());
+    stream().read(&str[0], str.size());
+    check();
+  }
+
+  void checkTag(const std::string &tag) {
+    std::string val;
+    read(val);
+    if (val != tag)
+      M_throw() << "Corrupt checkpoint, expected the \"" << tag
+                << "\" section but found \"" << val << "\"";
+  }
+
+  /*! \brief Reads the next block, returning its name.
+
+    The contents of the block are read until endBlock() is called.
+   */
+  std::string beginBlock() {
+    std::string name, data;
+    read(name);
+    read(data);
+    _blocks.push_back(std::istringstream(data));
+    return name;
+  }
+
+  void endBlock() {
+    if (_blocks.empty())
+      M_throw() << "No checkpoint block to end";
+    _blocks.pop_back();
+  }
+
+private:
+  std::istream &stream() { return _blocks.empty() ? _is : _blocks.back(); }
+
+  void check() {
+    if (!stream())
+      M_throw() << "Unexpected end of the checkpoint data";
+  }
+
+  std::istream &_is;
+  std::vector<std::istringstream> _blocks;
+};
+} // namespace dynamo
@@ -124,13 +124,15 @@ boost::program_options::variables_map &Coordinator::parseOptions(int argc,
       " Values:\n"
       "  1: \tStandard Engine\n"
       "  2: \tNVT Replica Exchange Engine\n"
-      "  3: \tCompression Engine");
+      "  3: \tCompression Engine\n"
+      "  4: \tBatch Engine (many independent simulations)");
 
   basicOpts.add(systemopts).add(engineopts);
 
   Engine::getCommonOptions(detailedEngineOpts);
   EReplicaExchangeSimulation::getOptions(detailedEngineOpts);
   ECompressingSimulation::getOptions(detailedEngineOpts);
+  EBatchSimulation::getOptions(detailedEngineOpts);
 
   allopts.add(basicOpts).add(detailedEngineOpts);
 
@@ -153,7 +155,7 @@ boost::program_options::variables_map &Coordinator::parseOptions(int argc,
     exit(1);
   }
 
-  if (vm.count("config-file") == 0)
+  if ((vm.count("config-file") == 0) && (vm.count("batch-list") == 0))
     M_throw() << "No configuration files to load specified";
 
   return vm;
@@ -178,6 +180,10 @@ void Coordinator::initialise() {
     _engine = shared_ptr<ECompressingSimulation>(
         new ECompressingSimulation(vm, _threads));
     break;
+  case (4):
+    _engine =
+        shared_ptr<EBatchSimulation>(new EBatchSimulation(vm, _threads));
+    break;
   default:
     M_throw() << vm["engine"].as<size_t>()
               << ", Unknown Engine Number Selected";
@@ -0,0 +1,135 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <boost/lexical_cast.hpp>
+#include <dynamo/coordinator/engine/batch.hpp>
+#include <fstream>
+#include <magnet/string/searchreplace.hpp>
+#include <magnet/thread/threadpool.hpp>
+#include <thread>
+
+namespace dynamo {
+void EBatchSimulation::getOptions(
+    boost::program_options::options_description &opts) {
+  boost::program_options::options_description bopts(
+      "Batch Engine Options (--engine=4)");
+
+  bopts.add_options()(
+      "batch-list", boost::program_options::value<std::string>(),
+      "A file listing the configuration files to run, one per line. These "
+      "are run after any configuration files given on the command line.");
+
+  opts.add(bopts);
+}
+
+EBatchSimulation::EBatchSimulation(
+    const boost::program_options::variables_map &nVM,
+    magnet::thread::ThreadPool &tp)
+    : Engine(nVM, "config.%ID.end.xml", "output.%ID.xml", tp), _finished(0),
+      _failed(0) {}
+
+void EBatchSimulation::initialisation() {
+  preSimInit();
+
+  if (configFormat.find("%ID") == configFormat.npos)
+    M_throw() << "Batch mode, but format string for config file output"
+                 " doesnt contain %ID";
+
+  if (outputFormat.find("%ID") == outputFormat.npos)
+    M_throw() << "Batch mode, but format string for output"
+                 " file doesnt contain %ID";
+
+  if (vm.count("config-file"))
+    _configFiles = vm["config-file"].as<std::vector<std::string>>();
+
+  if (vm.count("batch-list")) {
+    const std::string listFile = vm["batch-list"].as<std::string>();
+    std::ifstream list(listFile);
+    if (!list)
+      M_throw() << "Could not open the batch list \"" << listFile << "\"";
+
+    std::string line;
+    while (std::getline(list, line)) {
+      const size_t begin = line.find_first_not_of(" \t\r");
+      if ((begin == line.npos) || (line[begin] == '#'))
+        continue;
+      const size_t end = line.find_last_not_of(" \t\r");
+      _configFiles.push_back(line.substr(begin, end - begin + 1));
+    }
+  }
+
+  if (_configFiles.empty())
+    M_throw() << "No configuration files to run in batch mode";
+
+  // The simulations are the unit of parallelism, so fill the machine
+  // with them unless told otherwise.
+  if (!vm.count("n-threads"))
+    threads.setThreadCount(
+        std::max(1u, std::min<unsigned int>(std::thread::hardware_concurrency(),
+                                            _configFiles.size())));
+}
+
+void EBatchSimulation::runConfig(size_t id) {
+  if (_SIGTERM || _SIGINT)
+    return;
+
+  const std::string ID = boost::lexical_cast<std::string>(id);
+  try {
+    Simulation sim;
+    setupSim(sim, _configFiles[id]);
+    sim.simID = id;
+    // Give each simulation its own random stream when seeded
+    if (vm.count("random-seed"))
+      sim.ranGenerator.seed(vm["random-seed"].as<unsigned int>() + id);
+
+    sim.initialise();
+
+    while (sim.runSimulationStep(true))
+      if (_SIGTERM || _SIGINT)
+        sim.simShutdown();
+
+    sim.outputData(magnet::string::search_replace(outputFormat, "%ID", ID));
+    sim.writeXMLfile(magnet::string::search_replace(configFormat, "%ID", ID),
+                     !vm.count("unwrapped"));
+
+    const size_t finished = ++_finished;
+    std::lock_guard<std::mutex> lock(_outputMutex);
+    std::cout << "\nBatch: Finished " << _configFiles[id] << " (ID " << id
+              << ", " << finished << "/" << _configFiles.size() << ")"
+              << std::flush;
+  } catch (std::exception &e) {
+    ++_failed;
+    std::lock_guard<std::mutex> lock(_outputMutex);
+    std::cerr << "\nBatch: " << _configFiles[id] << " (ID " << id
+              << ") failed:" << e.what() << std::endl;
+  }
+}
+
+void EBatchSimulation::runSimulation() {
+  std::vector<std::function<void()>> tasks;
+  tasks.reserve(_configFiles.size());
+  for (size_t id(0); id < _configFiles.size(); ++id)
+    tasks.push_back(std::bind(&EBatchSimulation::runConfig, this, id));
+
+  threads.queueTasks(tasks);
+  threads.wait();
+
+  if (_failed)
+    M_throw() << _failed << " of the " << _configFiles.size()
+              << " batch simulations failed";
+}
+} // namespace dynamo
@@ -0,0 +1,109 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*! \file batch.hpp
+ * Contains the definition of EBatchSimulation.
+ */
+#pragma once
+
+#include <atomic>
+#include <dynamo/coordinator/engine/engine.hpp>
+#include <mutex>
+
+namespace dynamo {
+/*! \brief An Engine for running many independent Simulation's in a
+    single process.
+
+  Each configuration file is loaded, run, written out and destroyed
+  as one task on the ThreadPool, so only as many Simulation's as
+  there are threads are held in memory at once. The tasks are pulled
+  from the shared queue of the pool as each thread becomes free,
+  which balances the load when the simulations take very different
+  amounts of time to complete. Each Simulation is run on a single
+  thread.
+
+  The output files of each simulation are written as soon as it
+  finishes, using the output format strings with %ID replaced by the
+  index of the configuration file.
+ */
+class EBatchSimulation : public Engine {
+public:
+  /*! \brief Only constructor.
+
+    \param vm A reference to the Coordinator's parsed command line variables.
+    \param tp A reference to the thread pool of the dynarun instance.
+   */
+  EBatchSimulation(const boost::program_options::variables_map &vm,
+                   magnet::thread::ThreadPool &tp);
+
+  /*! \brief Trivial virtual destructor */
+  virtual ~EBatchSimulation() {}
+
+  /*! \brief Return the options for the EBatchSimulation Engine.
+   */
+  static void getOptions(boost::program_options::options_description &);
+
+  /*! \brief Runs every configuration file to completion.
+   */
+  virtual void runSimulation();
+
+  /*! \brief The output of each Simulation is written when it
+      finishes, so there is nothing left to output here.
+   */
+  virtual void outputData() {}
+
+  /*! \brief The configuration of each Simulation is written when it
+      finishes, so there is nothing left to output here.
+   */
+  virtual void outputConfigs() {}
+
+  /*! \brief No Engine finalisation required.
+   */
+  virtual void finaliseRun() {}
+
+  /*! \brief Collects the list of configuration files to run.
+
+    The Simulation's themselves are only loaded once their task
+    starts.
+   */
+  virtual void initialisation();
+
+protected:
+  //! The threads are already busy running other simulations.
+  virtual size_t simThreadCount() const { return 1; }
+
+  /*! \brief Load, run and output the configuration file with the
+      passed index.
+   */
+  void runConfig(size_t id);
+
+  /*! \brief The configuration files to run.
+   */
+  std::vector<std::string> _configFiles;
+
+  /*! \brief Guards the screen output of the tasks.
+   */
+  std::mutex _outputMutex;
+
+  /*! \brief The number of simulations which have finished.
+   */
+  std::atomic<size_t> _finished;
+
+  /*! \brief The number of simulations which have failed.
+   */
+  std::atomic<size_t> _failed;
+};
+} // namespace dynamo
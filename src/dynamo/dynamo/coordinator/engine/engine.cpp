@@ -17,6 +17,7 @@
 
 #include <dynamo/coordinator/engine/engine.hpp>
 #include <dynamo/coordinator/engine/replexer.hpp>
+#include <algorithm>
 #include <dynamo/systems/tHalt.hpp>
 #include <limits>
 
@@ -53,7 +54,11 @@ void Engine::getCommonOptions(
       "snapshot", boost::program_options::value<double>(),
       "Sets the system time inbetween saving snapshots of the system.")(
       "snapshot-events", boost::program_options::value<size_t>(),
-      "Sets the event count inbetween saving snapshots of the system.");
+      "Sets the event count inbetween saving snapshots of the system.")(
+      "checkpoint-file", boost::program_options::value<std::string>(),
+      "Also write a binary checkpoint of the final state to this file. It "
+      "can be loaded as a config file to resume the run exactly, without "
+      "recalculating the events (standard engine only).");
 
   opts.add(simopts);
 }
@@ -83,16 +88,30 @@ void Engine::preSimInit() {
 
 class EReplicaExchangeSimulation;
 
+size_t Engine::simThreadCount() const {
+  if (vm.count("n-threads"))
+    return std::max(1u, vm["n-threads"].as<unsigned int>());
+  return 1;
+}
+
 void Engine::setupSim(Simulation &Sim, const std::string filename) {
   Sim.ranGenerator.seed(std::random_device()());
   if (vm.count("random-seed"))
     Sim.ranGenerator.seed(vm["random-seed"].as<unsigned int>());
 
+  // Set before loading, as the particle data is loaded in parallel
+  Sim.threadCount = simThreadCount();
+
   ////////////////////////Simulation Initialisation!!!!!!!!!!!!!
   // Now load the config
   Sim.loadXMLfile(filename.c_str());
 
-  Sim.endEventCount = vm["events"].as<size_t>();
+  // A checkpoint restores its event count, which the event limit is
+  // relative to
+  Sim.endEventCount =
+      Sim.eventCount + std::min(vm["events"].as<size_t>(),
+                                std::numeric_limits<size_t>::max() -
+                                    Sim.eventCount);
 
   if (vm["events"].as<size_t>() > vm["print-events"].as<size_t>())
     Sim.eventPrintInterval = vm["print-events"].as<size_t>();
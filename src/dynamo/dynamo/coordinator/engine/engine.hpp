@@ -131,6 +131,14 @@ protected:
    */
   virtual void setupSim(Simulation &Sim, const std::string inFile);
 
+  /*! \brief The number of threads each Simulation may use for its
+   * own parallel loops (see Simulation::threadCount).
+   *
+   * This is the n-threads option by default, as a single Simulation
+   * has the whole thread budget to itself.
+   */
+  virtual size_t simThreadCount() const;
+
   /*! \brief Once the Simulation is loaded and initialised you may
    * need to alter it/load plugins/initialise some Engine datastruct.
    */
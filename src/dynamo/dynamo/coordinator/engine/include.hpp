@@ -15,6 +15,7 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <dynamo/coordinator/engine/batch.hpp>
 #include <dynamo/coordinator/engine/compressor.hpp>
 #include <dynamo/coordinator/engine/replexer.hpp>
 #include <dynamo/coordinator/engine/single.hpp>
@@ -198,6 +198,12 @@ void EReplicaExchangeSimulation::preSimInit() {
     Simulations[id].simID = id;
 }
 
+size_t EReplicaExchangeSimulation::simThreadCount() const {
+  const size_t running =
+      std::max<size_t>(1, std::min<size_t>(nSims, threads.getThreadCount()));
+  return std::max<size_t>(1, Engine::simThreadCount() / running);
+}
+
 void EReplicaExchangeSimulation::setupSim(Simulation &Sim,
                                           const std::string filename) {
   Engine::setupSim(Sim, filename);
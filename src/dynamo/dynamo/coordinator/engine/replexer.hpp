@@ -196,6 +196,14 @@ protected:
    */
   virtual void setupSim(Simulation &, const std::string);
 
+  /*! \brief Splits the thread budget between the replicas.
+
+    The ThreadPool runs one replica per thread, so each of the
+    replicas running at once gets an equal share of the n-threads
+    option.
+   */
+  virtual size_t simThreadCount() const;
+
   // Replica Exchange attempt code
 
   /*! \brief Carry out a certain type of replica exchange phase.
@@ -118,5 +118,8 @@ void ESingleSimulation::outputData() {
 
 void ESingleSimulation::outputConfigs() {
   simulation.writeXMLfile(configFormat.c_str(), !vm.count("unwrapped"));
+
+  if (vm.count("checkpoint-file"))
+    simulation.writeCheckpoint(vm["checkpoint-file"].as<std::string>());
 }
 } // namespace dynamo
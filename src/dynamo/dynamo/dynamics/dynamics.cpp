@@ -15,12 +15,15 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <atomic>
 #include <cstring>
 #include <dynamo/NparticleEventData.hpp>
+#include <dynamo/checkpoint.hpp>
 #include <dynamo/dynamics/include.hpp>
 #include <dynamo/simulation.hpp>
 #include <dynamo/species/inertia.hpp>
 #include <dynamo/units/units.hpp>
+#include <magnet/thread/parallel_for.hpp>
 #include <magnet/xmlreader.hpp>
 #include <magnet/xmlwriter.hpp>
 
@@ -106,19 +109,34 @@ double Dynamics::getPBCSentinelTime(const Particle &, const double &) const {
 void Dynamics::loadParticleXMLData(const magnet::xml::Node &XML) {
   dout << "Loading Particle Data" << std::endl;
 
-  bool outofsequence = false;
-
+  // Walking the parsed document is cheap compared to converting the
+  // attributes, so the nodes are collected first and then converted
+  // in parallel, straight into the particle array.
+  std::vector<magnet::xml::Node> nodes;
   for (magnet::xml::Node node = XML.getNode("ParticleData").findNode("Pt");
-       node.valid(); ++node) {
-    if (!node.hasAttribute("ID") ||
-        node.getAttribute("ID").as<size_t>() != Sim->particles.size())
-      outofsequence = true;
-
-    Particle part(node, Sim->particles.size());
-    part.getVelocity() *= Sim->units.unitVelocity();
-    part.getPosition() *= Sim->units.unitLength();
-    Sim->particles.push_back(part);
-  }
+       node.valid(); ++node)
+    nodes.push_back(node);
+
+  const size_t offset = Sim->particles.size();
+  Sim->particles.resize(offset + nodes.size(),
+                        Particle(Vector{0, 0, 0}, Vector{0, 0, 0}, 0));
+
+  std::atomic<bool> outofsequence(false);
+  magnet::thread::parallel_for(
+      0, nodes.size(), Sim->threadCount,
+      [&](size_t, size_t begin, size_t end) {
+        for (size_t i(begin); i < end; ++i) {
+          const size_t ID = offset + i;
+          if (!nodes[i].hasAttribute("ID") ||
+              nodes[i].getAttribute("ID").as<size_t>() != ID)
+            outofsequence = true;
+
+          Particle &part = Sim->particles[ID];
+          part = Particle(nodes[i], ID);
+          part.getVelocity() *= Sim->units.unitVelocity();
+          part.getPosition() *= Sim->units.unitLength();
+        }
+      });
 
   if (outofsequence)
     dout << "Particle ID's out of sequence!\n"
@@ -370,6 +388,18 @@ bool Dynamics::isUpToDate(const Particle &part) const {
   return part.getPecTime() == -partPecTime;
 }
 
+void Dynamics::saveCheckpoint(CheckpointWriter &out) const {
+  out.write(partPecTime);
+  out.write(streamCount);
+  out.write(orientationData);
+}
+
+void Dynamics::loadCheckpoint(CheckpointReader &in) {
+  in.read(partPecTime);
+  in.read(streamCount);
+  in.read(orientationData);
+}
+
 void Dynamics::updateAllParticles() const {
   // May as well take this opportunity to reset the streaming
   // Note: the Replexing coordinator RELIES on this behaviour!
@@ -30,6 +30,8 @@ class PairEventData;
 class ParticleEventData;
 class NEventData;
 class Event;
+class CheckpointWriter;
+class CheckpointReader;
 
 /*! \brief Provides the primitivve event-detection and processing
  routines for all events.
@@ -510,17 +512,23 @@ public:
                                          const double &d,
                                          const EEventType &eType = CORE) const;
 
-  /*! \brief Tests for a collision between spherical particles
-    according to the ESMC (Enskog DSMC)
+  /*! \brief Calculates the collision probability of a candidate
+    pair of spherical particles according to the ESMC (Enskog DSMC)
+
+    The particles must already be up to date. This does not use the
+    random number generator or modify any state, so it may be called
+    concurrently for disjoint pairs of particles.
 
     \param p1 First particle to test
     \param p1 Second particle to test
-    \param maxprob The current maximum of the collision radius
+    \param factor The collision frequency factor of the system.
     \param rij The vector seperating the two particles.
-    \return Whether the collision occurs
+    \return The (unnormalised) collision probability, zero if the
+    particles are receding.
    */
-  virtual bool DSMCSpheresTest(Particle &p1, Particle &p2, double &maxprob,
-                               const double &factor, Vector rij) const = 0;
+  virtual double DSMCSpheresProbability(const Particle &p1, const Particle &p2,
+                                        const double &factor,
+                                        Vector rij) const = 0;
 
   /*! \brief Performs a hard sphere collision between the two
     particles according to the ESMC (Enskog DSMC)
@@ -534,6 +542,18 @@ public:
   virtual PairEventData DSMCSpheresRun(Particle &p1, Particle &p2,
                                        const double &e, Vector rij) const = 0;
 
+  /*! \brief Test if DSMCSpheresProbability() and DSMCSpheresRun()
+      may be called concurrently for disjoint pairs of particles.
+
+    SysDSMCSpheres only processes its cells in parallel if this is
+    true, so the collisions must only modify the two particles
+    passed. Dynamics which override the DSMC functions must check
+    this still holds, e.g., the last collision state of DynNewtonian
+    (lastCollParticle1/2 and lastAbsoluteClock) is shared and must
+    not be written by them.
+   */
+  virtual bool isDSMCThreadSafe() const { return false; }
+
   /*! \brief Executes a well/shoulder event
 
     This is a workhorse of the square well/square shoulder/core
@@ -671,14 +691,24 @@ public:
     orientationData = dynamicsdata.orientationData;
   }
 
+  /*! \brief Write the delayed state and orientations of the
+      particles to a checkpoint (see Simulation::writeCheckpoint).
+   */
+  virtual void saveCheckpoint(CheckpointWriter &) const;
+
+  //! \brief Restore the state written by saveCheckpoint().
+  virtual void loadCheckpoint(CheckpointReader &);
+
 protected:
   friend class GCellsShearing;
+  friend class GVerletList;
 
   /*! \brief A dangerous function to predictivly move a particle
     forward.
 
     See GCellsShearing, this just over advances the particle to find
-    its future position in boundary changes.
+    its future position in boundary changes. GVerletList uses it to
+    find where a particle leaves its Verlet box.
   */
   void advanceUpdateParticle(Particle &part, double &dt) const;
 
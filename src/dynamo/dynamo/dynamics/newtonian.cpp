@@ -17,8 +17,9 @@
 */
 
 #include <dynamo/2particleEventData.hpp>
-#include <dynamo/BC/BC.hpp>
+#include <dynamo/BC/LEBC.hpp>
 #include <dynamo/NparticleEventData.hpp>
+#include <dynamo/checkpoint.hpp>
 #include <dynamo/dynamics/newtonian.hpp>
 #include <dynamo/simulation.hpp>
 #include <dynamo/species/species.hpp>
@@ -34,18 +35,34 @@
 #include <magnet/xmlwriter.hpp>
 
 namespace dynamo {
+inline void DynNewtonian::pairImage(Vector &rij, Vector &vij) const {
+  // The pointer comparison catches the boundary being replaced after
+  // initialisation
+  if (_LEBC.get() == Sim->BCs.get())
+    _LEBC->minimumImage(rij, vij);
+  else
+    Sim->BCs->applyBC(rij, vij);
+}
+
+inline void DynNewtonian::pairImage(Vector &rij) const {
+  if (_LEBC.get() == Sim->BCs.get())
+    _LEBC->minimumImage(rij);
+  else
+    Sim->BCs->applyBC(rij);
+}
+
 double DynNewtonian::CubeCubeInRoot(const Particle &p1, const Particle &p2,
                                     double d) const {
   Vector r12 = p1.getPosition() - p2.getPosition();
   Vector v12 = p1.getVelocity() - p2.getVelocity();
-  Sim->BCs->applyBC(r12, v12);
+  pairImage(r12, v12);
   return magnet::intersection::ray_AAcube(r12, v12, 2 * Vector{d, d, d});
 }
 
 bool DynNewtonian::cubeOverlap(const Particle &p1, const Particle &p2,
                                const double d) const {
   Vector r12 = p1.getPosition() - p2.getPosition();
-  Sim->BCs->applyBC(r12);
+  pairImage(r12);
   return magnet::overlap::point_cube(r12, 2 * Vector{d, d, d});
 }
 
@@ -53,7 +70,7 @@ double DynNewtonian::SphereSphereInRoot(const Particle &p1, const Particle &p2,
                                         double d) const {
   Vector r12 = p1.getPosition() - p2.getPosition();
   Vector v12 = p1.getVelocity() - p2.getVelocity();
-  Sim->BCs->applyBC(r12, v12);
+  pairImage(r12, v12);
   return magnet::intersection::ray_sphere(r12, v12, d);
 }
 
@@ -71,7 +88,7 @@ double DynNewtonian::SphereSphereOutRoot(const Particle &p1, const Particle &p2,
                                          double d) const {
   Vector r12 = p1.getPosition() - p2.getPosition();
   Vector v12 = p1.getVelocity() - p2.getVelocity();
-  Sim->BCs->applyBC(r12, v12);
+  pairImage(r12, v12);
   return magnet::intersection::ray_sphere<true>(r12, v12, d);
 }
 
@@ -120,6 +137,11 @@ DynNewtonian::DynNewtonian(dynamo::Simulation *tmp)
     : Dynamics(tmp), lastAbsoluteClock(-1), lastCollParticle1(0),
       lastCollParticle2(0) {}
 
+void DynNewtonian::initialise() {
+  Dynamics::initialise();
+  _LEBC = std::dynamic_pointer_cast<const BCLeesEdwards>(Sim->BCs);
+}
+
 void DynNewtonian::streamParticle(Particle &particle, const double &dt) const {
   particle.getPosition() += particle.getVelocity() * dt;
 
@@ -326,26 +348,19 @@ int DynNewtonian::getSquareCellCollision3(const Particle &part,
   return retVal;
 }
 
-bool DynNewtonian::DSMCSpheresTest(Particle &p1, Particle &p2, double &maxprob,
-                                   const double &factor, Vector rij) const {
-  updateParticlePair(Sim->particles[p1.getID()], Sim->particles[p2.getID()]);
-
+double DynNewtonian::DSMCSpheresProbability(const Particle &p1,
+                                            const Particle &p2,
+                                            const double &factor,
+                                            Vector rij) const {
   Vector vij = p1.getVelocity() - p2.getVelocity();
   Sim->BCs->applyBC(rij, vij);
 
-  // Sim->BCs->applyBC(pdat.rij, pdat.vij);
   double rvdot = (rij | vij);
 
   if (rvdot > 0)
-    return false; // Positive rvdot
-
-  double prob = factor * (-rvdot);
-
-  if (prob > maxprob)
-    maxprob = prob;
+    return 0; // Positive rvdot
 
-  std::uniform_real_distribution<> uniform_dist;
-  return prob > uniform_dist(Sim->ranGenerator) * maxprob;
+  return factor * (-rvdot);
 }
 
 PairEventData DynNewtonian::DSMCSpheresRun(Particle &p1, Particle &p2,
@@ -698,6 +713,20 @@ void DynNewtonian::outputXML(magnet::xml::XmlStream &XML) const {
   XML << magnet::xml::attr("Type") << "Newtonian";
 }
 
+void DynNewtonian::saveCheckpoint(CheckpointWriter &out) const {
+  Dynamics::saveCheckpoint(out);
+  out.write(lastAbsoluteClock);
+  out.write(lastCollParticle1);
+  out.write(lastCollParticle2);
+}
+
+void DynNewtonian::loadCheckpoint(CheckpointReader &in) {
+  Dynamics::loadCheckpoint(in);
+  in.read(lastAbsoluteClock);
+  in.read(lastCollParticle1);
+  in.read(lastCollParticle2);
+}
+
 double DynNewtonian::getPBCSentinelTime(const Particle &part,
                                         const double &lMax) const {
 #ifdef DYNAMO_DEBUG
@@ -1107,7 +1136,7 @@ PairEventData DynNewtonian::runLineLineCollision(Event &eevent,
 double DynNewtonian::sphereOverlap(const Particle &p1, const Particle &p2,
                                    const double &d) const {
   Vector r12 = p1.getPosition() - p2.getPosition();
-  Sim->BCs->applyBC(r12);
+  pairImage(r12);
 
   return std::max(d - std::sqrt(r12 | r12), 0.0);
 }
@@ -20,6 +20,8 @@
 #include <dynamo/dynamics/dynamics.hpp>
 
 namespace dynamo {
+class BCLeesEdwards;
+
 /*! \brief A Dynamics which implements standard Newtonian dynamics.
 
    This Dynamics provides the dynamics of a system particles
@@ -33,6 +35,8 @@ class DynNewtonian : public Dynamics {
 public:
   DynNewtonian(dynamo::Simulation *);
 
+  virtual void initialise();
+
   virtual double SphereSphereInRoot(const Particle &p1, const Particle &p2,
                                     double d) const;
   virtual double SphereSphereInRoot(const IDRange &p1, const IDRange &p2,
@@ -66,10 +70,12 @@ public:
   virtual PairEventData SmoothSpheresColl(Event &, const double &,
                                           const double &,
                                           const EEventType &eType) const;
-  virtual bool DSMCSpheresTest(Particle &, Particle &, double &, const double &,
-                               Vector) const;
+  virtual double DSMCSpheresProbability(const Particle &, const Particle &,
+                                        const double &, Vector) const;
   virtual PairEventData DSMCSpheresRun(Particle &, Particle &, const double &,
                                        Vector) const;
+  //! The DSMC functions only modify the particles passed.
+  virtual bool isDSMCThreadSafe() const { return true; }
   virtual PairEventData SphereWellEvent(Event &, const double &, const double &,
                                         size_t) const;
   virtual double getPlaneEvent(const Particle &, const Vector &, const Vector &,
@@ -114,9 +120,24 @@ public:
   runRoughWallCollision(Particle &part, const Vector &vNorm, const double &e,
                         const double &et, const double &r) const;
 
+  virtual void saveCheckpoint(CheckpointWriter &) const;
+  virtual void loadCheckpoint(CheckpointReader &);
+
 protected:
   virtual void outputXML(magnet::xml::XmlStream &) const;
 
+  /*! \brief The minimum image of a pair separation and relative
+      velocity.
+
+    The pair tests call this for every pair, so the Lees-Edwards
+    boundary is special-cased to avoid the virtual applyBC call.
+   */
+  void pairImage(Vector &rij, Vector &vij) const;
+  void pairImage(Vector &rij) const;
+
+  //! \brief The boundary at initialisation, if it is Lees-Edwards.
+  shared_ptr<const BCLeesEdwards> _LEBC;
+
   mutable long double lastAbsoluteClock;
   mutable unsigned int lastCollParticle1;
   mutable unsigned int lastCollParticle2;
@@ -89,8 +89,8 @@ public:
                      bool strongPlate) const {
     M_throw() << "Not implemented";
   }
-  virtual bool DSMCSpheresTest(Particle &, Particle &, double &, const double &,
-                               Vector) const {
+  virtual double DSMCSpheresProbability(const Particle &, const Particle &,
+                                        const double &, Vector) const {
     M_throw() << "Not implemented";
   }
   virtual PairEventData DSMCSpheresRun(Particle &, Particle &, const double &,
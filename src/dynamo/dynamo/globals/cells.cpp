@@ -18,10 +18,13 @@
 #include <algorithm>
 #include <cstdio>
 #include <dynamo/BC/LEBC.hpp>
+#include <dynamo/checkpoint.hpp>
 #include <dynamo/dynamics/compression.hpp>
 #include <dynamo/dynamics/dynamics.hpp>
 #include <dynamo/globals/cells.hpp>
+#include <dynamo/profiler.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
+#include <dynamo/simulation.hpp>
 #include <dynamo/units/units.hpp>
 #include <magnet/xmlreader.hpp>
 #include <magnet/xmlwriter.hpp>
@@ -29,14 +32,18 @@
 namespace dynamo {
 GCells::GCells(dynamo::Simulation *nSim, const std::string &name)
     : GNeighbourList(nSim, "CellNeighbourList"), _cellDimension({1, 1, 1}),
-      _inConfig(true), overlink(1) {
+      _inConfig(true), overlink(1), _cellScale(1), _autoTune(0),
+      _transitionCost(5), _tuneTrial(0), _tuneStart(0), _tuneTransitions(0),
+      _tuneTests(0) {
   globName = name;
   dout << "Cells Loaded" << std::endl;
 }
 
 GCells::GCells(const magnet::xml::Node &XML, dynamo::Simulation *ptrSim)
     : GNeighbourList(ptrSim, "CellNeighbourList"), _cellDimension({1, 1, 1}),
-      _inConfig(true), overlink(1) {
+      _inConfig(true), overlink(1), _cellScale(1), _autoTune(0),
+      _transitionCost(5), _tuneTrial(0), _tuneStart(0), _tuneTransitions(0),
+      _tuneTests(0) {
   GCells::operator<<(XML);
 
   dout << "Cells Loaded" << std::endl;
@@ -46,6 +53,15 @@ void GCells::operator<<(const magnet::xml::Node &XML) {
   if (XML.hasAttribute("OverLink"))
     overlink = XML.getAttribute("OverLink").as<size_t>();
 
+  if (XML.hasAttribute("CellScale"))
+    _cellScale = XML.getAttribute("CellScale").as<double>();
+
+  if (XML.hasAttribute("AutoTune"))
+    _autoTune = XML.getAttribute("AutoTune").as<size_t>();
+
+  if (XML.hasAttribute("TransitionCost"))
+    _transitionCost = XML.getAttribute("TransitionCost").as<double>();
+
   if (XML.hasAttribute("NeighbourhoodRange"))
     _maxInteractionRange = XML.getAttribute("NeighbourhoodRange").as<double>() *
                            Sim->units.unitLength();
@@ -82,6 +98,7 @@ void GCells::runEvent(Particle &part, const double) {
   // pushed after the callbacks are complete (the callbacks may also
   // add events so this must be done first).
   Sim->scheduler->popNextEvent();
+  DYNAMO_PROFILE_SCOPE(Sim, CELL_TRANSITION);
 
   const size_t oldCellIndex = _cellData.getCellID(part.getID());
   const auto oldCellCoord = _ordering.toCoord(oldCellIndex);
@@ -110,15 +127,25 @@ void GCells::runEvent(Particle &part, const double) {
   std::array<size_t, 3> steps{{overlink, overlink, overlink}};
   steps[cellDirection] = 0;
 
+  _newNeighbours.clear();
   for (auto cellIndex :
-       _ordering.getSurroundingIndices(newCenterNBCellCoord, steps))
-    for (const size_t &next : _cellData.getCellContents(cellIndex))
-      _sigNewNeighbour(part, next);
+       _ordering.getSurroundingIndices(newCenterNBCellCoord, steps)) {
+    const auto &contents = _cellData.getCellContents(cellIndex);
+    _newNeighbours.insert(_newNeighbours.end(), contents.begin(),
+                          contents.end());
+  }
+  _tuneTests += _newNeighbours.size();
+  _sigNewNeighbours(part, _newNeighbours);
 
   // Push the next virtual event, this is the reason the scheduler
   // doesn't need a second callback
   Sim->scheduler->pushEvent(getEvent(part));
   _sigCellChange(part, oldCellIndex);
+
+  ++_tuneTransitions;
+  if ((_tuneTrial < _tuneTrials.size()) &&
+      (Sim->eventCount - _tuneStart >= _autoTune))
+    autoTuneStep();
 }
 
 void GCells::initialise(size_t nID) {
@@ -131,18 +158,29 @@ void GCells::reinitialise() {
 
   dout << "Reinitialising on collision " << Sim->eventCount << std::endl;
 
+  if (_autoTune && _tuneTrials.empty())
+    buildTuneTrials();
+
+  // The autotuning trial (if any) restarts with the new cells
+  _tuneStart = Sim->eventCount;
+  _tuneTransitions = 0;
+  _tuneTests = 0;
+
+  addCells(getCellCount(overlink, _cellScale));
+  _sigReInitialise();
+}
+
+std::array<size_t, 3> GCells::getCellCount(size_t links,
+                                           double scale) const {
   // This is the minimium cell size, based on the two-particle Interaction range
-  const double minDistance = _maxInteractionRange / overlink;
-  dout << "Cell diameter from interaction distance and overlink " << minDistance
-       << std::endl;
+  const double minDistance = _maxInteractionRange / links;
 
   // This is the "optimal" neighbourlist size where we have unitary occupation
   const double unityOccupancy = std::cbrt(Sim->getSimVolume() / Sim->N());
-  dout << "Cell diameter from unitary occupancy " << unityOccupancy
-       << std::endl;
 
   // Choose the largest cell size we can from the two choices so far
-  double l = std::max(minDistance, unityOccupancy);
+  // (scaled, if tuned)
+  double l = std::max(minDistance, unityOccupancy) * scale;
 
   std::array<size_t, 3> cellCount;
   const double embiggen = 1.0 + 10 * std::numeric_limits<double>::epsilon();
@@ -158,14 +196,140 @@ void GCells::reinitialise() {
     // calculations to work (to contain at least one full
     // neighbourhood template in the system)
     cellCount[iDim] =
-        std::max(cellCount[iDim], size_t(2) * overlink + size_t(1));
+        std::max(cellCount[iDim], size_t(2) * links + size_t(1));
   }
 
-  dout << "Target cell width use after taking into account system size = " << l
+  return cellCount;
+}
+
+void GCells::buildTuneTrials() {
+  const double unmeasured = std::numeric_limits<double>::infinity();
+
+  // The configured cells are the first trial
+  _tuneTrials.push_back(TuneTrial{overlink, _cellScale,
+                                  getCellCount(overlink, _cellScale),
+                                  unmeasured});
+
+  for (size_t trialOverlink : {1, 2, 3})
+    for (double scale : {1.0, 1.5, 2.0}) {
+      const TuneTrial trial{trialOverlink, scale,
+                            getCellCount(trialOverlink, scale), unmeasured};
+
+      // Skip candidates which give the same cells as another
+      bool duplicate = false;
+      for (const TuneTrial &other : _tuneTrials)
+        duplicate |= (other.overlink == trial.overlink) &&
+                     (other.cellCount == trial.cellCount);
+
+      // Skip candidates where the minimum cell count forces the
+      // cells to be smaller than the neighbourhood requires
+      bool tooSmall = false;
+      for (size_t iDim = 0; iDim < NDIM; iDim++)
+        tooSmall |= Sim->primaryCellSize[iDim] / trial.cellCount[iDim] <
+                    _maxInteractionRange / trial.overlink;
+
+      if (!duplicate && !tooSmall)
+        _tuneTrials.push_back(trial);
+    }
+
+  _tuneTrial = 0;
+  dout << "Autotuning the cells over " << _tuneTrials.size()
+       << " trials of " << _autoTune << " events" << std::endl;
+}
+
+void GCells::autoTuneStep() {
+  TuneTrial &trial = _tuneTrials[_tuneTrial];
+  trial.cost = (_tuneTransitions * _transitionCost + _tuneTests) /
+               double(Sim->eventCount - _tuneStart);
+
+  dout << "Autotune trial " << _tuneTrial << ": OverLink " << trial.overlink
+       << ", Cells " << trial.cellCount[0] << "," << trial.cellCount[1] << ","
+       << trial.cellCount[2] << ", cost per event " << trial.cost
        << std::endl;
 
-  addCells(cellCount);
-  _sigReInitialise();
+  const TuneTrial *next;
+  if (++_tuneTrial < _tuneTrials.size())
+    next = &_tuneTrials[_tuneTrial];
+  else {
+    next = &*std::min_element(_tuneTrials.begin(), _tuneTrials.end(),
+                              [](const TuneTrial &a, const TuneTrial &b) {
+                                return a.cost < b.cost;
+                              });
+    dout << "Autotune selected OverLink " << next->overlink << ", CellScale "
+         << next->scale << std::endl;
+    if ((next->overlink == overlink) && (next->scale == _cellScale))
+      return;
+  }
+
+  // Regrid without restarting, the scheduler is rebuilt through the
+  // reinitialise signal
+  overlink = next->overlink;
+  _cellScale = next->scale;
+  reinitialise();
+}
+
+void GCells::outputData(magnet::xml::XmlStream &XML) const {
+  if (_tuneTrials.empty())
+    return;
+
+  XML << magnet::xml::tag("CellAutoTune") << magnet::xml::attr("Name")
+      << globName << magnet::xml::attr("Complete")
+      << (_tuneTrial == _tuneTrials.size())
+      << magnet::xml::attr("OverLink") << overlink
+      << magnet::xml::attr("CellScale") << _cellScale
+      << magnet::xml::attr("TransitionCost") << _transitionCost;
+
+  for (const TuneTrial &trial : _tuneTrials) {
+    XML << magnet::xml::tag("Trial") << magnet::xml::attr("OverLink")
+        << trial.overlink << magnet::xml::attr("CellScale") << trial.scale
+        << magnet::xml::attr("x") << trial.cellCount[0]
+        << magnet::xml::attr("y") << trial.cellCount[1]
+        << magnet::xml::attr("z") << trial.cellCount[2];
+    if (std::isfinite(trial.cost))
+      XML << magnet::xml::attr("CostPerEvent") << trial.cost;
+    XML << magnet::xml::endtag("Trial");
+  }
+
+  XML << magnet::xml::endtag("CellAutoTune");
+}
+
+void GCells::saveCheckpoint(CheckpointWriter &out) const {
+  out.write(overlink);
+  out.write(_cellScale);
+  out.write(_tuneTrials);
+  out.write(_tuneTrial);
+  out.write(_tuneStart);
+  out.write(_tuneTransitions);
+  out.write(_tuneTests);
+  out.write(_ordering.getDimensions());
+  for (size_t cell(0); cell < _ordering.length(); ++cell) {
+    const auto contents = _cellData.getCellContents(cell);
+    out.write(std::vector<size_t>(contents.begin(), contents.end()));
+  }
+}
+
+void GCells::loadCheckpoint(CheckpointReader &in) {
+  in.read(overlink);
+  in.read(_cellScale);
+  in.read(_tuneTrials);
+  in.read(_tuneTrial);
+  in.read(_tuneStart);
+  in.read(_tuneTransitions);
+  in.read(_tuneTests);
+
+  const std::array<size_t, 3> cellCount =
+      in.read<std::array<size_t, 3>>();
+  if (cellCount != _ordering.getDimensions())
+    addCells(cellCount);
+
+  _cellData.clear();
+  _cellData.resize(_ordering.length(), Sim->particles.size());
+  std::vector<size_t> contents;
+  for (size_t cell(0); cell < _ordering.length(); ++cell) {
+    in.read(contents);
+    for (const size_t pid : contents)
+      _cellData.add(cell, pid);
+  }
 }
 
 void GCells::outputXML(magnet::xml::XmlStream &XML) const {
@@ -179,6 +343,14 @@ void GCells::outputXML(magnet::xml::XmlStream &XML) const {
   if (overlink > 1)
     XML << magnet::xml::attr("OverLink") << overlink;
 
+  if (_cellScale != 1)
+    XML << magnet::xml::attr("CellScale") << _cellScale;
+
+  // Once tuned, the chosen cells are written instead
+  if (_autoTune && (_tuneTrial < _tuneTrials.size() || _tuneTrials.empty()))
+    XML << magnet::xml::attr("AutoTune") << _autoTune
+        << magnet::xml::attr("TransitionCost") << _transitionCost;
+
   XML << range << magnet::xml::endtag("Global");
 }
 
@@ -263,8 +435,10 @@ void GCells::getParticleNeighbours(
 
 void GCells::getParticleNeighbours(const Particle &part,
                                    std::vector<size_t> &retlist) const {
+  const size_t start = retlist.size();
   getParticleNeighbours(_ordering.toCoord(_cellData.getCellID(part.getID())),
                         retlist);
+  _tuneTests += retlist.size() - start;
 }
 
 void GCells::getParticleNeighbours(const Vector &vec,
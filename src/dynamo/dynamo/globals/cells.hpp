@@ -108,6 +108,15 @@ public:
   efficient however, the vector is much more cache friendly and can
   boost performance by 50% in cases where the cell has multiple
   particles inside of it.
+
+  The cell size and overlink may also be tuned during the run by
+  setting the AutoTune attribute to a number of events. Each
+  candidate (OverLink of 1 to 3, and cells 1, 1.5 or 2 times the
+  default width) is used in turn for that many events, while the
+  cell transitions and the neighbours returned for testing are
+  counted. The cells are then rebuilt using the candidate with the
+  lowest cost per event, where a transition costs TransitionCost
+  neighbour tests. The trials are reported in the output file.
  */
 class GCells : public GNeighbourList {
 public:
@@ -124,6 +133,17 @@ public:
 
   virtual void reinitialise();
 
+  /*! \brief Writes the cell grid and the ordered contents of each
+      cell.
+
+    As the cells overlap, a particle's cell cannot be recalculated
+    from its position, and the order of each cell's contents sets
+    the order in which events are found.
+   */
+  virtual void saveCheckpoint(CheckpointWriter &) const;
+
+  virtual void loadCheckpoint(CheckpointReader &);
+
   void getParticleNeighbours(const Particle &, std::vector<size_t> &) const;
   void getParticleNeighbours(const Vector &, std::vector<size_t> &) const;
 
@@ -135,6 +155,13 @@ public:
 
   void setConfigOutput(bool val) { _inConfig = val; }
 
+  /*! \brief Autotune the cells with trials of the passed number of
+      events (0 disables autotuning), takes effect on initialisation.
+   */
+  void setAutoTune(size_t events) { _autoTune = events; }
+
+  virtual void outputData(magnet::xml::XmlStream &) const;
+
 protected:
   virtual void getParticleNeighbours(const std::array<size_t, 3> &,
                                      std::vector<size_t> &) const;
@@ -149,6 +176,28 @@ protected:
   bool _inConfig;
   size_t overlink;
 
+  //! \brief The cell width as a multiple of the default width.
+  double _cellScale;
+
+  //! \brief The events each autotuning trial runs for (0 disables it).
+  size_t _autoTune;
+
+  //! \brief The cost of a cell transition relative to a neighbour test.
+  double _transitionCost;
+
+  struct TuneTrial {
+    size_t overlink;
+    double scale;
+    std::array<size_t, 3> cellCount;
+    double cost;
+  };
+
+  std::vector<TuneTrial> _tuneTrials;
+  size_t _tuneTrial;
+  size_t _tuneStart;
+  size_t _tuneTransitions;
+  mutable size_t _tuneTests;
+
 #ifdef DYNAMO_JUDY
   detail::CellParticleList<magnet::containers::Vector_Multimap<
                                magnet::containers::VectorSet<size_t>>,
@@ -166,6 +215,19 @@ protected:
 
   std::array<size_t, 3> getCellCoords(Vector) const;
 
+  /*! \brief The number of cells along each axis for the passed
+      overlink and multiple of the default cell width.
+   */
+  std::array<size_t, 3> getCellCount(size_t links, double scale) const;
+
+  //! \brief Build the candidate configurations for autotuning.
+  void buildTuneTrials();
+
+  /*! \brief Finish the current autotuning trial and move to the
+      next (or the best) configuration.
+   */
+  void autoTuneStep();
+
   void addCells(std::array<size_t, 3> cellCount);
   void buildCells();
 
@@ -15,11 +15,16 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <cmath>
 #include <dynamo/BC/LEBC.hpp>
+#include <dynamo/checkpoint.hpp>
 #include <dynamo/dynamics/dynamics.hpp>
 #include <dynamo/globals/cellsShearing.hpp>
+#include <dynamo/profiler.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
+#include <dynamo/simulation.hpp>
 #include <dynamo/units/units.hpp>
+#include <limits>
 
 namespace dynamo {
 GCellsShearing::GCellsShearing(dynamo::Simulation *nSim,
@@ -39,16 +44,70 @@ GCellsShearing::GCellsShearing(const magnet::xml::Node &XML,
 void GCellsShearing::initialise(size_t nID) {
   Global::initialise(nID);
 
-  if (!std::dynamic_pointer_cast<BCLeesEdwards>(Sim->BCs))
+  _LEBC = std::dynamic_pointer_cast<const BCLeesEdwards>(Sim->BCs);
+  if (!_LEBC)
     derr << "You should not use the shearing neighbour list"
          << " in a system without Lees Edwards BC's" << std::endl;
 
   if (overlink != 1)
     M_throw() << "Cannot shear with overlinking yet";
 
+  if (_autoTune)
+    M_throw() << "Cannot autotune shearing cells yet";
+
   reinitialise();
 }
 
+void GCellsShearing::reinitialise() {
+  // The shift events are found again when the scheduler asks for the
+  // particles' events
+  _shiftTime.assign(Sim->N(), std::numeric_limits<double>::quiet_NaN());
+  GCells::reinitialise();
+}
+
+void GCellsShearing::saveCheckpoint(CheckpointWriter &out) const {
+  GCells::saveCheckpoint(out);
+  out.write(_shiftTime);
+}
+
+void GCellsShearing::loadCheckpoint(CheckpointReader &in) {
+  GCells::loadCheckpoint(in);
+  in.read(_shiftTime);
+}
+
+double GCellsShearing::getShift(double dt) const {
+  if (!_LEBC)
+    return 0;
+
+  return (_LEBC->getBoundaryDisplacement() +
+          dt * _LEBC->getShearRate() * Sim->primaryCellSize[1]) /
+         _cellLatticeWidth[0];
+}
+
+double GCellsShearing::getShiftDelay(double shift) const {
+  const double speed =
+      _LEBC ? (_LEBC->getShearRate() * Sim->primaryCellSize[1] /
+               _cellLatticeWidth[0])
+            : 0;
+
+  if (speed > 0)
+    return (std::floor(shift) + 1 - shift) / speed;
+
+  if (speed < 0)
+    return (shift - std::floor(shift)) / -speed;
+
+  return std::numeric_limits<double>::infinity();
+}
+
+long GCellsShearing::getWindowStart(const std::array<size_t, 3> &cellCoords,
+                                    long base) const {
+  // The bottom layer sees the top layer displaced by -shift cells,
+  // and the top layer sees the bottom displaced by +shift.
+  if (cellCoords[1] == 0)
+    return long(cellCoords[0]) + base - 2;
+  return long(cellCoords[0]) - base - 3;
+}
+
 Event GCellsShearing::getEvent(const Particle &part) const {
 #ifdef ISSS_DEBUG
   if (!Sim->dynamics->isUpToDate(part))
@@ -57,12 +116,20 @@ Event GCellsShearing::getEvent(const Particle &part) const {
 
   // We do not inherit GCells get Event as the calcPosition thing done
   // for infinite systems is breaking it for shearing for some reason.
-  return Event(part,
-               Sim->dynamics->getSquareCellCollision2(
-                   part, calcPosition(_cellData.getCellID(part.getID())),
-                   _cellDimension) -
-                   Sim->dynamics->getParticleDelay(part),
-               GLOBAL, CELL, ID);
+  const size_t cellIndex = _cellData.getCellID(part.getID());
+  double dt = Sim->dynamics->getSquareCellCollision2(
+                  part, calcPosition(cellIndex), _cellDimension) -
+              Sim->dynamics->getParticleDelay(part);
+
+  if ((_ordering.getDimensions()[0] > 6) &&
+      isBoundaryCell(_ordering.toCoord(cellIndex))) {
+    double &shiftTime = _shiftTime[part.getID()];
+    if (std::isnan(shiftTime))
+      shiftTime = Sim->systemTime + getShiftDelay(getShift(0));
+    dt = std::min(dt, double(shiftTime - Sim->systemTime));
+  }
+
+  return Event(part, dt, GLOBAL, CELL, ID);
 }
 
 void GCellsShearing::runEvent(Particle &part, const double) {
@@ -71,10 +138,45 @@ void GCellsShearing::runEvent(Particle &part, const double) {
   // Get rid of the virtual event that is next, update is delayed
   // till after all events are added
   Sim->scheduler->popNextEvent();
+  DYNAMO_PROFILE_SCOPE(Sim, CELL_TRANSITION);
 
   const size_t oldCellIndex(_cellData.getCellID(part.getID()));
   const auto oldCellCoord = _ordering.toCoord(oldCellIndex);
   const Vector oldCellPosition(calcPosition(oldCellCoord));
+
+  // Time till transition, assumes the particle is up to date
+  double dt = Sim->dynamics->getSquareCellCollision2(
+      part, oldCellPosition, _cellDimension);
+
+  if ((_ordering.getDimensions()[0] > 6) && isBoundaryCell(oldCellCoord) &&
+      (_shiftTime[part.getID()] - Sim->systemTime < dt)) {
+    // The boundary displacement crosses a cell width before the
+    // particle leaves its cell. Its window of the opposite layer
+    // moves by one column, so only the columns at the leading edge
+    // are new.
+    const double shiftDt = _shiftTime[part.getID()] - Sim->systemTime;
+    const bool forward = _LEBC->getShearRate() > 0;
+    const long crossed = std::lround(getShift(shiftDt));
+    const long base = forward ? crossed : (crossed - 1);
+    const long first = getWindowStart(oldCellCoord, base);
+    const long previous =
+        getWindowStart(oldCellCoord, forward ? (base - 1) : (base + 1));
+
+    _newNeighbours.clear();
+    if (first > previous)
+      addOppositeColumns(oldCellCoord, first + 4, first + 5, _newNeighbours);
+    else
+      addOppositeColumns(oldCellCoord, first, first + 1, _newNeighbours);
+    _sigNewNeighbours(part, _newNeighbours);
+
+    _shiftTime[part.getID()] +=
+        _cellLatticeWidth[0] /
+        std::abs(_LEBC->getShearRate() * Sim->primaryCellSize[1]);
+
+    Sim->scheduler->pushEvent(getEvent(part));
+    return;
+  }
+
   const int cellDirectionInt(Sim->dynamics->getSquareCellCollision3(
       part, oldCellPosition, _cellDimension));
   const size_t cellDirection = abs(cellDirectionInt) - 1;
@@ -84,15 +186,14 @@ void GCellsShearing::runEvent(Particle &part, const double) {
                                  ((cellDirectionInt > 0) ? 1 : -1);
   newCellCoord[cellDirection] %= _ordering.getDimensions()[cellDirection];
 
+  // The shift of the boundary when the particle enters its new cell
+  const double shift = getShift(dt);
+
   if ((cellDirection == 1) &&
       (oldCellCoord[1] ==
        ((cellDirectionInt < 0) ? 0 : (_ordering.getDimensions()[1] - 1)))) {
     // Remove the old x contribution
     // Calculate the final x value
-    // Time till transition, assumes the particle is up to date
-    double dt = Sim->dynamics->getSquareCellCollision2(part, oldCellPosition,
-                                                       _cellDimension);
-
     // Predict the position of the particle in the x dimension
     Sim->dynamics->advanceUpdateParticle(part, dt);
     Vector tmpPos = part.getPosition();
@@ -111,14 +212,15 @@ void GCellsShearing::runEvent(Particle &part, const double) {
 
     _cellData.moveTo(oldCellIndex, _ordering.toIndex(newCellCoord),
                      part.getID());
+    _shiftTime[part.getID()] = Sim->systemTime + dt + getShiftDelay(shift);
 
     // Check the entire neighbourhood, could check just the new
     // neighbours and the extra LE neighbourhood strip but its a lot
     // of code
-    std::vector<size_t> neighbours;
-    GCells::getParticleNeighbours(part, neighbours);
-    for (const size_t &id2 : neighbours)
-      _sigNewNeighbour(part, id2);
+    _newNeighbours.clear();
+    GCells::getParticleNeighbours(newCellCoord, _newNeighbours);
+    getAdditionalLEParticleNeighbourhood(newCellCoord, shift, _newNeighbours);
+    _sigNewNeighbours(part, _newNeighbours);
   } else if ((cellDirection == 1) &&
              (oldCellCoord[1] == ((cellDirectionInt < 0)
                                       ? 1
@@ -127,14 +229,12 @@ void GCellsShearing::runEvent(Particle &part, const double) {
     // Calculate the end cell, no boundary wrap check required
     _cellData.moveTo(oldCellIndex, _ordering.toIndex(newCellCoord),
                      part.getID());
+    _shiftTime[part.getID()] = Sim->systemTime + dt + getShiftDelay(shift);
 
     // Check the extra LE neighbourhood strip
-    std::vector<size_t> nbs;
-    getAdditionalLEParticleNeighbourhood(part, nbs);
-    for (const size_t &id2 : nbs) {
-      Sim->scheduler->addInteractionEvent(part, id2);
-      _sigNewNeighbour(part, id2);
-    }
+    _newNeighbours.clear();
+    getAdditionalLEParticleNeighbourhood(newCellCoord, shift, _newNeighbours);
+    _sigNewNeighbours(part, _newNeighbours);
   } else {
     _cellData.moveTo(oldCellIndex, _ordering.toIndex(newCellCoord),
                      part.getID());
@@ -144,17 +244,12 @@ void GCellsShearing::runEvent(Particle &part, const double) {
                                      ((cellDirectionInt > 0) ? 1 : -1);
     newNBCellCoord[cellDirection] %= _ordering.getDimensions()[cellDirection];
 
-    if ((cellDirection == 2) &&
-        ((oldCellCoord[1] == 0) ||
-         (oldCellCoord[1] == _ordering.getDimensions()[1] - 1))) {
-      // We're at the boundary moving in the z direction, we must
-      // add the new LE strips as neighbours
-      // We just check the entire Extra LE neighbourhood
-      std::vector<size_t> nbs;
-      getAdditionalLEParticleNeighbourhood(part, nbs);
-      for (const size_t &id2 : nbs)
-        _sigNewNeighbour(part, id2);
-    }
+    _newNeighbours.clear();
+    if ((cellDirection != 1) && isBoundaryCell(oldCellCoord))
+      // We're moving along the boundary, the window of the opposite
+      // layer moves with us so we just check the entire window
+      getAdditionalLEParticleNeighbourhood(newCellCoord, shift,
+                                           _newNeighbours);
 
     // Particle has just arrived into a new cell warn the scheduler about
     // its new neighbours so it can add them to the heap
@@ -165,9 +260,12 @@ void GCellsShearing::runEvent(Particle &part, const double) {
     steps[cellDirection] = 0;
 
     for (auto cellIndex :
-         _ordering.getSurroundingIndices(newNBCellCoord, steps))
-      for (const size_t &next : _cellData.getCellContents(cellIndex))
-        _sigNewNeighbour(part, next);
+         _ordering.getSurroundingIndices(newNBCellCoord, steps)) {
+      const auto &contents = _cellData.getCellContents(cellIndex);
+      _newNeighbours.insert(_newNeighbours.end(), contents.begin(),
+                            contents.end());
+    }
+    _sigNewNeighbours(part, _newNeighbours);
   }
 
   // Push the next virtual event, this is the reason the scheduler
@@ -180,33 +278,41 @@ void GCellsShearing::getParticleNeighbours(
     const std::array<size_t, 3> &cellCoords,
     std::vector<size_t> &retlist) const {
   GCells::getParticleNeighbours(cellCoords, retlist);
-  if ((cellCoords[1] == 0) ||
-      (cellCoords[1] == (_ordering.getDimensions()[1] - 1)))
-    getAdditionalLEParticleNeighbourhood(cellCoords, retlist);
+  if (isBoundaryCell(cellCoords))
+    getAdditionalLEParticleNeighbourhood(cellCoords, getShift(0), retlist);
 }
 
 void GCellsShearing::getAdditionalLEParticleNeighbourhood(
-    const Particle &part, std::vector<size_t> &retlist) const {
-  return getAdditionalLEParticleNeighbourhood(
-      _ordering.toCoord(_cellData.getCellID(part.getID())), retlist);
-}
-
-void GCellsShearing::getAdditionalLEParticleNeighbourhood(
-    std::array<size_t, 3> cellCoords, std::vector<size_t> &retlist) const {
+    std::array<size_t, 3> cellCoords, double shift,
+    std::vector<size_t> &retlist) const {
 #ifdef DYNAMO_DEBUG
-  if ((cellCoords[1] != 0) &&
-      (cellCoords[1] != (_ordering.getDimensions()[1] - 1)))
+  if (!isBoundaryCell(cellCoords))
     M_throw() << "Shouldn't call this function unless the particle is at a "
                  "border in the y dimension";
 #endif
+  const long columns = _ordering.getDimensions()[0];
+  if (columns <= 6)
+    return addOppositeColumns(cellCoords, 0, columns - 1, retlist);
+
+  const long first = getWindowStart(cellCoords, std::floor(shift));
+  addOppositeColumns(cellCoords, first, first + 5, retlist);
+}
+
+void GCellsShearing::addOppositeColumns(
+    const std::array<size_t, 3> &cellCoords, long first, long last,
+    std::vector<size_t> &retlist) const {
+  const long columns = _ordering.getDimensions()[0];
   std::array<size_t, 3> start = {
       {0, (cellCoords[1] > 0) ? 0 : _ordering.getDimensions()[1] - 1,
        cellCoords[2]}};
-  std::array<size_t, 3> steps = {{_ordering.getDimensions()[0], 0, overlink}};
-  // These are the two dimensions to walk in
-  for (auto cellIndex : _ordering.getSurroundingIndices(start, steps)) {
-    const auto neighbours = _cellData.getCellContents(cellIndex);
-    retlist.insert(retlist.end(), neighbours.begin(), neighbours.end());
+  // Only walk in the z dimension
+  const std::array<size_t, 3> steps = {{0, 0, overlink}};
+  for (long column = first; column <= last; ++column) {
+    start[0] = ((column % columns) + columns) % columns;
+    for (auto cellIndex : _ordering.getSurroundingIndices(start, steps)) {
+      const auto &neighbours = _cellData.getCellContents(cellIndex);
+      retlist.insert(retlist.end(), neighbours.begin(), neighbours.end());
+    }
   }
 }
 } // namespace dynamo
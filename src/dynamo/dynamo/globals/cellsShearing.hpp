@@ -20,6 +20,25 @@
 #include <dynamo/ranges/IDRange.hpp>
 
 namespace dynamo {
+class BCLeesEdwards;
+
+/*! \brief A cell neighbour list for Lees-Edwards (sliding brick)
+    boundary conditions.
+
+  The cells in the top and bottom (y) layers of the grid neighbour
+  a window of cells in the opposite layer, which slides along x with
+  the boundary displacement (BCLeesEdwards::getBoundaryDisplacement).
+  The window is six columns wide, which covers the particles in
+  range until the displacement crosses the next cell width, plus one
+  column of slack at each edge for rounding.
+
+  Each particle in a boundary layer has an extra virtual event at
+  the time the displacement next crosses a cell width. This adds the
+  column(s) entering its window as new neighbours, so the cost of
+  following the shear is a constant per particle instead of a
+  rescan of the whole x row of the opposite layer. Narrow systems,
+  where the window would cover the whole row, use the whole row.
+ */
 class GCellsShearing : public GCells {
 public:
   GCellsShearing(const magnet::xml::Node &, dynamo::Simulation *);
@@ -30,16 +49,68 @@ public:
 
   virtual void initialise(size_t);
 
+  virtual void reinitialise();
+
   virtual Event getEvent(const Particle &) const;
 
   virtual void runEvent(Particle &, const double);
 
+  //! \brief Also writes the boundary shift event times.
+  virtual void saveCheckpoint(CheckpointWriter &) const;
+
+  virtual void loadCheckpoint(CheckpointReader &);
+
 protected:
   void getParticleNeighbours(const std::array<size_t, 3> &,
                              std::vector<size_t> &) const;
-  void getAdditionalLEParticleNeighbourhood(const Particle &,
-                                            std::vector<size_t> &) const;
+
+  //! \brief Test if a cell is in the top or bottom layer of cells.
+  bool isBoundaryCell(const std::array<size_t, 3> &cellCoords) const {
+    return (cellCoords[1] == 0) ||
+           (cellCoords[1] == (_ordering.getDimensions()[1] - 1));
+  }
+
+  /*! \brief The boundary displacement, in units of the x cell
+      width, dt into the future.
+   */
+  double getShift(double dt) const;
+
+  /*! \brief The time until the passed shift (see getShift) next
+      crosses a cell width.
+   */
+  double getShiftDelay(double shift) const;
+
+  /*! \brief The first column of the window of the opposite layer
+      while the shift is in [base, base + 1).
+
+    The window is the columns [first, first + 5] (modulo the number
+    of columns).
+   */
+  long getWindowStart(const std::array<size_t, 3> &cellCoords,
+                      long base) const;
+
+  /*! \brief Add the contents of the window of the opposite layer to
+      the list, for the passed shift.
+   */
   void getAdditionalLEParticleNeighbourhood(std::array<size_t, 3>,
+                                            double shift,
                                             std::vector<size_t> &) const;
+
+  /*! \brief Add the contents of the opposite layer's columns
+      [first, last] which neighbour the cell (in z).
+   */
+  void addOppositeColumns(const std::array<size_t, 3> &cellCoords, long first,
+                          long last, std::vector<size_t> &) const;
+
+  //! \brief The boundary, if it is a Lees-Edwards boundary.
+  shared_ptr<const BCLeesEdwards> _LEBC;
+
+  /*! \brief The system time of the next boundary shift event of
+      each particle in a boundary layer.
+
+    Entries are NaN until the particle's event is first requested,
+    as global events are run before the system time reaches them.
+   */
+  mutable std::vector<double> _shiftTime;
 };
 } // namespace dynamo
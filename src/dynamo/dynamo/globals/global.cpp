@@ -47,6 +47,10 @@ shared_ptr<Global> Global::getClass(const magnet::xml::Node &XML,
       return shared_ptr<Global>(new GCells(XML, Sim));
   } else if (!XML.getAttribute("Type").getValue().compare("SOCells"))
     return shared_ptr<Global>(new GSOCells(XML, Sim));
+  else if (!XML.getAttribute("Type").getValue().compare("MultiLevelCells"))
+    return shared_ptr<Global>(new GMultiLevelCells(XML, Sim));
+  else if (!XML.getAttribute("Type").getValue().compare("VerletList"))
+    return shared_ptr<Global>(new GVerletList(XML, Sim));
   else if (!XML.getAttribute("Type").getValue().compare("Francesco"))
     return shared_ptr<Global>(new GFrancesco(XML, Sim));
   else if (!XML.getAttribute("Type").getValue().compare("Waker"))
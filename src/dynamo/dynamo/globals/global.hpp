@@ -31,6 +31,8 @@ class XmlStream;
 namespace dynamo {
 class NEventData;
 class IDRange;
+class CheckpointWriter;
+class CheckpointReader;
 
 /*! \brief Base class for Non-\ref Local single-particle events.
 
@@ -72,6 +74,20 @@ public:
    */
   virtual void initialise(size_t nID) { ID = nID; }
 
+  /*! \brief Write any state which cannot be rebuilt from the
+      configuration to a checkpoint (see Simulation::writeCheckpoint).
+   */
+  virtual void saveCheckpoint(CheckpointWriter &) const {}
+
+  /*! \brief Restore the state written by saveCheckpoint(), after
+      the Global has been initialised.
+   */
+  virtual void loadCheckpoint(CheckpointReader &) {}
+
+  /*! \brief Write any results of the Global to the output file.
+   */
+  virtual void outputData(magnet::xml::XmlStream &) const {}
+
   /*! \brief Helper function for saving an XML representation of this
     class.
    */
@@ -100,6 +116,11 @@ public:
    */
   inline const size_t &getID() const { return ID; }
 
+  /*! \brief Returns the IDRange of the particles this Global acts
+      on (this may be null).
+   */
+  const shared_ptr<IDRange> &getRange() const { return range; }
+
 protected:
   /*! \brief Writes out an XML representation of the Global
    */
@@ -20,6 +20,8 @@
 #include <dynamo/globals/cells.hpp>
 #include <dynamo/globals/cellsShearing.hpp>
 #include <dynamo/globals/francesco.hpp>
+#include <dynamo/globals/multiLevelCells.hpp>
 #include <dynamo/globals/socells.hpp>
+#include <dynamo/globals/verletList.hpp>
 #include <dynamo/globals/volumetric_potential.hpp>
 #include <dynamo/globals/waker.hpp>
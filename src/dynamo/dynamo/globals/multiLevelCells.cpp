@@ -0,0 +1,443 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <dynamo/BC/LEBC.hpp>
+#include <dynamo/checkpoint.hpp>
+#include <dynamo/dynamics/compression.hpp>
+#include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/globals/multiLevelCells.hpp>
+#include <dynamo/interactions/interaction.hpp>
+#include <dynamo/profiler.hpp>
+#include <dynamo/schedulers/scheduler.hpp>
+#include <dynamo/simulation.hpp>
+#include <dynamo/units/units.hpp>
+#include <magnet/xmlreader.hpp>
+#include <magnet/xmlwriter.hpp>
+
+namespace dynamo {
+GMultiLevelCells::GMultiLevelCells(dynamo::Simulation *nSim,
+                                   const std::string &name)
+    : GNeighbourList(nSim, "MultiLevelCells"), _ratio(2), _maxLevels(8),
+      _inConfig(true) {
+  globName = name;
+  dout << "Multi-level Cells Loaded" << std::endl;
+}
+
+GMultiLevelCells::GMultiLevelCells(const magnet::xml::Node &XML,
+                                   dynamo::Simulation *ptrSim)
+    : GNeighbourList(ptrSim, "MultiLevelCells"), _ratio(2), _maxLevels(8),
+      _inConfig(true) {
+  GMultiLevelCells::operator<<(XML);
+
+  dout << "Multi-level Cells Loaded" << std::endl;
+}
+
+void GMultiLevelCells::operator<<(const magnet::xml::Node &XML) {
+  if (XML.hasAttribute("Ratio"))
+    _ratio = XML.getAttribute("Ratio").as<size_t>();
+
+  if (XML.hasAttribute("MaxLevels"))
+    _maxLevels = XML.getAttribute("MaxLevels").as<size_t>();
+
+  if (_ratio < 2)
+    M_throw() << "The Ratio of MultiLevelCells must be at least 2";
+
+  if (!_maxLevels)
+    M_throw() << "MultiLevelCells needs at least one level";
+
+  globName = XML.getAttribute("Name");
+
+  range = shared_ptr<IDRange>(IDRange::getClass(XML.getNode("IDRange"), Sim));
+}
+
+Event GMultiLevelCells::getEvent(const Particle &part) const {
+#ifdef ISSS_DEBUG
+  if (!Sim->dynamics->isUpToDate(part))
+    M_throw() << "Particle is not up to date";
+#endif
+
+  const Level &level = _levels[_particleLevel[part.getID()]];
+
+  // We always use the periodic image of the cell nearest to the
+  // particle
+  Vector origin = getCellCentre(_particleLevel[part.getID()],
+                                _particleCell[part.getID()]);
+  for (size_t i = 0; i < NDIM; ++i)
+    origin[i] -= Sim->primaryCellSize[i] *
+                     lrint((origin[i] - part.getPosition()[i]) /
+                           Sim->primaryCellSize[i]) +
+                 0.5 * level.width[i];
+
+  return Event(part,
+               Sim->dynamics->getSquareCellCollision2(part, origin,
+                                                      level.width) -
+                   Sim->dynamics->getParticleDelay(part),
+               GLOBAL, CELL, ID);
+}
+
+void GMultiLevelCells::runEvent(Particle &part, const double) {
+  // The scheduler and all interactions, locals and systems expect
+  // the particle to be up to date.
+  Sim->dynamics->updateParticle(part);
+
+  // Get rid of the virtual event we're running, an updated event is
+  // pushed after the callbacks are complete (the callbacks may also
+  // add events so this must be done first).
+  Sim->scheduler->popNextEvent();
+  DYNAMO_PROFILE_SCOPE(Sim, CELL_TRANSITION);
+
+  const size_t ID = part.getID();
+  const size_t levelID = _particleLevel[ID];
+  Level &level = _levels[levelID];
+  const size_t oldCell = _particleCell[ID];
+
+  // Determine the cell transition direction
+  Vector origin = getCellCentre(levelID, oldCell);
+  for (size_t i = 0; i < NDIM; ++i)
+    origin[i] -= Sim->primaryCellSize[i] *
+                     lrint((origin[i] - part.getPosition()[i]) /
+                           Sim->primaryCellSize[i]) +
+                 0.5 * level.width[i];
+  const int cellDirectionInt(
+      Sim->dynamics->getSquareCellCollision3(part, origin, level.width));
+  const size_t cellDirection = abs(cellDirectionInt) - 1;
+
+  auto newCoords = level.ordering.toCoord(oldCell);
+  const size_t dim = level.ordering.getDimensions()[cellDirection];
+  newCoords[cellDirection] += dim + ((cellDirectionInt > 0) ? 1 : -1);
+  newCoords[cellDirection] %= dim;
+  const size_t newCell = level.ordering.toIndex(newCoords);
+
+  std::vector<size_t> &oldContents = level.contents[oldCell];
+  oldContents.erase(std::find(oldContents.begin(), oldContents.end(), ID));
+  addParticle(ID, levelID, newCell);
+
+  // The particles in the cells which neighbour the new cell but not
+  // the old one are the new neighbours
+  const Vector oldCentre = getCellCentre(levelID, oldCell);
+  const Vector newCentre = getCellCentre(levelID, newCell);
+  const Vector halfWidth = 0.5 * level.width;
+  std::vector<size_t> cells;
+  _newNeighbours.clear();
+  for (size_t other(0); other < _levels.size(); ++other) {
+    const Level &otherLevel = _levels[other];
+    if (!otherLevel.count)
+      continue;
+
+    const double range = level.radius + otherLevel.radius;
+    cells.clear();
+    getNeighbourCells(newCentre, halfWidth, range, other, cells);
+    for (const size_t &cell : cells)
+      if (!boxesNeighbour(oldCentre, halfWidth, getCellCentre(other, cell),
+                          0.5 * otherLevel.width, range))
+        _newNeighbours.insert(_newNeighbours.end(),
+                              otherLevel.contents[cell].begin(),
+                              otherLevel.contents[cell].end());
+  }
+  _sigNewNeighbours(part, _newNeighbours);
+
+  // Push the next virtual event, this is the reason the scheduler
+  // doesn't need a second callback
+  Sim->scheduler->pushEvent(getEvent(part));
+  _sigCellChange(part, oldCell);
+}
+
+void GMultiLevelCells::initialise(size_t nID) {
+  Global::initialise(nID);
+  reinitialise();
+}
+
+void GMultiLevelCells::reinitialise() {
+  GNeighbourList::reinitialise();
+
+  if (std::dynamic_pointer_cast<BCLeesEdwards>(Sim->BCs))
+    M_throw() << "MultiLevelCells does not support Lees-Edwards boundary "
+                 "conditions, use Cells";
+
+  if (std::dynamic_pointer_cast<DynCompression>(Sim->dynamics))
+    M_throw() << "MultiLevelCells does not support compression dynamics, "
+                 "use Cells";
+
+  dout << "Reinitialising on collision " << Sim->eventCount << std::endl;
+
+  // A particle's radius is its largest over the Interactions which
+  // may include it
+  std::vector<double> radii(Sim->N(), 0);
+  for (const size_t &pid : *range)
+    for (const shared_ptr<Interaction> &interaction : Sim->interactions)
+      if (interaction->getRange()->isInRange(Sim->particles[pid]))
+        radii[pid] =
+            std::max(radii[pid], interaction->getInteractionRadius(pid));
+
+  buildLevels(radii);
+  _sigReInitialise();
+}
+
+void GMultiLevelCells::buildLevels(const std::vector<double> &radii) {
+  double maxRadius = 0;
+  double minRadius = std::numeric_limits<double>::infinity();
+  for (const size_t &pid : *range) {
+    maxRadius = std::max(maxRadius, radii[pid]);
+    minRadius = std::min(minRadius, radii[pid]);
+  }
+
+  // The top level cells hold the largest particles
+  const double embiggen = 1.0 + 10 * std::numeric_limits<double>::epsilon();
+  std::array<size_t, 3> cellCount;
+  for (size_t iDim = 0; iDim < NDIM; iDim++)
+    cellCount[iDim] =
+        (maxRadius > 0)
+            ? std::max(size_t(Sim->primaryCellSize[iDim] /
+                              (2 * maxRadius * embiggen)),
+                       size_t(1))
+            : size_t(1);
+
+  auto minWidth = [&](const std::array<size_t, 3> &count) {
+    double width = std::numeric_limits<double>::infinity();
+    for (size_t iDim = 0; iDim < NDIM; iDim++)
+      width = std::min(width, Sim->primaryCellSize[iDim] / count[iDim]);
+    return width;
+  };
+
+  std::vector<std::array<size_t, 3>> counts{cellCount};
+  while (counts.size() < _maxLevels) {
+    for (size_t iDim = 0; iDim < NDIM; iDim++)
+      cellCount[iDim] *= _ratio;
+
+    const size_t total = cellCount[0] * cellCount[1] * cellCount[2];
+    if ((total > 8 * Sim->N()) || (minWidth(cellCount) < 2 * minRadius))
+      break;
+    counts.push_back(cellCount);
+  }
+
+  _levels.clear();
+  _levels.resize(counts.size());
+  for (size_t l(0); l < counts.size(); ++l) {
+    Level &level = _levels[l];
+    level.ordering = Ordering(counts[l]);
+    for (size_t iDim = 0; iDim < NDIM; iDim++)
+      level.width[iDim] = Sim->primaryCellSize[iDim] / counts[l][iDim];
+    level.radius = 0;
+    level.count = 0;
+    level.contents.assign(level.ordering.length(), std::vector<size_t>());
+  }
+
+  // Required so particles find the right owning cell
+  Sim->dynamics->updateAllParticles();
+  _particleLevel.assign(Sim->N(), 0);
+  _particleCell.assign(Sim->N(), 0);
+  for (const size_t &pid : *range) {
+    // The finest level with cells at least the particle's diameter
+    size_t l = 0;
+    while ((l + 1 < counts.size()) &&
+           (minWidth(counts[l + 1]) >= 2 * radii[pid]))
+      ++l;
+
+    Level &level = _levels[l];
+    level.radius = std::max(level.radius, radii[pid]);
+    ++level.count;
+    addParticle(pid, l, level.ordering.toIndex(getCellCoords(
+                            l, Sim->particles[pid].getPosition())));
+  }
+
+  for (size_t l(0); l < _levels.size(); ++l)
+    dout << "Level " << l << ": Cells " << counts[l][0] << "," << counts[l][1]
+         << "," << counts[l][2] << ", Particles " << _levels[l].count
+         << ", Max radius " << _levels[l].radius / Sim->units.unitLength()
+         << std::endl;
+}
+
+void GMultiLevelCells::addParticle(size_t ID, size_t level, size_t cell) {
+  _particleLevel[ID] = level;
+  _particleCell[ID] = cell;
+  _levels[level].contents[cell].push_back(ID);
+}
+
+std::array<size_t, 3> GMultiLevelCells::getCellCoords(size_t level,
+                                                      Vector pos) const {
+  Sim->BCs->applyBC(pos);
+
+  const Level &lvl = _levels[level];
+  std::array<size_t, 3> retval;
+  for (size_t iDim = 0; iDim < NDIM; iDim++) {
+    const long dim = lvl.ordering.getDimensions()[iDim];
+    long coord = std::floor(pos[iDim] / lvl.width[iDim] + 0.5 * dim);
+    coord %= dim;
+    if (coord < 0)
+      coord += dim;
+    retval[iDim] = coord;
+  }
+
+  return retval;
+}
+
+Vector GMultiLevelCells::getCellCentre(size_t level, size_t cell) const {
+  const Level &lvl = _levels[level];
+  const auto coords = lvl.ordering.toCoord(cell);
+  Vector centre;
+  for (size_t iDim(0); iDim < NDIM; ++iDim)
+    centre[iDim] = (coords[iDim] + 0.5) * lvl.width[iDim] -
+                   0.5 * Sim->primaryCellSize[iDim];
+  return centre;
+}
+
+bool GMultiLevelCells::boxesNeighbour(const Vector &centre1,
+                                      const Vector &halfWidth1,
+                                      const Vector &centre2,
+                                      const Vector &halfWidth2,
+                                      double range) const {
+  Vector rij = centre1 - centre2;
+  Sim->BCs->applyBC(rij);
+
+  double distSq = 0;
+  for (size_t iDim = 0; iDim < NDIM; iDim++) {
+    const double gap = std::max(
+        0.0, std::abs(rij[iDim]) - halfWidth1[iDim] - halfWidth2[iDim]);
+    distSq += gap * gap;
+  }
+
+  return distSq <= range * range;
+}
+
+void GMultiLevelCells::getNeighbourCells(const Vector &centre,
+                                         const Vector &halfWidth,
+                                         double range, size_t level,
+                                         std::vector<size_t> &cells) const {
+  const Level &lvl = _levels[level];
+
+  // The span of cells along each axis, or every cell of the axis if
+  // the span would wrap onto itself
+  std::array<std::vector<size_t>, 3> axes;
+  for (size_t iDim = 0; iDim < NDIM; iDim++) {
+    const long dim = lvl.ordering.getDimensions()[iDim];
+    const double reach = halfWidth[iDim] + range;
+    const long lo =
+        std::floor((centre[iDim] - reach) / lvl.width[iDim] + 0.5 * dim);
+    const long hi =
+        std::floor((centre[iDim] + reach) / lvl.width[iDim] + 0.5 * dim);
+    if (hi - lo + 1 >= dim)
+      for (long c(0); c < dim; ++c)
+        axes[iDim].push_back(c);
+    else
+      for (long c(lo); c <= hi; ++c)
+        axes[iDim].push_back(((c % dim) + dim) % dim);
+  }
+
+  const Vector otherHalfWidth = 0.5 * lvl.width;
+  for (const size_t &x : axes[0])
+    for (const size_t &y : axes[1])
+      for (const size_t &z : axes[2]) {
+        const size_t cell =
+            lvl.ordering.toIndex(std::array<size_t, 3>{{x, y, z}});
+        if (boxesNeighbour(centre, halfWidth, getCellCentre(level, cell),
+                           otherHalfWidth, range))
+          cells.push_back(cell);
+      }
+}
+
+void GMultiLevelCells::getParticleNeighbours(
+    const Particle &part, std::vector<size_t> &retlist) const {
+  const size_t levelID = _particleLevel[part.getID()];
+  const Level &level = _levels[levelID];
+  const Vector centre = getCellCentre(levelID, _particleCell[part.getID()]);
+
+  std::vector<size_t> cells;
+  for (size_t other(0); other < _levels.size(); ++other) {
+    const Level &otherLevel = _levels[other];
+    if (!otherLevel.count)
+      continue;
+
+    cells.clear();
+    getNeighbourCells(centre, 0.5 * level.width,
+                      level.radius + otherLevel.radius, other, cells);
+    for (const size_t &cell : cells)
+      retlist.insert(retlist.end(), otherLevel.contents[cell].begin(),
+                     otherLevel.contents[cell].end());
+  }
+}
+
+void GMultiLevelCells::getParticleNeighbours(
+    const Vector &pos, std::vector<size_t> &retlist) const {
+  Vector centre = pos;
+  Sim->BCs->applyBC(centre);
+
+  double maxRadius = 0;
+  for (const Level &level : _levels)
+    maxRadius = std::max(maxRadius, level.radius);
+
+  std::vector<size_t> cells;
+  for (size_t other(0); other < _levels.size(); ++other) {
+    const Level &otherLevel = _levels[other];
+    if (!otherLevel.count)
+      continue;
+
+    cells.clear();
+    getNeighbourCells(centre, Vector{0, 0, 0}, maxRadius + otherLevel.radius,
+                      other, cells);
+    for (const size_t &cell : cells)
+      retlist.insert(retlist.end(), otherLevel.contents[cell].begin(),
+                     otherLevel.contents[cell].end());
+  }
+}
+
+double GMultiLevelCells::getMaxSupportedInteractionLength() const {
+  double maxRadius = 0;
+  for (const Level &level : _levels)
+    maxRadius = std::max(maxRadius, level.radius);
+  return 2 * maxRadius;
+}
+
+void GMultiLevelCells::saveCheckpoint(CheckpointWriter &out) const {
+  out.write<uint64_t>(_levels.size());
+  for (const Level &level : _levels) {
+    out.write(level.ordering.getDimensions());
+    for (const std::vector<size_t> &contents : level.contents)
+      out.write(contents);
+  }
+}
+
+void GMultiLevelCells::loadCheckpoint(CheckpointReader &in) {
+  if (in.read<uint64_t>() != _levels.size())
+    M_throw() << "The checkpoint has a different number of cell levels";
+
+  std::vector<size_t> contents;
+  for (size_t l(0); l < _levels.size(); ++l) {
+    Level &level = _levels[l];
+    if (in.read<std::array<size_t, 3>>() != level.ordering.getDimensions())
+      M_throw() << "The checkpoint cells of level " << l
+                << " do not match the configuration";
+
+    for (size_t cell(0); cell < level.contents.size(); ++cell) {
+      level.contents[cell].clear();
+      in.read(contents);
+      for (const size_t pid : contents)
+        addParticle(pid, l, cell);
+    }
+  }
+}
+
+void GMultiLevelCells::outputXML(magnet::xml::XmlStream &XML) const {
+  if (!_inConfig)
+    return;
+  XML << magnet::xml::tag("Global") << magnet::xml::attr("Type")
+      << "MultiLevelCells" << magnet::xml::attr("Name") << globName
+      << magnet::xml::attr("Ratio") << _ratio
+      << magnet::xml::attr("MaxLevels") << _maxLevels << range
+      << magnet::xml::endtag("Global");
+}
+} // namespace dynamo
@@ -0,0 +1,137 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/globals/neighbourList.hpp>
+#include <dynamo/particle.hpp>
+#include <magnet/containers/ordering.hpp>
+#include <vector>
+
+namespace dynamo {
+/*! \brief A hierarchy of cell grids, for systems where the
+    interaction ranges of the particles differ greatly.
+
+  GCells sizes every cell by the longest interaction, so a few large
+  particles (or long ranged wells) make the cells, and the number of
+  neighbours tested for every particle, large. Here each level of the
+  hierarchy is a regular grid of cells Ratio times finer than the
+  level above, and each particle lives in the finest level whose
+  cells are at least its interaction diameter
+  (Interaction::getInteractionRadius()).
+
+  Two cells (at any levels) are neighbours if their boxes are within
+  the sum of the largest interaction radii of the particles of their
+  levels. A particle is tested against the contents of its cell's
+  neighbours at every level, so small particles test the few large
+  particles in the coarse cells nearby, while large particles search
+  down the hierarchy for the small ones nearby. A particle gains
+  neighbours when it moves into a new cell, and these are found
+  from the cells which neighbour the new but not the old cell.
+
+  The levels are refined until the finest cells are smaller than the
+  smallest particles, the level count reaches MaxLevels, or the level
+  would have more than eight cells per particle. Unlike GCells, the
+  cells do not overlap. Lees-Edwards boundaries and compressing
+  dynamics are not supported.
+ */
+class GMultiLevelCells : public GNeighbourList {
+public:
+  GMultiLevelCells(const magnet::xml::Node &, dynamo::Simulation *);
+  GMultiLevelCells(Simulation *, const std::string &);
+
+  virtual ~GMultiLevelCells() {}
+
+  virtual Event getEvent(const Particle &) const;
+
+  virtual void runEvent(Particle &, const double);
+
+  virtual void initialise(size_t);
+
+  virtual void reinitialise();
+
+  /*! \brief Writes the ordered contents of each cell, as particles
+      on a cell boundary cannot be assigned to a cell from their
+      positions.
+   */
+  virtual void saveCheckpoint(CheckpointWriter &) const;
+
+  virtual void loadCheckpoint(CheckpointReader &);
+
+  void getParticleNeighbours(const Particle &, std::vector<size_t> &) const;
+
+  /*! \brief Returns the particles which may interact with a particle
+      of the largest interaction radius at the passed position.
+   */
+  void getParticleNeighbours(const Vector &, std::vector<size_t> &) const;
+
+  virtual void operator<<(const magnet::xml::Node &);
+
+  virtual double getMaxSupportedInteractionLength() const;
+
+  //! \brief The number of levels in the hierarchy.
+  size_t getLevelCount() const { return _levels.size(); }
+
+  //! \brief The level a particle is stored in.
+  size_t getParticleLevel(size_t ID) const { return _particleLevel[ID]; }
+
+  void setConfigOutput(bool val) { _inConfig = val; }
+
+protected:
+  virtual void outputXML(magnet::xml::XmlStream &) const;
+
+  typedef magnet::containers::RowMajorOrdering<3> Ordering;
+
+  struct Level {
+    Ordering ordering;
+    Vector width;
+    //! \brief The largest interaction radius of the level's particles.
+    double radius;
+    size_t count;
+    std::vector<std::vector<size_t>> contents;
+  };
+
+  void buildLevels(const std::vector<double> &radii);
+
+  void addParticle(size_t ID, size_t level, size_t cell);
+
+  std::array<size_t, 3> getCellCoords(size_t level, Vector) const;
+
+  Vector getCellCentre(size_t level, size_t cell) const;
+
+  /*! \brief Test if two boxes, given by their centres and half
+      widths, are within the passed range of each other.
+   */
+  bool boxesNeighbour(const Vector &centre1, const Vector &halfWidth1,
+                      const Vector &centre2, const Vector &halfWidth2,
+                      double range) const;
+
+  /*! \brief Collect the cells of a level which are within range of
+      the passed box (each cell appears once).
+   */
+  void getNeighbourCells(const Vector &centre, const Vector &halfWidth,
+                         double range, size_t level,
+                         std::vector<size_t> &cells) const;
+
+  std::vector<Level> _levels;
+  std::vector<size_t> _particleLevel;
+  std::vector<size_t> _particleCell;
+
+  size_t _ratio;
+  size_t _maxLevels;
+  bool _inConfig;
+};
+} // namespace dynamo
@@ -79,8 +79,12 @@ public:
    */
   double getMaxInteractionRange() const { return _maxInteractionRange; }
 
-  mutable magnet::Signal<void(const Particle &, const size_t &)>
-      _sigNewNeighbour;
+  /*! \brief Signalled with the particles which have just become
+      neighbours of a particle (as a batch, so their events may be
+      predicted and pushed together).
+   */
+  mutable magnet::Signal<void(const Particle &, const std::vector<size_t> &)>
+      _sigNewNeighbours;
   mutable magnet::Signal<void(const Particle &, const size_t &)> _sigCellChange;
   mutable magnet::Signal<void()> _sigReInitialise;
 
@@ -88,6 +92,9 @@ protected:
   bool _initialised;
   double _maxInteractionRange;
 
+  //! \brief Storage for collecting the batches of _sigNewNeighbours.
+  std::vector<size_t> _newNeighbours;
+
   GNeighbourList(const GNeighbourList &);
 
   virtual void outputXML(magnet::xml::XmlStream &) const = 0;
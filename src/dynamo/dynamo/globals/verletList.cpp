@@ -0,0 +1,338 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <dynamo/BC/LEBC.hpp>
+#include <dynamo/checkpoint.hpp>
+#include <dynamo/dynamics/compression.hpp>
+#include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/globals/verletList.hpp>
+#include <dynamo/profiler.hpp>
+#include <dynamo/schedulers/scheduler.hpp>
+#include <dynamo/simulation.hpp>
+#include <dynamo/units/units.hpp>
+#include <magnet/xmlreader.hpp>
+#include <magnet/xmlwriter.hpp>
+
+namespace dynamo {
+GVerletList::GVerletList(dynamo::Simulation *nSim, const std::string &name,
+                         double skin)
+    : GNeighbourList(nSim, "VerletNeighbourList"), _skin(skin),
+      _inConfig(true), _rebuilds(0) {
+  globName = name;
+  dout << "Verlet List Loaded" << std::endl;
+}
+
+GVerletList::GVerletList(const magnet::xml::Node &XML,
+                         dynamo::Simulation *ptrSim)
+    : GNeighbourList(ptrSim, "VerletNeighbourList"), _skin(0), _inConfig(true),
+      _rebuilds(0) {
+  GVerletList::operator<<(XML);
+
+  dout << "Verlet List Loaded" << std::endl;
+}
+
+void GVerletList::operator<<(const magnet::xml::Node &XML) {
+  if (XML.hasAttribute("Skin"))
+    _skin = XML.getAttribute("Skin").as<double>() * Sim->units.unitLength();
+
+  if (XML.hasAttribute("NeighbourhoodRange"))
+    _maxInteractionRange = XML.getAttribute("NeighbourhoodRange").as<double>() *
+                           Sim->units.unitLength();
+
+  globName = XML.getAttribute("Name");
+
+  range = shared_ptr<IDRange>(IDRange::getClass(XML.getNode("IDRange"), Sim));
+}
+
+Event GVerletList::getEvent(const Particle &part) const {
+#ifdef ISSS_DEBUG
+  if (!Sim->dynamics->isUpToDate(part))
+    M_throw() << "Particle is not up to date";
+#endif
+
+  // The periodic image of the box nearest to the particle
+  Vector centre = _origins[part.getID()] - part.getPosition();
+  Sim->BCs->applyBC(centre);
+  centre += part.getPosition();
+
+  const Vector width{_skin, _skin, _skin};
+  return Event(part,
+               Sim->dynamics->getSquareCellCollision2(
+                   part, centre - 0.5 * width, width) -
+                   Sim->dynamics->getParticleDelay(part),
+               GLOBAL, CELL, ID);
+}
+
+void GVerletList::runEvent(Particle &part, const double dt) {
+  // The scheduler and all interactions, locals and systems expect
+  // the particle to be up to date.
+  Sim->dynamics->updateParticle(part);
+
+  // Get rid of the virtual event we're running, an updated event is
+  // pushed after the callbacks are complete (the callbacks may also
+  // add events so this must be done first).
+  Sim->scheduler->popNextEvent();
+  DYNAMO_PROFILE_SCOPE(Sim, CELL_TRANSITION);
+
+  const size_t ID = part.getID();
+  ++_rebuilds;
+
+  // Global events are run before the system is streamed to their
+  // time, so the new box is centred where the particle leaves the old
+  // one.
+  double exitTime = dt;
+  Sim->dynamics->advanceUpdateParticle(part, exitTime);
+  const Vector exitPosition = part.getPosition();
+  Sim->dynamics->updateParticle(part);
+
+  // Recentre the particle's box and rebuild its list
+  gridRemove(ID);
+  _origins[ID] = exitPosition;
+  gridInsert(ID);
+
+  std::vector<size_t> newNeighbours;
+  findNeighbours(ID, newNeighbours);
+  std::vector<size_t> &oldNeighbours = _neighbours[ID];
+
+  // Keep the lists symmetric by walking the (sorted) old and new
+  // lists, collecting the new neighbours
+  std::vector<size_t> added;
+  auto oldIt = oldNeighbours.begin();
+  auto newIt = newNeighbours.begin();
+  while ((oldIt != oldNeighbours.end()) || (newIt != newNeighbours.end()))
+    if ((newIt == newNeighbours.end()) ||
+        ((oldIt != oldNeighbours.end()) && (*oldIt < *newIt))) {
+      std::vector<size_t> &list = _neighbours[*oldIt];
+      list.erase(std::lower_bound(list.begin(), list.end(), ID));
+      ++oldIt;
+    } else if ((oldIt == oldNeighbours.end()) || (*newIt < *oldIt)) {
+      std::vector<size_t> &list = _neighbours[*newIt];
+      list.insert(std::lower_bound(list.begin(), list.end(), ID), ID);
+      added.push_back(*newIt);
+      ++newIt;
+    } else {
+      ++oldIt;
+      ++newIt;
+    }
+
+  oldNeighbours = std::move(newNeighbours);
+
+  // Only the new neighbours need their events testing, the events
+  // of the retained ones are already scheduled.
+  _sigNewNeighbours(part, added);
+
+  // Push the next virtual event, this is the reason the scheduler
+  // doesn't need a second callback
+  Sim->scheduler->pushEvent(getEvent(part));
+}
+
+void GVerletList::initialise(size_t nID) {
+  Global::initialise(nID);
+  reinitialise();
+}
+
+void GVerletList::reinitialise() {
+  GNeighbourList::reinitialise();
+
+  if (std::dynamic_pointer_cast<BCLeesEdwards>(Sim->BCs))
+    M_throw() << "The VerletList neighbour list does not support "
+                 "Lees-Edwards boundary conditions, use Cells";
+
+  if (std::dynamic_pointer_cast<DynCompression>(Sim->dynamics))
+    M_throw() << "The VerletList neighbour list does not support "
+                 "compression dynamics, use Cells";
+
+  if (_skin <= 0)
+    _skin = 0.5 * _maxInteractionRange;
+
+  dout << "Reinitialising on collision " << Sim->eventCount << std::endl;
+
+  // The boxes are centred on the current positions
+  Sim->dynamics->updateAllParticles();
+  _origins.assign(Sim->N(), Vector{0, 0, 0});
+  for (const size_t &pid : *range)
+    _origins[pid] = Sim->particles[pid].getPosition();
+
+  buildLists();
+  _sigReInitialise();
+}
+
+void GVerletList::buildLists() {
+  // Any pair of candidates is within the interaction range plus the
+  // skin along every axis, which must span at most the neighbouring
+  // cells.
+  const double minWidth = _maxInteractionRange + _skin;
+  const double embiggen = 1.0 + 10 * std::numeric_limits<double>::epsilon();
+  std::array<size_t, 3> cellCount;
+  for (size_t iDim = 0; iDim < NDIM; iDim++) {
+    cellCount[iDim] = std::max(
+        size_t(Sim->primaryCellSize[iDim] / (minWidth * embiggen)), size_t(1));
+    _gridWidth[iDim] = Sim->primaryCellSize[iDim] / cellCount[iDim];
+  }
+  _ordering = Ordering(cellCount);
+
+  dout << "Verlet skin " << _skin / Sim->units.unitLength()
+       << "\nInteraction range "
+       << _maxInteractionRange / Sim->units.unitLength() << "\nGrid cells "
+       << cellCount[0] << "," << cellCount[1] << "," << cellCount[2]
+       << std::endl;
+
+  _gridContents.assign(_ordering.length(), std::vector<size_t>());
+  _gridCell.assign(Sim->N(), 0);
+  for (const size_t &pid : *range)
+    gridInsert(pid);
+
+  _neighbours.assign(Sim->N(), std::vector<size_t>());
+  for (const size_t &pid : *range)
+    findNeighbours(pid, _neighbours[pid]);
+
+  _rebuilds = 0;
+
+  size_t total = 0;
+  for (const auto &list : _neighbours)
+    total += list.size();
+  dout << "Mean Verlet list length " << double(total) / range->size()
+       << std::endl;
+}
+
+bool GVerletList::mayInteract(const Vector &r1, const Vector &r2) const {
+  Vector rij = r1 - r2;
+  Sim->BCs->applyBC(rij);
+
+  // Each box extends half the skin either side of its centre, so
+  // their closest approach along an axis is the separation less the
+  // skin.
+  double distSq = 0;
+  for (size_t iDim = 0; iDim < NDIM; iDim++) {
+    const double gap = std::max(0.0, std::abs(rij[iDim]) - _skin);
+    distSq += gap * gap;
+  }
+
+  return distSq <= _maxInteractionRange * _maxInteractionRange;
+}
+
+void GVerletList::findNeighbours(size_t ID,
+                                 std::vector<size_t> &retlist) const {
+  retlist.clear();
+  getGridNeighbours(_ordering.toCoord(_gridCell[ID]), retlist);
+  retlist.erase(std::remove_if(retlist.begin(), retlist.end(),
+                               [&](const size_t &pid) {
+                                 return (pid == ID) ||
+                                        !mayInteract(_origins[ID],
+                                                     _origins[pid]);
+                               }),
+                retlist.end());
+  std::sort(retlist.begin(), retlist.end());
+}
+
+std::array<size_t, 3> GVerletList::getGridCoords(Vector pos) const {
+  Sim->BCs->applyBC(pos);
+
+  std::array<size_t, 3> retval;
+  for (size_t iDim = 0; iDim < NDIM; iDim++) {
+    long coord = std::floor(pos[iDim] / _gridWidth[iDim] +
+                            0.5 * _ordering.getDimensions()[iDim]);
+    coord %= long(_ordering.getDimensions()[iDim]);
+    if (coord < 0)
+      coord += _ordering.getDimensions()[iDim];
+    retval[iDim] = coord;
+  }
+
+  return retval;
+}
+
+void GVerletList::getGridNeighbours(const std::array<size_t, 3> &coords,
+                                    std::vector<size_t> &retlist) const {
+  // The neighbouring cells along each axis, with every cell of an
+  // axis used when there are too few for the neighbours to be
+  // distinct.
+  std::array<std::vector<size_t>, 3> axes;
+  for (size_t iDim = 0; iDim < NDIM; iDim++) {
+    const size_t dim = _ordering.getDimensions()[iDim];
+    if (dim < 3)
+      for (size_t c(0); c < dim; ++c)
+        axes[iDim].push_back(c);
+    else
+      for (size_t c : {dim - 1, size_t(0), size_t(1)})
+        axes[iDim].push_back((coords[iDim] + c) % dim);
+  }
+
+  for (const size_t &x : axes[0])
+    for (const size_t &y : axes[1])
+      for (const size_t &z : axes[2]) {
+        const auto &contents =
+            _gridContents[_ordering.toIndex(std::array<size_t, 3>{{x, y, z}})];
+        retlist.insert(retlist.end(), contents.begin(), contents.end());
+      }
+}
+
+void GVerletList::gridInsert(size_t ID) {
+  _gridCell[ID] = _ordering.toIndex(getGridCoords(_origins[ID]));
+  _gridContents[_gridCell[ID]].push_back(ID);
+}
+
+void GVerletList::gridRemove(size_t ID) {
+  std::vector<size_t> &contents = _gridContents[_gridCell[ID]];
+  *std::find(contents.begin(), contents.end(), ID) = contents.back();
+  contents.pop_back();
+}
+
+void GVerletList::saveCheckpoint(CheckpointWriter &out) const {
+  out.write(_origins);
+}
+
+void GVerletList::loadCheckpoint(CheckpointReader &in) {
+  in.read(_origins);
+  if (_origins.size() != Sim->N())
+    M_throw() << "The checkpoint has " << _origins.size()
+              << " Verlet boxes but there are " << Sim->N() << " particles";
+
+  // The lists are sorted, so rebuilding them gives the lists of the
+  // original run
+  buildLists();
+}
+
+void GVerletList::getParticleNeighbours(const Particle &part,
+                                        std::vector<size_t> &retlist) const {
+  const std::vector<size_t> &list = _neighbours[part.getID()];
+  retlist.insert(retlist.end(), list.begin(), list.end());
+}
+
+void GVerletList::getParticleNeighbours(const Vector &vec,
+                                        std::vector<size_t> &retlist) const {
+  // Sorted, as the order of the grid contents depends on the history
+  const size_t start = retlist.size();
+  getGridNeighbours(getGridCoords(vec), retlist);
+  std::sort(retlist.begin() + start, retlist.end());
+}
+
+double GVerletList::getMaxSupportedInteractionLength() const {
+  return _maxInteractionRange;
+}
+
+void GVerletList::outputXML(magnet::xml::XmlStream &XML) const {
+  if (!_inConfig)
+    return;
+  XML << magnet::xml::tag("Global") << magnet::xml::attr("Type")
+      << "VerletList" << magnet::xml::attr("Name") << globName
+      << magnet::xml::attr("NeighbourhoodRange")
+      << _maxInteractionRange / Sim->units.unitLength()
+      << magnet::xml::attr("Skin") << _skin / Sim->units.unitLength() << range
+      << magnet::xml::endtag("Global");
+}
+} // namespace dynamo
@@ -0,0 +1,134 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/globals/neighbourList.hpp>
+#include <dynamo/particle.hpp>
+#include <magnet/containers/ordering.hpp>
+#include <vector>
+
+namespace dynamo {
+/*! \brief A Verlet (per-particle) neighbour list with a skin.
+
+  Each particle carries an explicit list of the particles which
+  might come within the interaction range of it before the list is
+  rebuilt, so the scheduler only tests these true neighbours for
+  events instead of every particle of the surrounding cells.
+
+  When a particle's list is built it is given a cubic "Verlet box"
+  of width Skin centred on its current position. The particle's
+  list is rebuilt by a virtual event when it leaves this box (i.e.,
+  when it has moved more than half the skin along an axis). Two
+  particles are neighbours if their boxes may approach within the
+  interaction range, thus no pair can interact before one of them
+  leaves its box and rebuilds its list.
+
+  The boxes are found using a uniform grid of cells (at least the
+  interaction range plus the skin wide) over the box centres, which
+  is only used when a list is rebuilt.
+
+  The lists are symmetric, so when a particle is rebuilt it is also
+  added to or removed from the lists of its new or lost neighbours.
+  Lees-Edwards boundaries and compressing dynamics are not
+  supported, as these move the boxes relative to each other.
+ */
+class GVerletList : public GNeighbourList {
+public:
+  GVerletList(const magnet::xml::Node &, dynamo::Simulation *);
+  GVerletList(Simulation *, const std::string &, double skin = 0);
+
+  virtual ~GVerletList() {}
+
+  virtual Event getEvent(const Particle &) const;
+
+  virtual void runEvent(Particle &, const double);
+
+  virtual void initialise(size_t);
+
+  virtual void reinitialise();
+
+  /*! \brief Writes the centres of the Verlet boxes.
+
+    The grid and the lists are rebuilt from these on loading.
+   */
+  virtual void saveCheckpoint(CheckpointWriter &) const;
+
+  virtual void loadCheckpoint(CheckpointReader &);
+
+  /*! \brief Returns the Verlet list of the particle (in ascending
+      ID order).
+   */
+  void getParticleNeighbours(const Particle &, std::vector<size_t> &) const;
+
+  /*! \brief Returns every particle whose box centre is in the grid
+      cells surrounding the passed position.
+   */
+  void getParticleNeighbours(const Vector &, std::vector<size_t> &) const;
+
+  virtual void operator<<(const magnet::xml::Node &);
+
+  virtual double getMaxSupportedInteractionLength() const;
+
+  //! \brief The width of the skin added around the interaction range.
+  double getSkin() const { return _skin; }
+
+  //! \brief The number of lists rebuilt since the last reinitialise.
+  size_t getRebuildCount() const { return _rebuilds; }
+
+  void setConfigOutput(bool val) { _inConfig = val; }
+
+protected:
+  virtual void outputXML(magnet::xml::XmlStream &) const;
+
+  //! \brief Build the grid and every list from the box centres.
+  void buildLists();
+
+  /*! \brief Test if two Verlet boxes, centred at the passed
+      positions, may approach within the interaction range.
+   */
+  bool mayInteract(const Vector &, const Vector &) const;
+
+  /*! \brief Collects (in ascending order) the particles whose boxes
+      may interact with the box of particle ID.
+   */
+  void findNeighbours(size_t ID, std::vector<size_t> &) const;
+
+  std::array<size_t, 3> getGridCoords(Vector) const;
+
+  void getGridNeighbours(const std::array<size_t, 3> &,
+                         std::vector<size_t> &) const;
+
+  void gridInsert(size_t ID);
+  void gridRemove(size_t ID);
+
+  double _skin;
+  bool _inConfig;
+  size_t _rebuilds;
+
+  //! \brief The centre of each particle's Verlet box.
+  std::vector<Vector> _origins;
+
+  //! \brief The sorted Verlet list of each particle.
+  std::vector<std::vector<size_t>> _neighbours;
+
+  typedef magnet::containers::RowMajorOrdering<3> Ordering;
+  Ordering _ordering;
+  Vector _gridWidth;
+  std::vector<std::vector<size_t>> _gridContents;
+  std::vector<size_t> _gridCell;
+};
+} // namespace dynamo
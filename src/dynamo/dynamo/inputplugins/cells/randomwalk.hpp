@@ -16,8 +16,11 @@
 */
 
 #pragma once
+#include <array>
+#include <cmath>
 #include <dynamo/inputplugins/cells/cell.hpp>
 #include <random>
+#include <unordered_map>
 
 namespace dynamo {
 struct CURandWalk : public UCell {
@@ -42,8 +45,50 @@ struct CURandWalk : public UCell {
     return tmpVec;
   }
 
+  typedef std::array<long, 3> CellCoords;
+
+  struct CellCoordsHash {
+    size_t operator()(const CellCoords &c) const {
+      return (size_t(c[0]) * 73856093) ^ (size_t(c[1]) * 19349663) ^
+             (size_t(c[2]) * 83492791);
+    }
+  };
+
+  CellCoords getCellCoords(const Vector &pos) const {
+    CellCoords retval{{0, 0, 0}};
+    if (diameter > 0)
+      for (size_t iDim = 0; iDim < NDIM; ++iDim)
+        retval[iDim] = long(std::floor(pos[iDim] / diameter));
+    return retval;
+  }
+
+  /*! \brief Tests if the site is within a diameter of any site
+      stored in the (sparse) grid of cells.
+
+      The cells are a diameter wide, so only the surrounding 27
+      cells need to be tested, instead of the entire chain.
+   */
+  bool overlaps(const Vector &pos,
+                const std::unordered_map<CellCoords, std::vector<size_t>,
+                                         CellCoordsHash> &grid,
+                const std::vector<Vector> &localsites) const {
+    const CellCoords c = getCellCoords(pos);
+    CellCoords n;
+    for (n[2] = c[2] - 1; n[2] <= c[2] + 1; ++n[2])
+      for (n[1] = c[1] - 1; n[1] <= c[1] + 1; ++n[1])
+        for (n[0] = c[0] - 1; n[0] <= c[0] + 1; ++n[0]) {
+          const auto it = grid.find(n);
+          if (it != grid.end())
+            for (const size_t id : it->second)
+              if ((localsites[id] - pos).nrm() <= diameter)
+                return true;
+        }
+    return false;
+  }
+
   virtual std::vector<Vector> placeObjects(const Vector &centre) {
     std::vector<Vector> localsites;
+    std::unordered_map<CellCoords, std::vector<size_t>, CellCoordsHash> grid;
 
     Vector start{0, 0, 0}, tmp{0, 0, 0};
 
@@ -60,11 +105,10 @@ struct CURandWalk : public UCell {
           tmp = start + tmp2 * walklength;
         }
 
-        for (const Vector &vec : localsites)
-          if ((vec - tmp).nrm() <= diameter)
-            test = true;
+        test = overlaps(tmp, grid, localsites);
       }
 
+      grid[getCellCoords(start)].push_back(localsites.size());
       localsites.push_back(start);
 
       start = tmp;
@@ -109,6 +109,44 @@ po::options_description IPPacker::getOptions() {
   return retval;
 }
 
+po::options_description IPPacker::getHiddenOptions() {
+  po::options_description retval;
+
+  retval.add_options()("b1", "boolean option one.")(
+      "b2", "boolean option two.")("i1", po::value<size_t>(),
+                                   "integer option one.")(
+      "i2", po::value<size_t>(), "integer option two.")(
+      "i3", po::value<size_t>(), "integer option three.")(
+      "i4", po::value<size_t>(), "integer option four.")(
+      "s1", po::value<std::string>(), "string option one.")(
+      "s2", po::value<std::string>(),
+      "string option two.")("f1", po::value<double>(), "double option one.")(
+      "f2", po::value<double>(), "double option two.")(
+      "f3", po::value<double>(), "double option three.")(
+      "f4", po::value<double>(), "double option four.")(
+      "f5", po::value<double>(),
+      "double option five.")("f6", po::value<double>(), "double option six.")(
+      "f7", po::value<double>(), "double option seven.")(
+      "f8", po::value<double>(), "double option eight.")(
+      "f9", po::value<double>(), "double option nine.")(
+      "f10", po::value<double>(), "double option ten.")(
+      "NCells,C", po::value<unsigned long>()->default_value(7),
+      "Default number of unit cells per dimension, used for crystal packing "
+      "of particles.")("xcell,x", po::value<unsigned long>(),
+                       "Number of unit cells in the x dimension.")(
+      "ycell,y", po::value<unsigned long>(),
+      "Number of unit cells in the y dimension.")(
+      "zcell,z", po::value<unsigned long>(),
+      "Number of unit cells in the z dimension.")(
+      "rectangular-box",
+      "Force the simulation box to be deformed so "
+      "that the x,y,z cells also specify the box aspect ratio.")(
+      "density,d", po::value<double>()->default_value(0.5),
+      "System number density.");
+
+  return retval;
+}
+
 void IPPacker::initialise() {
   std::string defaultOptionText =
       " Options\n"
@@ -121,7 +159,7 @@ void IPPacker::initialise() {
       "so that the x,y,z cells also specify the simulation aspect ratio.\n"
       "  -d [ --density ] arg (=0.5) System density.\n"
       "  --i1 arg (=FCC)             Lattice type (0=FCC, 1=BCC, 2=SC, "
-      "3=HCP)\n";
+      "3=HCP, 4=Random spheres)\n";
 
   switch (vm["pack-mode"].as<size_t>()) {
   case 0: {
@@ -978,7 +1016,7 @@ void IPPacker::initialise() {
     // Pack of lines
     // Pack the system, determine the number of particles
     CURandom packroutine(vm["NCells"].as<unsigned long>(), Vector{1, 1, 1},
-                         new UParticle());
+                         new UParticle(), Sim->ranGenerator());
 
     packroutine.initialise();
 
@@ -1283,7 +1321,7 @@ void IPPacker::initialise() {
     }
     // Pack the system, determine the number of particles
     CURandom packroutine(vm["NCells"].as<unsigned long>(), Vector{1, 1, 1},
-                         new UParticle());
+                         new UParticle(), Sim->ranGenerator());
     packroutine.initialise();
     std::vector<Vector> latticeSites(packroutine.placeObjects(Vector{0, 0, 0}));
     Sim->BCs = shared_ptr<BoundaryCondition>(new BCLeesEdwards(Sim));
@@ -3385,6 +3423,24 @@ UCell *IPPacker::standardPackingHelper(UCell *tmpPtr, bool forceRectangular) {
       sysPack = new CUHCP(getCells(), boxDimensions, tmpPtr);
       break;
     }
+    case 4: {
+      // Random sequential addition of one particle per cell, at a
+      // diameter consistent with the requested density. Only single
+      // particles are packed, as the exclusion diameter says nothing
+      // about the extent of a molecule or chain.
+      if (!dynamic_cast<UParticle *>(tmpPtr))
+        M_throw() << "Random packing (--i1 4) is only available for single "
+                     "particle unit cells";
+      const std::array<long, 3> cells = getCells();
+      const size_t N = cells[0] * cells[1] * cells[2];
+      const double volume =
+          boxDimensions[0] * boxDimensions[1] * boxDimensions[2];
+      sysPack = new CURandom(
+          N, boxDimensions, tmpPtr, Sim->ranGenerator(),
+          std::cbrt(volume * vm["density"].as<double>() / N),
+          Sim->threadCount);
+      break;
+    }
     default:
       M_throw() << "Not a valid packing type (--i1)";
     }
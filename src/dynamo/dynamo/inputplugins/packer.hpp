@@ -36,6 +36,12 @@ public:
 
   static po::options_description getOptions();
 
+  /*! \brief The generic options used by the packer modes (e.g.,
+      the density and unit cell counts), which are hidden from the
+      help text of dynamod.
+   */
+  static po::options_description getHiddenOptions();
+
 protected:
   std::array<long, 3> getCells();
   Vector getNormalisedCellDimensions();
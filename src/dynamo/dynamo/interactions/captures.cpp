@@ -19,6 +19,9 @@
 #include <dynamo/particle.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/simulation.hpp>
+#include <algorithm>
+#include <magnet/string/base64.hpp>
+#include <magnet/thread/parallel_for.hpp>
 #include <magnet/xmlreader.hpp>
 #include <magnet/xmlwriter.hpp>
 
@@ -29,15 +32,37 @@ void ICapture::initCaptureMap() {
     _mapUninitialised = false;
     clear();
 
-    for (const auto &p1 : Sim->particles) {
-      std::unique_ptr<IDRange> ids(Sim->scheduler->getParticleNeighbours(p1));
-      for (size_t ID2 : *ids)
-        if (ID2 != p1.getID()) {
-          if (Sim->getInteraction(p1, Sim->particles[ID2]).get() ==
-              static_cast<const Interaction *>(this))
-            testAddToCaptureMap(p1, Sim->particles[ID2]);
-        }
-    }
+    typedef std::vector<std::pair<Map::key_type, size_t>> PairList;
+    const size_t nthreads =
+        isThreadSafe() ? std::max<size_t>(Sim->threadCount, 1) : 1;
+    std::vector<PairList> captured(nthreads);
+
+    // Each pair is only tested once (ID2 > ID1) as the neighbour
+    // lists are symmetric.
+    magnet::thread::parallel_for(
+        0, Sim->N(), nthreads, [&](size_t block, size_t begin, size_t end) {
+          PairList &list = captured[block];
+          for (size_t ID1 = begin; ID1 < end; ++ID1) {
+            const Particle &p1 = Sim->particles[ID1];
+            std::unique_ptr<IDRange> ids(
+                Sim->scheduler->getParticleNeighbours(p1));
+            for (size_t ID2 : *ids)
+              if (ID2 > ID1) {
+                const Particle &p2 = Sim->particles[ID2];
+                if (Sim->getInteraction(p1, p2).get() ==
+                    static_cast<const Interaction *>(this)) {
+                  const size_t capval = captureTest(p1, p2);
+                  if (capval)
+                    list.push_back(
+                        std::make_pair(Map::key_type(ID1, ID2), capval));
+                }
+              }
+          }
+        });
+
+    for (const PairList &list : captured)
+      for (const auto &entry : list)
+        Map::operator[](entry.first) = entry.second;
   }
 }
 
@@ -47,31 +72,89 @@ void ICapture::testAddToCaptureMap(const Particle &p1, const size_t &p2) {
     Map::operator[](Map::key_type(p1.getID(), p2)) = capval;
 }
 
+namespace {
+/*! \brief The size in bytes of a single record of the binary
+    CaptureMap format.
+
+  Each record is the 64 bit PairKey (the lower ID in the low 32
+  bits) followed by the 64 bit captured value, both stored little
+  endian. Records are sorted by key, so identical maps always
+  produce identical output.
+ */
+const size_t captureRecordSize = 16;
+
+void writeLE64(uint8_t *out, uint64_t val) {
+  for (size_t i(0); i < 8; ++i)
+    out[i] = uint8_t(val >> (8 * i));
+}
+
+uint64_t readLE64(const uint8_t *in) {
+  uint64_t val(0);
+  for (size_t i(0); i < 8; ++i)
+    val |= uint64_t(in[i]) << (8 * i);
+  return val;
+}
+} // namespace
+
 void ICapture::loadCaptureMap(const magnet::xml::Node &XML) {
   if (XML.hasNode("CaptureMap")) {
     _mapUninitialised = false;
     clear();
 
-    for (magnet::xml::Node node = XML.getNode("CaptureMap").findNode("Pair");
-         node.valid(); ++node)
-      Map::operator[](Map::key_type(node.getAttribute("ID1").as<size_t>(),
-                                    node.getAttribute("ID2").as<size_t>())) =
-          node.getAttribute("val").as<size_t>();
+    const magnet::xml::Node mapNode = XML.getNode("CaptureMap");
+    if (mapNode.hasAttribute("Format") &&
+        !mapNode.getAttribute("Format").getValue().compare("Binary")) {
+      const std::vector<uint8_t> data =
+          magnet::string::base64_decode(mapNode.getValue());
+      const size_t entries = mapNode.getAttribute("Entries").as<size_t>();
+
+      if (data.size() != entries * captureRecordSize)
+        M_throw() << "Binary CaptureMap of the \"" << intName
+                  << "\" interaction is corrupt, expected " << entries
+                  << " entries but found " << data.size() << " bytes of data";
+
+      for (size_t i(0); i < entries; ++i) {
+        const uint8_t *record = data.data() + i * captureRecordSize;
+        const uint64_t key = readLE64(record);
+        const size_t ID1 = uint32_t(key), ID2 = key >> 32;
+        if ((ID1 >= ID2) || (ID2 >= Sim->N()))
+          M_throw() << "Binary CaptureMap of the \"" << intName
+                    << "\" interaction has an invalid pair (" << ID1 << ","
+                    << ID2 << ")";
+        Map::operator[](Map::key_type(ID1, ID2)) = readLE64(record + 8);
+      }
+    } else
+      for (magnet::xml::Node node = mapNode.findNode("Pair"); node.valid();
+           ++node)
+        Map::operator[](Map::key_type(node.getAttribute("ID1").as<size_t>(),
+                                      node.getAttribute("ID2").as<size_t>())) =
+            node.getAttribute("val").as<size_t>();
   }
 }
 
 void ICapture::outputCaptureMap(magnet::xml::XmlStream &XML) const {
   if (_mapUninitialised)
     return;
-  XML << magnet::xml::tag("CaptureMap");
 
+  std::vector<std::pair<uint64_t, size_t>> entries;
+  entries.reserve(Map::size());
   for (const Map::value_type &IDs : *this)
-    XML << magnet::xml::tag("Pair") << magnet::xml::attr("ID1")
-        << IDs.first.first << magnet::xml::attr("ID2") << IDs.first.second
-        << magnet::xml::attr("val") << IDs.second
-        << magnet::xml::endtag("Pair");
+    entries.push_back(std::make_pair(uint64_t(IDs.first.first) |
+                                         (uint64_t(IDs.first.second) << 32),
+                                     IDs.second));
+  std::sort(entries.begin(), entries.end());
+
+  std::vector<uint8_t> data(entries.size() * captureRecordSize);
+  for (size_t i(0); i < entries.size(); ++i) {
+    writeLE64(data.data() + i * captureRecordSize, entries[i].first);
+    writeLE64(data.data() + i * captureRecordSize + 8, entries[i].second);
+  }
 
-  XML << magnet::xml::endtag("CaptureMap");
+  XML << magnet::xml::tag("CaptureMap") << magnet::xml::attr("Format")
+      << "Binary" << magnet::xml::attr("Entries") << entries.size()
+      << magnet::xml::chardata()
+      << magnet::string::base64_encode(data.data(), data.size()) << "\n"
+      << magnet::xml::endtag("CaptureMap");
 }
 
 size_t ICapture::validateState(bool textoutput, size_t max_reports) const {
@@ -194,6 +194,15 @@ public:
    */
   void forgetMap() { _mapUninitialised = true; }
 
+  /*! \brief Builds the capture map from the current particle
+      configuration, if it has not already been loaded.
+
+      The particles are split into contiguous ranges, one per
+      thread (see Simulation::threadCount), each of which collects
+      its captured pairs locally before they are merged into the
+      map. The map is built serially if the Interaction is not
+      thread-safe (see Interaction::isThreadSafe()).
+   */
   void initCaptureMap();
 
   virtual size_t captureTest(const Particle &, const Particle &) const = 0;
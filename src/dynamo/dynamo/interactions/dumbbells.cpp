@@ -29,6 +29,7 @@
 #include <magnet/intersection/offcentre_spheres.hpp>
 #include <magnet/xmlreader.hpp>
 #include <magnet/xmlwriter.hpp>
+#include <algorithm>
 
 namespace dynamo {
 IDumbbells::IDumbbells(const magnet::xml::Node &XML, dynamo::Simulation *tmp)
@@ -155,40 +156,55 @@ Event IDumbbells::getEvent(const Particle &p1, const Particle &p2) const {
   if (t_max == std::numeric_limits<float>::infinity())
     current.second = 1.0;
 
-  for (auto it1 = _compositeData.begin(); it1 != _compositeData.end(); ++it1)
-    for (auto it2 = _compositeData.begin(); it2 != _compositeData.end();
-         ++it2) {
-      const double t_max_current = std::min(t_max, current.second);
-      const Vector u1 =
-          Sim->dynamics->getRotData(p1).orientation * it1->_offset;
-      const Vector u2 =
-          Sim->dynamics->getRotData(p2).orientation * it2->_offset;
-      const double Diam1 = it1->_diam->getProperty(p1);
-      const double Diam2 = it2->_diam->getProperty(p2);
-
-      // const double max_growth_factor = 1 + std::max(growthrate *
-      // Sim->systemTime, growthrate * (Sim->systemTime + t_max_current)); dout
-      // << "max_dist=" << max_dist << std::endl; dout << "max_growth_factor="
-      // << max_growth_factor <<std::endl; dout << "r12=" << r12.toString()
-      // <<std::endl; dout << "v12=" << v12.toString() <<std::endl; dout <<
-      // "angv1=" << angv1.toString() <<std::endl; dout << "angv2=" <<
-      // angv2.toString() <<std::endl; dout << "u1=" << Vector(director1 *
-      // L1).toString() << std::endl; dout << "u2=" << Vector(director2 *
-      // L2).toString() << std::endl; dout << "Diam1=" << Diam1 << std::endl;
-      // dout << "Diam2=" << Diam1 << std::endl;
-      // dout << "max_dist_eff=" << max_dist * max_growth_factor << std::endl;
-      // dout << "t=" << Sim->systemTime << std::endl;
-      // dout << "growthrate=" << growthrate << std::endl;
-      // dout << "tmin=" << 0 << std::endl;
-      // dout << "tmax=" << t_max_current << std::endl;
-      magnet::intersection::detail::OffcentreSpheresOverlapFunction f(
-          r12, v12, angv1, angv2, u1, u2, Diam1, Diam2, max_dist,
-          Sim->systemTime, growthrate, 0, t_max_current);
-
-      std::pair<bool, double> test = f.nextEvent();
-      if (test.second < current.second)
-        current = test;
+  // The rotated offsets and diameters of the spheres
+  std::vector<std::pair<Vector, double>> spheres1, spheres2;
+  for (const Sphere &sphere : _compositeData) {
+    spheres1.emplace_back(Sim->dynamics->getRotData(p1).orientation *
+                              sphere._offset,
+                          sphere._diam->getProperty(p1));
+    spheres2.emplace_back(Sim->dynamics->getRotData(p2).orientation *
+                              sphere._offset,
+                          sphere._diam->getProperty(p2));
+  }
+
+  // Find the window in which each pair of spheres could possibly
+  // overlap, pruning pairs which cannot overlap before t_max. The
+  // remaining pairs are searched in order of their earliest possible
+  // overlap, so that events found early narrow (or eliminate) the
+  // search windows of the later pairs.
+  struct Candidate {
+    size_t i1, i2;
+    double t_in, t_out;
+    bool operator<(const Candidate &o) const { return t_in < o.t_in; }
+  };
+  std::vector<Candidate> candidates;
+  const double t_window = std::min(t_max, current.second);
+  for (size_t i1 = 0; i1 < spheres1.size(); ++i1)
+    for (size_t i2 = 0; i2 < spheres2.size(); ++i2) {
+      const auto window = magnet::intersection::offcentre_spheres_window(
+          r12, v12, spheres1[i1].first, spheres2[i2].first,
+          spheres1[i1].second, spheres2[i2].second, Sim->systemTime,
+          growthrate, 0, t_window);
+      if (window.first <= window.second)
+        candidates.push_back(Candidate{i1, i2, window.first, window.second});
     }
+  std::sort(candidates.begin(), candidates.end());
+
+  for (const Candidate &candidate : candidates) {
+    const double t_max_current = std::min(t_max, current.second);
+    if (candidate.t_in >= t_max_current)
+      break;
+
+    magnet::intersection::detail::OffcentreSpheresOverlapFunction f(
+        r12, v12, angv1, angv2, spheres1[candidate.i1].first,
+        spheres2[candidate.i2].first, spheres1[candidate.i1].second,
+        spheres2[candidate.i2].second, max_dist, Sim->systemTime, growthrate,
+        candidate.t_in, std::min(t_max_current, candidate.t_out));
+
+    std::pair<bool, double> test = f.nextEvent();
+    if (test.second < current.second)
+      current = test;
+  }
 
   // Check if they miss each other
   if (current.second == std::numeric_limits<float>::infinity())
@@ -37,6 +37,12 @@ IHardSphere::IHardSphere(const magnet::xml::Node &XML, dynamo::Simulation *tmp)
 void IHardSphere::initialise(size_t nID) {
   Interaction::initialise(nID);
 
+  _diameterColumn = _diameter->getColumn(Sim->N());
+  if (_e)
+    _eColumn = _e->getColumn(Sim->N());
+  if (_et)
+    _etColumn = _et->getColumn(Sim->N());
+
   if (_et && !Sim->dynamics->hasOrientationData())
     M_throw()
         << "Interaction'" << getName()
@@ -66,6 +72,11 @@ std::array<double, 4> IHardSphere::getGlyphSize(size_t ID) const {
 
 double IHardSphere::maxIntDist() const { return _diameter->getMaxValue(); }
 
+double IHardSphere::getInteractionRadius(size_t ID) const {
+  // The pair diameter is the mean of the particle diameters
+  return 0.5 * _diameter->getProperty(ID);
+}
+
 double IHardSphere::getExcludedVolume(size_t ID) const {
   const double diam = _diameter->getProperty(ID);
   return diam * diam * diam * M_PI / 6.0;
@@ -85,9 +96,13 @@ Event IHardSphere::getEvent(const Particle &p1, const Particle &p2) const {
 
   if (p1 == p2)
     M_throw() << "You shouldn't pass p1==p2 events to the interactions!";
+
+  if (!_diameterColumn.valid())
+    M_throw() << "Interaction \"" << getName()
+              << "\" used before it was initialised";
 #endif
 
-  const double d = _diameter->getProperty(p1, p2);
+  const double d = _diameterColumn(p1, p2);
   const double dt = Sim->dynamics->SphereSphereInRoot(p1, p2, d);
 
   if (dt != std::numeric_limits<float>::infinity())
@@ -100,18 +115,18 @@ Event IHardSphere::getEvent(const Particle &p1, const Particle &p2) const {
 PairEventData IHardSphere::runEvent(Particle &p1, Particle &p2, Event iEvent) {
   ++Sim->eventCount;
 
-  const double d1 = _diameter->getProperty(p1);
-  const double d2 = _diameter->getProperty(p2);
-  const double d = _diameter->getProperty(p1, p2);
+  const double d1 = _diameterColumn[p1];
+  const double d2 = _diameterColumn[p2];
+  const double d = _diameterColumn(p1, p2);
 
   double e = 1.0;
   if (_e)
-    e = _e->getProperty(p1, p2);
+    e = _eColumn(p1, p2);
 
   PairEventData EDat;
   if (_et)
-    return Sim->dynamics->RoughSpheresColl(iEvent, e, _et->getProperty(p1, p2),
-                                           d1, d2);
+    return Sim->dynamics->RoughSpheresColl(iEvent, e, _etColumn(p1, p2), d1,
+                                           d2);
   else
     return Sim->dynamics->SmoothSpheresColl(iEvent, e, d * d);
 }
@@ -71,6 +71,8 @@ public:
 
   virtual double maxIntDist() const;
 
+  virtual double getInteractionRadius(size_t) const;
+
   virtual double getExcludedVolume(size_t) const;
 
   virtual void rescaleLengths(double) {}
@@ -90,5 +92,10 @@ protected:
   shared_ptr<Property> _diameter;
   shared_ptr<Property> _e;
   shared_ptr<Property> _et;
+
+  //! The resolved properties, used by getEvent() and runEvent().
+  PropertyColumn _diameterColumn;
+  PropertyColumn _eColumn;
+  PropertyColumn _etColumn;
 };
 } // namespace dynamo
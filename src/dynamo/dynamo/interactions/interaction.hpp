@@ -90,6 +90,19 @@ public:
   */
   virtual double maxIntDist() const = 0;
 
+  /*! \brief Return the interaction radius of a particle, such that
+      two particles may only interact within the sum of their radii
+      using this Interaction.
+
+    This is used by neighbour lists which adapt to the size of each
+    particle (see GMultiLevelCells). The default of half the
+    maxIntDist() is always valid, but gives every particle the
+    largest size.
+  */
+  virtual double getInteractionRadius(size_t) const {
+    return 0.5 * maxIntDist();
+  }
+
   /*! \brief Returns the internal energy "stored" in this interaction.
    */
   virtual double getInternalEnergy() const { return 0; }
@@ -178,6 +191,19 @@ public:
     return 0;
   }
 
+  /*! \brief Returns true if the const members of the Interaction
+      (e.g., captureTest() and validateState()) may be called
+      concurrently from several threads.
+
+      Interactions with lazily evaluated (mutable) state should
+      override this and return false, in which case any diagnostics
+      or initialisation involving them is performed serially. This
+      covers the capture map construction of ICapture, which had its
+      own isCaptureTestThreadSafe() hook before the pair diagnostics
+      were parallelised.
+   */
+  virtual bool isThreadSafe() const { return true; }
+
   /*! \brief Return the ID number of the Interaction. Used for fast
    look-ups, once a name-based look up has been completed.
   */
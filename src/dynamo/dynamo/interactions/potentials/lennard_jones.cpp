@@ -88,8 +88,7 @@ PotentialLennardJones::PotentialLennardJones(double sigma, double epsilon,
 }
 
 void PotentialLennardJones::operator<<(const magnet::xml::Node &XML) {
-  _r_cache.clear();
-  _u_cache.clear();
+  clearCache();
 
   _sigma = XML.getAttribute("Sigma").as<double>();
   _epsilon = XML.getAttribute("Epsilon").as<double>();
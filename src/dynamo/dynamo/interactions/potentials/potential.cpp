@@ -31,6 +31,44 @@ shared_ptr<Potential> Potential::getClass(const magnet::xml::Node &XML) {
               << ", Unknown type of Potential encountered";
 }
 
+const Potential::StepTable Potential::_emptyTable;
+
+const Potential::StepTable *Potential::extendTable(size_t step_id) const {
+  std::lock_guard<std::mutex> lock(_cacheMutex);
+  const StepTable *table = _table.load(std::memory_order_relaxed);
+  if (step_id < table->size())
+    return table;
+
+  // Grow geometrically, so the total copying is linear in the
+  // number of steps calculated
+  const size_t target = std::min(
+      steps(), std::max({step_id + 1, 2 * table->size(), size_t(16)}));
+  if (target > std::min(_r_cache.size(), _u_cache.size()))
+    calculateToStep(target - 1);
+
+  std::unique_ptr<StepTable> newTable(new StepTable);
+  const size_t N = std::min(_r_cache.size(), _u_cache.size());
+  newTable->r.assign(_r_cache.begin(), _r_cache.begin() + N);
+  newTable->u.assign(_u_cache.begin(), _u_cache.begin() + N);
+  newTable->key.resize(N);
+  const double sign = direction() ? 1 : -1;
+  for (size_t i(0); i < N; ++i)
+    newTable->key[i] = sign * _r_cache[i] * _r_cache[i];
+
+  table = newTable.get();
+  _tables.push_back(std::move(newTable));
+  _table.store(table, std::memory_order_release);
+  return table;
+}
+
+void Potential::clearCache() {
+  std::lock_guard<std::mutex> lock(_cacheMutex);
+  _r_cache.clear();
+  _u_cache.clear();
+  _table.store(&_emptyTable, std::memory_order_release);
+  _tables.clear();
+}
+
 magnet::xml::XmlStream &operator<<(magnet::xml::XmlStream &XML,
                                    const Potential &g) {
   XML << magnet::xml::tag("Potential");
@@ -42,11 +80,17 @@ magnet::xml::XmlStream &operator<<(magnet::xml::XmlStream &XML,
 PotentialStepped::PotentialStepped(std::vector<std::pair<double, double>> steps,
                                    bool direction)
     : _direction(direction) {
-  if (direction)
+  setSteps(steps);
+}
+
+void PotentialStepped::setSteps(
+    std::vector<std::pair<double, double>> steps) {
+  if (_direction)
     std::sort(steps.begin(), steps.end());
   else
     std::sort(steps.rbegin(), steps.rend());
 
+  clearCache();
   for (size_t i(0); i < steps.size(); ++i) {
     _r_cache.push_back(steps[i].first);
     _u_cache.push_back(steps[i].second);
@@ -88,6 +132,6 @@ void PotentialStepped::operator<<(const magnet::xml::Node &XML) {
         << "You cannot load a stepped potential with no steps.\nXML path: "
         << XML.getPath();
 
-  *this = PotentialStepped(steps, _direction);
+  setSteps(steps);
 }
 } // namespace dynamo
@@ -17,8 +17,11 @@
 
 #pragma once
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <dynamo/base.hpp>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace magnet {
@@ -48,14 +51,25 @@ namespace dynamo {
 
   This class also implements a cache, to allow fast lookup of previously
   accessed steps, as some calculated potentials are expensive to
-  compute.
+  compute. The cached steps are published as immutable tables (see
+  StepTable), which also hold the squared step radii for a
+  branch-free lookup of the step ID in calculateStepID(). The
+  tables are extended under a lock and never modified once
+  published, so one Potential may be shared between Simulation's
+  running on different threads (e.g., replicas). Reloading the
+  Potential from XML is not thread safe.
  */
 class Potential {
 public:
   typedef std::pair<double, double> value_type;
 
+  Potential() : _table(&_emptyTable) {}
+
   virtual ~Potential() {}
 
+  Potential(const Potential &) = delete;
+  Potential &operator=(const Potential &) = delete;
+
   /*! \brief Accessor to give a value_type containing the
       discontinuity location and energy change.
 
@@ -69,10 +83,8 @@ public:
       M_throw() << "Out of range access";
 #endif
 
-    if (step_id >= cached_steps())
-      calculateToStep(step_id);
-
-    return value_type(_r_cache[step_id], _u_cache[step_id]);
+    const StepTable *table = getTable(step_id);
+    return value_type(table->r[step_id], table->u[step_id]);
   }
 
   /*!\brief Return the maximum number of steps in the potential.
@@ -93,7 +105,7 @@ public:
     calculated and cached.
   */
   std::size_t cached_steps() const {
-    return std::min(_r_cache.size(), _u_cache.size());
+    return _table.load(std::memory_order_acquire)->size();
   }
 
   static shared_ptr<Potential> getClass(const magnet::xml::Node &);
@@ -113,14 +125,26 @@ public:
       corresponds to.
   */
   size_t calculateStepID(const double r) const {
-    size_t retval(0);
-    if (direction())
-      for (; (retval < steps()) && (r > operator[](retval).first); ++retval) {
-      }
-    else
-      for (; (retval < steps()) && (r < operator[](retval).first); ++retval) {
-      }
-    return retval;
+    return calculateStepIDSq(r * r);
+  }
+
+  /*! \brief Determine which step in the potential the passed
+      squared radius corresponds to.
+
+      This avoids the square root of a separation when searching for
+      a step.
+  */
+  size_t calculateStepIDSq(const double r2) const {
+    const double key = direction() ? r2 : -r2;
+    const StepTable *table = _table.load(std::memory_order_acquire);
+    while (true) {
+      const size_t retval = table->countBelow(key);
+      // The step is only certain if a discontinuity beyond the
+      // radius is cached, or every step has been calculated.
+      if ((retval < table->size()) || (table->size() >= steps()))
+        return retval;
+      table = getTable(table->size());
+    }
   }
 
   /*! \brief Return a pair with the min-max bounds of the potential
@@ -228,11 +252,73 @@ public:
   virtual bool direction() const = 0;
 
 protected:
+  /*! \brief An immutable snapshot of the cached steps.
+
+    The step keys are the squared radii of the discontinuities, which
+    are negated if the step radii decrease with the step ID, so that
+    the keys always increase with the step ID.
+   */
+  struct StepTable {
+    std::vector<double> r;
+    std::vector<double> u;
+    std::vector<double> key;
+
+    size_t size() const { return key.size(); }
+
+    /*! \brief Return the number of keys below the passed value,
+        using a branch-free binary search.
+     */
+    size_t countBelow(const double val) const {
+      if (key.empty())
+        return 0;
+      const double *base = key.data();
+      size_t n = key.size();
+      while (n > 1) {
+        const size_t half = n / 2;
+        base = (base[half] < val) ? base + half : base;
+        n -= half;
+      }
+      return (base - key.data()) + (*base < val);
+    }
+  };
+
+  /*! \brief Return a table holding at least the passed step ID,
+      calculating and publishing new steps if required.
+   */
+  const StepTable *getTable(const size_t step_id) const {
+    const StepTable *table = _table.load(std::memory_order_acquire);
+    if (step_id < table->size())
+      return table;
+    return extendTable(step_id);
+  }
+
+  /*! \brief Calculate steps up to (at least) the passed step ID and
+      publish them in a new StepTable.
+   */
+  const StepTable *extendTable(size_t step_id) const;
+
+  /*! \brief Discard all cached steps and tables.
+
+    This must be called by a derived class whenever it is reloaded,
+    before it refills _r_cache and _u_cache.
+  */
+  void clearCache();
+
   virtual void calculateToStep(size_t) const = 0;
   virtual void outputXML(magnet::xml::XmlStream &) const = 0;
 
+  /*! \brief The working step cache, only modified by
+      calculateToStep() while _cacheMutex is held.
+   */
   mutable std::vector<double> _r_cache;
   mutable std::vector<double> _u_cache;
+
+private:
+  static const StepTable _emptyTable;
+  mutable std::atomic<const StepTable *> _table;
+  //! \brief Every table published, kept alive for concurrent readers.
+  mutable std::vector<std::unique_ptr<const StepTable>> _tables;
+  mutable std::mutex _cacheMutex;
 };
 
 /*! \brief A manually stepped potential.
@@ -286,6 +372,9 @@ public:
 protected:
   bool _direction;
 
+  //! \brief Sort and store the passed (position, energy) steps.
+  void setSteps(std::vector<std::pair<double, double>> steps);
+
   virtual void calculateToStep(size_t) const {
     M_throw() << "Cannot calculate new steps for this potential!";
   }
@@ -69,8 +69,18 @@ double ISquareWell::maxIntDist() const {
   return _diameter->getMaxValue() * _lambda->getMaxValue();
 }
 
+double ISquareWell::getInteractionRadius(size_t ID) const {
+  // The pair diameter is the mean of the particle diameters, but the
+  // pair lambda may be larger than that of either particle
+  return 0.5 * _diameter->getProperty(ID) * _lambda->getMaxValue();
+}
+
 void ISquareWell::initialise(size_t nID) {
   Interaction::initialise(nID);
+  _diameterColumn = _diameter->getColumn(Sim->N());
+  _lambdaColumn = _lambda->getColumn(Sim->N());
+  _wellDepthColumn = _wellDepth->getColumn(Sim->N());
+  _eColumn = _e->getColumn(Sim->N());
   ICapture::initCaptureMap();
 }
 
@@ -102,10 +112,14 @@ Event ISquareWell::getEvent(const Particle &p1, const Particle &p2) const {
 
   if (p1 == p2)
     M_throw() << "You shouldn't pass p1==p2 events to the interactions!";
+
+  if (!_diameterColumn.valid())
+    M_throw() << "Interaction \"" << getName()
+              << "\" used before it was initialised";
 #endif
 
-  const double d = _diameter->getProperty(p1, p2);
-  const double l = _lambda->getProperty(p1, p2);
+  const double d = _diameterColumn(p1, p2);
+  const double l = _lambdaColumn(p1, p2);
 
   Event retval(p1, std::numeric_limits<float>::infinity(), INTERACTION, NONE,
                ID, p2);
@@ -131,12 +145,12 @@ Event ISquareWell::getEvent(const Particle &p1, const Particle &p2) const {
 PairEventData ISquareWell::runEvent(Particle &p1, Particle &p2, Event iEvent) {
   ++Sim->eventCount;
 
-  const double d = _diameter->getProperty(p1, p2);
+  const double d = _diameterColumn(p1, p2);
   const double d2 = d * d;
-  const double e = _e->getProperty(p1, p2);
-  const double l = _lambda->getProperty(p1, p2);
+  const double e = _eColumn(p1, p2);
+  const double l = _lambdaColumn(p1, p2);
   const double ld2 = d * l * d * l;
-  const double wd = _wellDepth->getProperty(p1, p2);
+  const double wd = _wellDepthColumn(p1, p2);
 
   PairEventData retVal;
   switch (iEvent._type) {
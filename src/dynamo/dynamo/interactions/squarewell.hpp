@@ -45,6 +45,8 @@ public:
 
   virtual double maxIntDist() const;
 
+  virtual double getInteractionRadius(size_t) const;
+
   virtual size_t captureTest(const Particle &, const Particle &) const;
 
   virtual void initialise(size_t);
@@ -69,5 +71,11 @@ protected:
   shared_ptr<Property> _lambda;
   shared_ptr<Property> _wellDepth;
   shared_ptr<Property> _e;
+
+  //! The resolved properties, used by getEvent() and runEvent().
+  PropertyColumn _diameterColumn;
+  PropertyColumn _lambdaColumn;
+  PropertyColumn _wellDepthColumn;
+  PropertyColumn _eColumn;
 };
 } // namespace dynamo
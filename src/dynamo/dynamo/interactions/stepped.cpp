@@ -85,7 +85,8 @@ size_t IStepped::captureTest(const Particle &p1, const Particle &p2) const {
   Vector rij = p1.getPosition() - p2.getPosition();
   Sim->BCs->applyBC(rij);
 
-  return _potential->calculateStepID(rij.nrm() / length_scale);
+  return _potential->calculateStepIDSq(rij.nrm2() /
+                                       (length_scale * length_scale));
 }
 
 double IStepped::getInternalEnergy() const {
@@ -49,6 +49,9 @@ public:
 
   virtual size_t captureTest(const Particle &, const Particle &) const;
 
+  //! The potential lazily extends its step cache, which is not thread-safe.
+  virtual bool isThreadSafe() const { return false; }
+
   virtual void initialise(size_t);
 
   virtual Event getEvent(const Particle &, const Particle &) const;
@@ -63,10 +63,14 @@ Event IThinThread::getEvent(const Particle &p1, const Particle &p2) const {
 
   if (p1 == p2)
     M_throw() << "You shouldn't pass p1==p2 events to the interactions!";
+
+  if (!_diameterColumn.valid())
+    M_throw() << "Interaction \"" << getName()
+              << "\" used before it was initialised";
 #endif
 
-  const double d = _diameter->getProperty(p1, p2);
-  const double l = _lambda->getProperty(p1, p2);
+  const double d = _diameterColumn(p1, p2);
+  const double l = _lambdaColumn(p1, p2);
 
   Event retval(p1, std::numeric_limits<float>::infinity(), INTERACTION, NONE,
                ID, p2);
@@ -92,12 +96,12 @@ Event IThinThread::getEvent(const Particle &p1, const Particle &p2) const {
 PairEventData IThinThread::runEvent(Particle &p1, Particle &p2, Event iEvent) {
   ++Sim->eventCount;
 
-  const double d = _diameter->getProperty(p1, p2);
+  const double d = _diameterColumn(p1, p2);
   const double d2 = d * d;
-  const double e = _e->getProperty(p1, p2);
-  const double l = _lambda->getProperty(p1, p2);
+  const double e = _eColumn(p1, p2);
+  const double l = _lambdaColumn(p1, p2);
   const double ld2 = d * l * d * l;
-  const double wd = _wellDepth->getProperty(p1, p2);
+  const double wd = _wellDepthColumn(p1, p2);
 
   switch (iEvent._type) {
   case CORE: {
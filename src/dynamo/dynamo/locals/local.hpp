@@ -74,6 +74,10 @@ public:
 
   inline const size_t &getID() const { return ID; }
 
+  /*! \brief Returns the IDRange of the particles this Local acts on.
+   */
+  const shared_ptr<IDRange> &getRange() const { return range; }
+
   /* \brief Test if a particle is in a valid state according to this
      local.
 
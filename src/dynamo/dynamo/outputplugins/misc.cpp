@@ -15,8 +15,10 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <ctime>
 #include <dynamo/BC/LEBC.hpp>
+#include <dynamo/checkpoint.hpp>
 #include <dynamo/include.hpp>
 #include <dynamo/outputplugins/misc.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
@@ -24,12 +26,87 @@
 #include <dynamo/systems/tHalt.hpp>
 #include <magnet/memUsage.hpp>
 #include <magnet/xmlwriter.hpp>
+#include <sstream>
 
 namespace dynamo {
-OPMisc::OPMisc(const dynamo::Simulation *tmp, const magnet::xml::Node &)
+OPMisc::OPMisc(const dynamo::Simulation *tmp, const magnet::xml::Node &XML)
     : OutputPlugin(tmp, "Misc", 0), // ContactMap must be after this
       _dualEvents(0), _singleEvents(0), _virtualEvents(0), _reverseEvents(0),
-      _lateInitComplete(false) {}
+      _correlators(ALL_CORRELATORS), _lateInitComplete(false) {
+  // A list of the correlators to collect, separated by spaces or '+'
+  // (e.g., -LMisc:Correlators=Viscosity+ThermalConductivity)
+  if (XML.hasAttribute("Correlators")) {
+    std::string list = XML.getAttribute("Correlators");
+    std::replace(list.begin(), list.end(), '+', ' ');
+    std::istringstream names(list);
+    _correlators = 0;
+    for (std::string name; names >> name;) {
+      if (name == "All")
+        _correlators = ALL_CORRELATORS;
+      else if (name == "None")
+        _correlators = 0;
+      else if (name == "ThermalConductivity")
+        _correlators |= THERMAL_CONDUCTIVITY;
+      else if (name == "Viscosity")
+        _correlators |= VISCOSITY;
+      else if (name == "BulkViscosity")
+        _correlators |= BULK_VISCOSITY;
+      else if (name == "CrossViscosity")
+        _correlators |= CROSS_VISCOSITY;
+      else if (name == "ThermalDiffusion")
+        _correlators |= THERMAL_DIFFUSION;
+      else if (name == "MutualDiffusion")
+        _correlators |= MUTUAL_DIFFUSION;
+      else
+        M_throw() << "Unknown Misc correlator \"" << name
+                  << "\", expected All, None, ThermalConductivity, "
+                     "Viscosity, BulkViscosity, CrossViscosity, "
+                     "ThermalDiffusion or MutualDiffusion";
+    }
+  }
+}
+
+void OPMisc::saveCheckpoint(CheckpointWriter &out) const {
+  // Like a replica exchange, the correlators are not kept and
+  // restart their sampling.
+  out.write<uint64_t>(_counters.size());
+  for (const auto &counter : _counters) {
+    out.write(counter.first.first.first);
+    out.write(counter.first.first.second);
+    out.write(counter.first.second);
+    out.write(counter.second);
+  }
+  out.write(_dualEvents);
+  out.write(_singleEvents);
+  out.write(_virtualEvents);
+  out.write(_reverseEvents);
+  out.write(_KE);
+  out.write(_internalE);
+  out.write(_sysMomentum);
+  out.write(_kineticP);
+  out.write(collisionalP);
+}
+
+void OPMisc::loadCheckpoint(CheckpointReader &in) {
+  _counters.clear();
+  const uint64_t count = in.read<uint64_t>();
+  for (uint64_t i(0); i < count; ++i) {
+    CounterKey key;
+    in.read(key.first.first);
+    in.read(key.first.second);
+    in.read(key.second);
+    in.read(_counters[key]);
+  }
+  in.read(_dualEvents);
+  in.read(_singleEvents);
+  in.read(_virtualEvents);
+  in.read(_reverseEvents);
+  in.read(_KE);
+  in.read(_internalE);
+  in.read(_sysMomentum);
+  in.read(_kineticP);
+  in.read(collisionalP);
+}
 
 void OPMisc::replicaExchange(OutputPlugin &misc2) {
   // We must swap anything that is associated with the sampling
@@ -70,7 +147,21 @@ void OPMisc::replicaExchange(OutputPlugin &misc2) {
 }
 
 void OPMisc::temperatureRescale(const double &scale) {
+  // All velocities were scaled by sqrt(scale), so the kinetic
+  // accumulators can be rescaled directly rather than recalculated.
+  const double velScale = std::sqrt(scale);
   _KE = _KE.current() * scale;
+  _kineticP = _kineticP.current() * scale;
+  _sysMomentum = _sysMomentum.current() * velScale;
+  for (Vector &momentum : _speciesMomenta)
+    momentum *= velScale;
+
+  const Matrix kineticP = _kineticP.current();
+  _viscosity.setFreeStreamValue(kineticP);
+  double isoViscFS(0);
+  for (size_t iDim(0); iDim < NDIM; ++iDim)
+    isoViscFS += kineticP(iDim, iDim);
+  _bulkVisc.setFreeStreamValue(isoViscFS / 3);
 }
 
 double OPMisc::getMeankT() const {
@@ -93,7 +184,7 @@ double OPMisc::getMeanSqrUConfigurational() const {
 
 void outputCorrelator(magnet::xml::XmlStream &XML, const bool i1, const bool i2,
                       const double inv_units, const double time_units,
-                      magnet::math::LogarithmicTimeCorrelator<double> &corr) {
+                      magnet::math::MultiTauTimeCorrelator<double> &corr) {
   std::string t = "CC";
   if (i1)
     t[0] = 'I';
@@ -104,7 +195,7 @@ void outputCorrelator(magnet::xml::XmlStream &XML, const bool i1, const bool i2,
 
   XML << tag("Component") << attr("type") << t << chardata();
   {
-    std::vector<magnet::math::LogarithmicTimeCorrelator<double>::Data> data =
+    std::vector<magnet::math::MultiTauTimeCorrelator<double>::Data> data =
         corr.getAveragedCorrelator(i1, i2);
 
     XML << "0 0 0\n";
@@ -120,7 +211,7 @@ void outputCorrelator(magnet::xml::XmlStream &XML, const bool i1, const bool i2,
 
 void outputCorrelator(magnet::xml::XmlStream &XML, const bool i1, const bool i2,
                       const double inv_units, const double time_units,
-                      magnet::math::LogarithmicTimeCorrelator<Vector> &corr) {
+                      magnet::math::MultiTauTimeCorrelator<Vector> &corr) {
   std::string t = "CC";
   if (i1)
     t[0] = 'I';
@@ -131,7 +222,7 @@ void outputCorrelator(magnet::xml::XmlStream &XML, const bool i1, const bool i2,
   Vector zero({0, 0, 0});
   XML << tag("Component") << attr("type") << t << chardata();
   {
-    std::vector<magnet::math::LogarithmicTimeCorrelator<Vector>::Data> data =
+    std::vector<magnet::math::MultiTauTimeCorrelator<Vector>::Data> data =
         corr.getAveragedCorrelator(i1, i2);
 
     XML << "0 0 0 0 0\n";
@@ -148,7 +239,7 @@ void outputCorrelator(magnet::xml::XmlStream &XML, const bool i1, const bool i2,
 
 void outputCorrelator(magnet::xml::XmlStream &XML, const bool i1, const bool i2,
                       const double inv_units, const double time_units,
-                      magnet::math::LogarithmicTimeCorrelator<Matrix> &corr) {
+                      magnet::math::MultiTauTimeCorrelator<Matrix> &corr) {
   std::string t = "CC";
   if (i1)
     t[0] = 'I';
@@ -160,7 +251,7 @@ void outputCorrelator(magnet::xml::XmlStream &XML, const bool i1, const bool i2,
   XML << tag("Component") << attr("type") << t << chardata();
 
   {
-    std::vector<magnet::math::LogarithmicTimeCorrelator<Matrix>::Data> data =
+    std::vector<magnet::math::MultiTauTimeCorrelator<Matrix>::Data> data =
         corr.getAveragedCorrelator(i1, i2);
 
     XML << "0 0 0 0 0 0 0 0 0 0 0\n";
@@ -180,7 +271,7 @@ void outputCorrelator(magnet::xml::XmlStream &XML, const bool i1, const bool i2,
 template <class T>
 void outputCorrelator(magnet::xml::XmlStream &XML, const double inv_units,
                       const double time_units,
-                      magnet::math::LogarithmicTimeCorrelator<T> &corr,
+                      magnet::math::MultiTauTimeCorrelator<T> &corr,
                       const double time) {
   using namespace magnet::xml;
 
@@ -267,6 +358,7 @@ void OPMisc::initialise() {
   if (correlator_dt == 0.0)
     correlator_dt = 1.0 / sqrt(getCurrentkT());
 
+  _thermalConductivityFS = thermalConductivityFS;
   _thermalConductivity.resize(correlator_dt, 10, 2, false);
   _thermalConductivity.setFreeStreamValue(thermalConductivityFS);
 
@@ -420,69 +512,85 @@ void OPMisc::eventUpdate(const Event &eevent, const NEventData &NDat) {
              Dyadic(PDat.particle2_.getOldVel(), PDat.particle2_.getOldVel()));
 
     const auto visc_imp = magnet::math::Dyadic(PDat.rij, delP);
-    _viscosity.addImpulse(visc_imp);
-
-    double isoVisc_imp(0);
-    for (size_t iDim(0); iDim < NDIM; ++iDim)
-      isoVisc_imp += visc_imp(iDim, iDim);
-    _bulkVisc.addImpulse(isoVisc_imp / 3);
+    if (correlating(VISCOSITY))
+      _viscosity.addImpulse(visc_imp);
+
+    if (correlating(BULK_VISCOSITY)) {
+      double isoVisc_imp(0);
+      for (size_t iDim(0); iDim < NDIM; ++iDim)
+        isoVisc_imp += visc_imp(iDim, iDim);
+      _bulkVisc.addImpulse(isoVisc_imp / 3);
+    }
 
-    Vector crossVisc_imp1({0, 0, 0});
-    Vector crossVisc_imp2({0, 0, 0});
-    for (size_t iDim(0); iDim < NDIM; ++iDim) {
-      crossVisc_imp1[iDim] = visc_imp(iDim, iDim);
-      crossVisc_imp2[iDim] = visc_imp((iDim + 1) % NDIM, (iDim + 1) % NDIM);
+    if (correlating(CROSS_VISCOSITY)) {
+      Vector crossVisc_imp1({0, 0, 0});
+      Vector crossVisc_imp2({0, 0, 0});
+      for (size_t iDim(0); iDim < NDIM; ++iDim) {
+        crossVisc_imp1[iDim] = visc_imp(iDim, iDim);
+        crossVisc_imp2[iDim] = visc_imp((iDim + 1) % NDIM, (iDim + 1) % NDIM);
+      }
+      _crossVisc.addImpulse(crossVisc_imp1, crossVisc_imp2);
     }
-    _crossVisc.addImpulse(crossVisc_imp1, crossVisc_imp2);
 
     _speciesMomenta[sp1.getID()] += delP;
     _speciesMomenta[sp2.getID()] -= delP;
 
     const Vector thermalImpulse = PDat.rij * p1deltaE;
 
-    _thermalConductivity.addImpulse(thermalImpulse);
+    if (correlating(THERMAL_CONDUCTIVITY))
+      _thermalConductivity.addImpulse(thermalImpulse);
 
-    for (size_t spid1(0); spid1 < Sim->species.size(); ++spid1)
-      _thermalDiffusion[spid1].addImpulse(thermalImpulse, Vector{0, 0, 0});
+    if (correlating(THERMAL_DIFFUSION))
+      for (size_t spid1(0); spid1 < Sim->species.size(); ++spid1)
+        _thermalDiffusion[spid1].addImpulse(thermalImpulse, Vector{0, 0, 0});
 
     thermalDel += part1.getVelocity() * p1E + part2.getVelocity() * p2E -
                   PDat.particle1_.getOldVel() * (p1E - p1deltaE) -
                   PDat.particle2_.getOldVel() * (p2E - p2deltaE);
   }
 
-  _thermalConductivity.setFreeStreamValue(
-      _thermalConductivity.getFreeStreamValue() + thermalDel);
+  _thermalConductivityFS += thermalDel;
+  if (correlating(THERMAL_CONDUCTIVITY))
+    _thermalConductivity.setFreeStreamValue(_thermalConductivityFS);
 
   const auto kineticP = _kineticP.current();
 
-  _viscosity.setFreeStreamValue(kineticP);
-
-  double isoViscFS(0);
-  for (size_t iDim(0); iDim < NDIM; ++iDim)
-    isoViscFS += kineticP(iDim, iDim);
-  _bulkVisc.setFreeStreamValue(isoViscFS / 3);
+  if (correlating(VISCOSITY))
+    _viscosity.setFreeStreamValue(kineticP);
 
-  Vector crossViscFS1({0, 0, 0});
-  Vector crossViscFS2({0, 0, 0});
-  for (size_t iDim(0); iDim < NDIM; ++iDim) {
-    crossViscFS1[iDim] = kineticP(iDim, iDim);
-    crossViscFS2[iDim] = kineticP((iDim + 1) % NDIM, (iDim + 1) % NDIM);
+  if (correlating(BULK_VISCOSITY)) {
+    double isoViscFS(0);
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      isoViscFS += kineticP(iDim, iDim);
+    _bulkVisc.setFreeStreamValue(isoViscFS / 3);
   }
-  _crossVisc.setFreeStreamValue(crossViscFS1, crossViscFS2);
 
-  for (size_t spid1(0); spid1 < Sim->species.size(); ++spid1) {
-    _thermalDiffusion[spid1].setFreeStreamValue(
-        _thermalConductivity.getFreeStreamValue(),
-        _speciesMomenta[spid1] -
-            _sysMomentum.current() * (_speciesMasses[spid1] / _systemMass));
+  if (correlating(CROSS_VISCOSITY)) {
+    Vector crossViscFS1({0, 0, 0});
+    Vector crossViscFS2({0, 0, 0});
+    for (size_t iDim(0); iDim < NDIM; ++iDim) {
+      crossViscFS1[iDim] = kineticP(iDim, iDim);
+      crossViscFS2[iDim] = kineticP((iDim + 1) % NDIM, (iDim + 1) % NDIM);
+    }
+    _crossVisc.setFreeStreamValue(crossViscFS1, crossViscFS2);
+  }
 
-    for (size_t spid2(spid1); spid2 < Sim->species.size(); ++spid2)
-      _mutualDiffusion[spid1 * Sim->species.size() + spid2].setFreeStreamValue(
+  if (correlating(THERMAL_DIFFUSION))
+    for (size_t spid1(0); spid1 < Sim->species.size(); ++spid1)
+      _thermalDiffusion[spid1].setFreeStreamValue(
+          _thermalConductivityFS,
           _speciesMomenta[spid1] -
-              (_speciesMasses[spid1] / _systemMass) * _sysMomentum.current(),
-          _speciesMomenta[spid2] -
-              (_speciesMasses[spid2] / _systemMass) * _sysMomentum.current());
-  }
+              _sysMomentum.current() * (_speciesMasses[spid1] / _systemMass));
+
+  if (correlating(MUTUAL_DIFFUSION))
+    for (size_t spid1(0); spid1 < Sim->species.size(); ++spid1)
+      for (size_t spid2(spid1); spid2 < Sim->species.size(); ++spid2)
+        _mutualDiffusion[spid1 * Sim->species.size() + spid2]
+            .setFreeStreamValue(
+                _speciesMomenta[spid1] - (_speciesMasses[spid1] / _systemMass) *
+                                             _sysMomentum.current(),
+                _speciesMomenta[spid2] - (_speciesMasses[spid2] / _systemMass) *
+                                             _sysMomentum.current());
 }
 
 void OPMisc::stream(double dt) {
@@ -491,15 +599,21 @@ void OPMisc::stream(double dt) {
   _internalE.stream(dt);
   _kineticP.stream(dt);
   _sysMomentum.stream(dt);
-  _thermalConductivity.freeStream(dt);
-  _viscosity.freeStream(dt);
-  _bulkVisc.freeStream(dt);
-  _crossVisc.freeStream(dt);
-  for (size_t spid1(0); spid1 < Sim->species.size(); ++spid1) {
-    _thermalDiffusion[spid1].freeStream(dt);
-    for (size_t spid2(spid1); spid2 < Sim->species.size(); ++spid2)
-      _mutualDiffusion[spid1 * Sim->species.size() + spid2].freeStream(dt);
-  }
+  if (correlating(THERMAL_CONDUCTIVITY))
+    _thermalConductivity.freeStream(dt);
+  if (correlating(VISCOSITY))
+    _viscosity.freeStream(dt);
+  if (correlating(BULK_VISCOSITY))
+    _bulkVisc.freeStream(dt);
+  if (correlating(CROSS_VISCOSITY))
+    _crossVisc.freeStream(dt);
+  if (correlating(THERMAL_DIFFUSION))
+    for (auto &correlator : _thermalDiffusion)
+      correlator.freeStream(dt);
+  if (correlating(MUTUAL_DIFFUSION))
+    for (size_t spid1(0); spid1 < Sim->species.size(); ++spid1)
+      for (size_t spid2(spid1); spid2 < Sim->species.size(); ++spid2)
+        _mutualDiffusion[spid1 * Sim->species.size() + spid2].freeStream(dt);
 }
 
 double OPMisc::getMFT() const {
@@ -653,87 +767,85 @@ void OPMisc::output(magnet::xml::XmlStream &XML) {
       << endtag("Memusage");
 
   if (!std::dynamic_pointer_cast<BCLeesEdwards>(Sim->BCs)) {
-    XML << tag("ThermalConductivity") << tag("Correlator");
-
-    {
+    if (correlating(THERMAL_CONDUCTIVITY)) {
       const double inv_units =
           Sim->units.unitk() /
           (Sim->units.unitTime() * Sim->units.unitThermalCond() * 2.0 *
            getMeankT() * getMeankT() * V);
 
+      XML << tag("ThermalConductivity") << tag("Correlator");
       outputCorrelator(XML, inv_units, Sim->units.unitTime(),
                        _thermalConductivity, Sim->systemTime);
+      XML << endtag("Correlator") << endtag("ThermalConductivity");
     }
 
-    XML << endtag("Correlator") << endtag("ThermalConductivity")
-        << tag("Viscosity") << tag("Correlator");
+    const double visc_inv_units =
+        1.0 / (Sim->units.unitTime() * Sim->units.unitViscosity() * 2.0 *
+               getMeankT() * V);
 
-    {
-      const double inv_units =
-          1.0 / (Sim->units.unitTime() * Sim->units.unitViscosity() * 2.0 *
-                 getMeankT() * V);
-      outputCorrelator(XML, inv_units, Sim->units.unitTime(), _viscosity,
+    if (correlating(VISCOSITY)) {
+      XML << tag("Viscosity") << tag("Correlator");
+      outputCorrelator(XML, visc_inv_units, Sim->units.unitTime(), _viscosity,
                        Sim->systemTime);
+      XML << endtag("Correlator") << endtag("Viscosity");
     }
 
-    XML << endtag("Correlator") << endtag("Viscosity") << tag("BulkViscosity")
-        << tag("Correlator");
-
-    {
-      const double inv_units =
-          1.0 / (Sim->units.unitTime() * Sim->units.unitViscosity() * 2.0 *
-                 getMeankT() * V);
-      outputCorrelator(XML, inv_units, Sim->units.unitTime(), _bulkVisc,
+    if (correlating(BULK_VISCOSITY)) {
+      XML << tag("BulkViscosity") << tag("Correlator");
+      outputCorrelator(XML, visc_inv_units, Sim->units.unitTime(), _bulkVisc,
                        Sim->systemTime);
+      XML << endtag("Correlator") << endtag("BulkViscosity");
     }
 
-    XML << endtag("Correlator") << endtag("BulkViscosity")
-        << tag("CrossViscosity") << tag("Correlator");
-
-    {
-      const double inv_units =
-          1.0 / (Sim->units.unitTime() * Sim->units.unitViscosity() * 2.0 *
-                 getMeankT() * V);
-      outputCorrelator(XML, inv_units, Sim->units.unitTime(), _crossVisc,
+    if (correlating(CROSS_VISCOSITY)) {
+      XML << tag("CrossViscosity") << tag("Correlator");
+      outputCorrelator(XML, visc_inv_units, Sim->units.unitTime(), _crossVisc,
                        Sim->systemTime);
+      XML << endtag("Correlator") << endtag("CrossViscosity");
     }
 
-    XML << endtag("Correlator") << endtag("CrossViscosity")
-        << tag("ThermalDiffusion");
+    if (correlating(THERMAL_DIFFUSION)) {
+      XML << tag("ThermalDiffusion");
 
-    for (size_t i(0); i < Sim->species.size(); ++i) {
-      XML << tag("Correlator") << attr("Species") << Sim->species[i]->getName();
+      for (size_t i(0); i < Sim->species.size(); ++i) {
+        XML << tag("Correlator") << attr("Species")
+            << Sim->species[i]->getName();
 
-      const double inv_units =
-          1.0 / (Sim->units.unitTime() * Sim->units.unitThermalDiffusion() *
-                 2.0 * getMeankT() * V);
+        const double inv_units =
+            1.0 / (Sim->units.unitTime() * Sim->units.unitThermalDiffusion() *
+                   2.0 * getMeankT() * V);
 
-      outputCorrelator(XML, inv_units, Sim->units.unitTime(),
-                       _thermalDiffusion[i], Sim->systemTime);
+        outputCorrelator(XML, inv_units, Sim->units.unitTime(),
+                         _thermalDiffusion[i], Sim->systemTime);
 
-      XML << endtag("Correlator");
+        XML << endtag("Correlator");
+      }
+
+      XML << endtag("ThermalDiffusion");
     }
 
-    XML << endtag("ThermalDiffusion") << tag("MutualDiffusion");
+    if (correlating(MUTUAL_DIFFUSION)) {
+      XML << tag("MutualDiffusion");
 
-    for (size_t i(0); i < Sim->species.size(); ++i)
-      for (size_t j(i); j < Sim->species.size(); ++j) {
-        XML << tag("Correlator") << attr("Species1")
-            << Sim->species[i]->getName() << attr("Species2")
-            << Sim->species[j]->getName();
+      for (size_t i(0); i < Sim->species.size(); ++i)
+        for (size_t j(i); j < Sim->species.size(); ++j) {
+          XML << tag("Correlator") << attr("Species1")
+              << Sim->species[i]->getName() << attr("Species2")
+              << Sim->species[j]->getName();
 
-        const double inv_units =
-            1.0 / (Sim->units.unitTime() * Sim->units.unitMutualDiffusion() *
-                   2.0 * getMeankT() * V);
+          const double inv_units =
+              1.0 / (Sim->units.unitTime() * Sim->units.unitMutualDiffusion() *
+                     2.0 * getMeankT() * V);
 
-        outputCorrelator(XML, inv_units, Sim->units.unitTime(),
-                         _mutualDiffusion[i * Sim->species.size() + j],
-                         Sim->systemTime);
+          outputCorrelator(XML, inv_units, Sim->units.unitTime(),
+                           _mutualDiffusion[i * Sim->species.size() + j],
+                           Sim->systemTime);
 
-        XML << endtag("Correlator");
-      }
+          XML << endtag("Correlator");
+        }
 
-    XML << endtag("MutualDiffusion");
+      XML << endtag("MutualDiffusion");
+    }
   }
   XML << endtag("Misc");
 }
@@ -44,16 +44,35 @@ public:
 
   void replicaExchange(OutputPlugin &);
 
+  void saveCheckpoint(CheckpointWriter &) const;
+
+  void loadCheckpoint(CheckpointReader &);
+
   double getDuration() const;
   double getEventsPerSecond() const;
   double getSimTimePerSecond() const;
 
+  /*! \brief Rescale the kinetic accumulators after every velocity
+      was scaled by the square root of the passed factor.
+   */
   void temperatureRescale(const double &);
 
   double getMeankT() const;
   double getMeanSqrkT() const;
   double getCurrentkT() const;
 
+  /*! \brief The current kinetic energy of the system.
+
+    This is accumulated from the changes of each event, so it is
+    available without a sweep over the particles.
+   */
+  double getCurrentKE() const { return _KE.current(); }
+
+  /*! \brief The current kinetic pressure tensor (not divided by the
+      volume), accumulated like getCurrentKE().
+   */
+  Matrix getCurrentKineticTensor() const { return _kineticP.current(); }
+
   Vector getMeanMomentum() const { return _sysMomentum.mean(); }
   Vector getCurrentMomentum() const { return _sysMomentum.current(); }
 
@@ -89,13 +108,36 @@ protected:
   magnet::math::TimeAveragedProperty<double> _internalE;
   magnet::math::TimeAveragedProperty<Vector> _sysMomentum;
   magnet::math::TimeAveragedProperty<Matrix> _kineticP;
-  magnet::math::LogarithmicTimeCorrelator<Vector> _thermalConductivity;
-  magnet::math::LogarithmicTimeCorrelator<Matrix> _viscosity;
-  magnet::math::LogarithmicTimeCorrelator<double> _bulkVisc;
-  magnet::math::LogarithmicTimeCorrelator<Vector> _crossVisc;
-  std::vector<magnet::math::LogarithmicTimeCorrelator<Vector>>
-      _thermalDiffusion;
-  std::vector<magnet::math::LogarithmicTimeCorrelator<Vector>> _mutualDiffusion;
+  magnet::math::MultiTauTimeCorrelator<Vector> _thermalConductivity;
+  magnet::math::MultiTauTimeCorrelator<Matrix> _viscosity;
+  magnet::math::MultiTauTimeCorrelator<double> _bulkVisc;
+  magnet::math::MultiTauTimeCorrelator<Vector> _crossVisc;
+  std::vector<magnet::math::MultiTauTimeCorrelator<Vector>> _thermalDiffusion;
+  std::vector<magnet::math::MultiTauTimeCorrelator<Vector>> _mutualDiffusion;
+
+  /*! \brief The transport property correlators which may be
+      collected, selected using the Correlators attribute.
+   */
+  enum TransportCorrelator : unsigned {
+    THERMAL_CONDUCTIVITY = 1 << 0,
+    VISCOSITY = 1 << 1,
+    BULK_VISCOSITY = 1 << 2,
+    CROSS_VISCOSITY = 1 << 3,
+    THERMAL_DIFFUSION = 1 << 4,
+    MUTUAL_DIFFUSION = 1 << 5,
+    ALL_CORRELATORS = (1 << 6) - 1
+  };
+
+  //! \brief The TransportCorrelator-s being collected.
+  unsigned _correlators;
+
+  bool correlating(TransportCorrelator correlator) const {
+    return _correlators & correlator;
+  }
+
+  //! \brief The current energy flux, the thermal conductivity's
+  //! free streaming value.
+  Vector _thermalConductivityFS;
   std::vector<double> _internalEnergy;
   std::vector<double> _speciesMasses;
   std::vector<Vector> _speciesMomenta;
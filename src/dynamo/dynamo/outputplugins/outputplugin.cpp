@@ -25,7 +25,7 @@
 namespace dynamo {
 OutputPlugin::OutputPlugin(const dynamo::Simulation *tmp, const char *aName,
                            unsigned char order)
-    : SimBase_const(tmp, aName), updateOrder(order) {
+    : SimBase_const(tmp, aName), updateOrder(order), _name(aName) {
   dout << "Loaded" << std::endl;
 }
 
@@ -138,6 +138,8 @@ OutputPlugin::getPlugin(const magnet::xml::Node &XML,
     return testGeneratePlugin<OPVACF>(Sim, XML);
   else if (!Name.compare("KEnergyTicker"))
     return testGeneratePlugin<OPKEnergyTicker>(Sim, XML);
+  else if (!Name.compare("TimeSeries"))
+    return testGeneratePlugin<OPTimeSeries>(Sim, XML);
   else if (!Name.compare("StructureImage"))
     return testGeneratePlugin<OPStructureImaging>(Sim, XML);
   else if (!Name.compare("EventEffects"))
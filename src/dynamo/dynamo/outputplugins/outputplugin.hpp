@@ -18,6 +18,7 @@
 #pragma once
 #include <dynamo/base.hpp>
 #include <dynamo/eventtypes.hpp>
+#include <string>
 
 namespace magnet {
 namespace xml {
@@ -33,6 +34,8 @@ class ParticleEventData;
 class NEventData;
 class System;
 class IDRange;
+class CheckpointWriter;
+class CheckpointReader;
 
 class OutputPlugin : public dynamo::SimBase_const {
 public:
@@ -69,6 +72,22 @@ public:
 
   virtual void temperatureRescale(const double &) {}
 
+  /*! \brief Write the accumulated averages of the plugin to a
+      checkpoint (see Simulation::writeCheckpoint).
+
+    By default nothing is written, and the plugin restarts its
+    sampling when the checkpoint is restored.
+   */
+  virtual void saveCheckpoint(CheckpointWriter &) const {}
+
+  /*! \brief Restore the state written by saveCheckpoint(), after
+      the plugin has been initialised.
+   */
+  virtual void loadCheckpoint(CheckpointReader &) {}
+
+  //! \brief The type name this plugin was loaded with.
+  const std::string &getName() const { return _name; }
+
 protected:
   std::ostream &I_Pcout() const;
 
@@ -79,5 +98,8 @@ protected:
   //
   // Lets other plugins take data from plugins before/after they are updated
   unsigned char updateOrder;
+
+private:
+  std::string _name;
 };
 } // namespace dynamo
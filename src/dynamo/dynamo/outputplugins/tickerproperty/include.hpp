@@ -32,6 +32,7 @@
 #include <dynamo/outputplugins/tickerproperty/radialdist.hpp>
 #include <dynamo/outputplugins/tickerproperty/radiusGyration.hpp>
 #include <dynamo/outputplugins/tickerproperty/structureImage.hpp>
+#include <dynamo/outputplugins/tickerproperty/timeseries.hpp>
 #include <dynamo/outputplugins/tickerproperty/vacf.hpp>
 #include <dynamo/outputplugins/tickerproperty/vel_dist.hpp>
 #include <dynamo/outputplugins/tickerproperty/velprof.hpp>
@@ -35,11 +35,5 @@ void OPOverlapTest::output(magnet::xml::XmlStream &) {
   ticker();
 }
 
-void OPOverlapTest::ticker() {
-  for (std::vector<Particle>::const_iterator iPtr = Sim->particles.begin();
-       iPtr != Sim->particles.end(); ++iPtr)
-    for (std::vector<Particle>::const_iterator jPtr = iPtr + 1;
-         jPtr != Sim->particles.end(); ++jPtr)
-      Sim->getInteraction(*iPtr, *jPtr)->validateState(*iPtr, *jPtr);
-}
+void OPOverlapTest::ticker() { Sim->checkPairs(); }
 } // namespace dynamo
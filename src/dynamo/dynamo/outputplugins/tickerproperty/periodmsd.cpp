@@ -19,12 +19,16 @@
 #include <dynamo/outputplugins/msd.hpp>
 #include <dynamo/outputplugins/tickerproperty/periodmsd.hpp>
 #include <dynamo/simulation.hpp>
+#include <magnet/xmlreader.hpp>
 #include <magnet/xmlwriter.hpp>
 
 namespace dynamo {
 OPPeriodicMSD::OPPeriodicMSD(const dynamo::Simulation *tmp,
-                             const magnet::xml::Node &)
-    : OPTicker(tmp, "PeriodicMSD") {}
+                             const magnet::xml::Node &XML)
+    : OPTicker(tmp, "PeriodicMSD") {
+  if (XML.hasAttribute("File"))
+    _filename = XML.getAttribute("File").as<std::string>();
+}
 
 void OPPeriodicMSD::initialise() {
   // Load the diffusion class
@@ -42,9 +46,33 @@ void OPPeriodicMSD::initialise() {
 
   // Species
   speciesData.resize(Sim->species.size());
+
+  if (!_filename.empty()) {
+    std::vector<std::string> columns{"time"};
+    for (const shared_ptr<Species> &sp : Sim->species)
+      columns.push_back(sp->getName());
+    for (const localpair2 &dat : structResults)
+      columns.push_back(dat.first->getName());
+    _writer.reset(new magnet::stream::TimeSeriesWriter(_filename, columns));
+  }
 }
 
 void OPPeriodicMSD::ticker() {
+  if (_writer) {
+    std::vector<double> row{
+        double(Sim->systemTime / Sim->units.unitTime())};
+    for (const shared_ptr<Species> &sp : Sim->species) {
+      const Vector msd = ptrOPMSD->calcMSD(*(sp->getRange()));
+      row.push_back((msd[0] + msd[1] + msd[2]) / (3 * Sim->units.unitArea()));
+    }
+    for (const localpair2 &dat : structResults) {
+      const Vector msd = ptrOPMSD->calcStructMSD(*dat.first);
+      row.push_back((msd[0] + msd[1] + msd[2]) / (3 * Sim->units.unitArea()));
+    }
+    _writer->append(row);
+    return;
+  }
+
   for (localpair2 &dat : structResults) {
     const Vector msd = ptrOPMSD->calcStructMSD(*dat.first);
     dat.second.push_back(
@@ -61,6 +89,13 @@ void OPPeriodicMSD::ticker() {
 void OPPeriodicMSD::output(magnet::xml::XmlStream &XML) {
   XML << magnet::xml::tag("PeriodicMSD");
 
+  if (_writer) {
+    _writer->flush();
+    XML << magnet::xml::attr("File") << _filename << magnet::xml::attr("Rows")
+        << _writer->rows() << magnet::xml::endtag("PeriodicMSD");
+    return;
+  }
+
   for (const shared_ptr<Species> &sp : Sim->species) {
     XML << magnet::xml::tag("Species") << magnet::xml::attr("Name")
         << sp->getName() << magnet::xml::chardata();
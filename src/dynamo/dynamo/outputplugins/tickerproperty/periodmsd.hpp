@@ -18,12 +18,23 @@
 #pragma once
 #include <dynamo/outputplugins/tickerproperty/ticker.hpp>
 #include <list>
+#include <magnet/stream/timeseries.hpp>
+#include <memory>
 #include <vector>
 
 namespace dynamo {
 class OPMSD;
 class Topology;
 
+/*! \brief Periodically samples the mean square displacement of each
+    species and structure.
+
+  By default the samples are kept in memory and written to the
+  output file at the end of the run. If a "File" option is given,
+  they are instead streamed to a binary time-series file (see
+  magnet::stream::TimeSeriesWriter), with a time column followed by
+  a column for each species and then each structure.
+ */
 class OPPeriodicMSD : public OPTicker {
 public:
   OPPeriodicMSD(const dynamo::Simulation *, const magnet::xml::Node &);
@@ -46,5 +57,8 @@ protected:
   std::vector<std::vector<localpair>> speciesData;
 
   shared_ptr<const OPMSD> ptrOPMSD;
+
+  std::string _filename;
+  std::unique_ptr<magnet::stream::TimeSeriesWriter> _writer;
 };
 } // namespace dynamo
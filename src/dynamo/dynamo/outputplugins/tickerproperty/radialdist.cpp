@@ -19,6 +19,7 @@
 #include <dynamo/include.hpp>
 #include <dynamo/outputplugins/misc.hpp>
 #include <dynamo/outputplugins/tickerproperty/radialdist.hpp>
+#include <dynamo/pairsearch.hpp>
 #include <magnet/xmlreader.hpp>
 #include <magnet/xmlwriter.hpp>
 
@@ -85,30 +86,12 @@ void OPRadialDistribution::initialise() {
 
   if (_enable_offset) {
     dout << "Calculating initial moment offset" << std::endl;
-    for (const shared_ptr<Species> &sp1 : Sim->species)
-      for (const shared_ptr<Species> &sp2 : Sim->species) {
-        const size_t moment_offset =
-            (sp1->getID() * Sim->species.size() + sp2->getID()) * length;
-
-        for (const size_t &p1 : *sp1->getRange())
-          for (const size_t &p2 : *sp2->getRange()) {
-            if (p1 == p2)
-              continue; // Exclude self-self distances
-            Vector rij = Sim->particles[p1].getPosition() -
-                         Sim->particles[p2].getPosition();
-            Sim->BCs->applyBC(rij);
-            const size_t j = static_cast<size_t>(rij.nrm() / binWidth);
-            if (j < length) {
-              if (p1 < p2) // only count pairs once
-                ++initial_moment[moment_offset + j];
-            }
-          }
+    initial_moment = countPairs(false);
 
-        // We now can run sums on the accumulator to make it cumulative
-        for (size_t i(1); i < length; ++i)
-          initial_moment[moment_offset + i] +=
-              initial_moment[moment_offset + i - 1];
-      }
+    // We now can run sums on the accumulator to make it cumulative
+    for (size_t offset(0); offset < initial_moment.size(); offset += length)
+      for (size_t i(1); i < length; ++i)
+        initial_moment[offset + i] += initial_moment[offset + i - 1];
   } else
     dout << "Using zero initial moment offset" << std::endl;
 
@@ -138,54 +121,27 @@ void OPRadialDistribution::ticker() {
 
   ++_sampleCount;
 
-  // These are preallocated here for speed
-  std::vector<long long> accumulator; // Eventually becomes the number of
-                                      // particles at this radius or less
-  std::vector<double> moment;         // The current moment of the accumulator
-  accumulator.resize(length);
-  moment.resize(length);
+  // The number of pairs at each radius, for each species pair
+  std::vector<long long> accumulator = countPairs(true);
+  std::vector<double> moment(length); // The current moment of the accumulator
 
   for (const shared_ptr<Species> &sp1 : Sim->species)
     for (const shared_ptr<Species> &sp2 : Sim->species) {
-      std::fill(accumulator.begin(), accumulator.end(),
-                0u); // Reset the accumulator
-
-      for (const size_t &p1 : *sp1->getRange())
-        for (const size_t &p2 : *sp2->getRange()) {
-          if (p1 == p2)
-            continue; // Exclude self-self distances
-          Vector rij = Sim->particles[p1].getPosition() -
-                       Sim->particles[p2].getPosition();
-          Sim->BCs->applyBC(rij);
-          {
-            const size_t i = static_cast<size_t>(rij.nrm() / binWidth + 0.5);
-            if (i < length) {
-              ++gr_accumulator[sp1->getID()][sp2->getID()][i];
-            }
-          }
-          {
-            const size_t j = static_cast<size_t>(rij.nrm() / binWidth);
-            if (j < length) {
-              if (p1 < p2) // only count pairs once
-                ++accumulator[j];
-            }
-          }
-        }
+      const size_t initial_moment_offset =
+          (sp1->getID() * Sim->species.size() + sp2->getID()) * length;
 
       // We now can run sums on the accumulator to make it cumulative
       for (size_t i(1); i < length; ++i)
-        accumulator[i] += accumulator[i - 1];
+        accumulator[initial_moment_offset + i] +=
+            accumulator[initial_moment_offset + i - 1];
 
       std::fill(moment.begin(), moment.end(), 1u); // Reset the moments
 
-      const size_t initial_moment_offset =
-          (sp1->getID() * Sim->species.size() + sp2->getID()) * length;
-
       for (size_t m(0); m < N_moments; ++m) {
         // Generate the moment of the accumulator
         for (size_t i(0); i < length; ++i)
-          moment[i] *=
-              accumulator[i] - initial_moment[initial_moment_offset + i];
+          moment[i] *= accumulator[initial_moment_offset + i] -
+                       initial_moment[initial_moment_offset + i];
 
         // Determine where we put this moment
         const size_t moment_offset =
@@ -198,6 +154,54 @@ void OPRadialDistribution::ticker() {
     }
 }
 
+std::vector<long long> OPRadialDistribution::countPairs(bool sample_gr) {
+  const size_t Nsp = Sim->species.size();
+  const size_t nthreads = Sim->getDiagnosticThreadCount();
+
+  // Per-thread histograms, indexed by (species1 * Nsp + species2) *
+  // length + bin. Each pair is counted once in pairs (under the
+  // species of the lower ID first) and in both orders in gr.
+  std::vector<std::vector<long long>> pairs(
+      nthreads, std::vector<long long>(Nsp * Nsp * length, 0));
+  std::vector<std::vector<long long>> gr(
+      sample_gr ? nthreads : 0, std::vector<long long>(Nsp * Nsp * length, 0));
+
+  PairSearch search(Sim, length * binWidth);
+  const size_t nblocks = search.forEachPair(
+      nthreads, [&](size_t block, const Particle &p1, const Particle &p2) {
+        const size_t s1 = Sim->species[p1]->getID();
+        const size_t s2 = Sim->species[p2]->getID();
+        Vector rij = p1.getPosition() - p2.getPosition();
+        Sim->BCs->applyBC(rij);
+
+        if (sample_gr) {
+          const size_t i = static_cast<size_t>(rij.nrm() / binWidth + 0.5);
+          if (i < length) {
+            ++gr[block][(s1 * Nsp + s2) * length + i];
+            ++gr[block][(s2 * Nsp + s1) * length + i];
+          }
+        }
+
+        const size_t j = static_cast<size_t>(rij.nrm() / binWidth);
+        if (j < length)
+          ++pairs[block][(s1 * Nsp + s2) * length + j];
+      });
+
+  for (size_t block(1); block < nblocks; ++block)
+    for (size_t i(0); i < pairs[0].size(); ++i)
+      pairs[0][i] += pairs[block][i];
+
+  if (sample_gr)
+    for (size_t block(0); block < nblocks; ++block)
+      for (size_t s1(0); s1 < Nsp; ++s1)
+        for (size_t s2(0); s2 < Nsp; ++s2)
+          for (size_t i(0); i < length; ++i)
+            gr_accumulator[s1][s2][i] +=
+                gr[block][(s1 * Nsp + s2) * length + i];
+
+  return pairs[0];
+}
+
 std::vector<std::pair<double, double>>
 OPRadialDistribution::getgrdata(size_t species1ID, size_t species2ID) const {
   std::vector<std::pair<double, double>> retval;
@@ -44,6 +44,17 @@ public:
   double getBinWidth() const { return binWidth; }
 
 protected:
+  /*! \brief Histograms the separation of all pairs of particles
+      closer than length * binWidth.
+
+    \param sample_gr If true, the pairs are also added to the
+    gr_accumulator.
+    \return The count of pairs in each bin (not cumulative), indexed
+    by (species1 * Nspecies + species2) * length + bin, where
+    species1 is the species of the particle with the lower ID.
+   */
+  std::vector<long long> countPairs(bool sample_gr);
+
   double binWidth;
   size_t length;
   size_t _sampleCount;
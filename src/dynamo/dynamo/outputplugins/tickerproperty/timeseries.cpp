@@ -0,0 +1,69 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/include.hpp>
+#include <dynamo/outputplugins/misc.hpp>
+#include <dynamo/outputplugins/tickerproperty/timeseries.hpp>
+#include <dynamo/simulation.hpp>
+#include <magnet/xmlreader.hpp>
+#include <magnet/xmlwriter.hpp>
+
+namespace dynamo {
+OPTimeSeries::OPTimeSeries(const dynamo::Simulation *tmp,
+                           const magnet::xml::Node &XML)
+    : OPTicker(tmp, "TimeSeries"), _filename("timeseries.dat") {
+  operator<<(XML);
+}
+
+void OPTimeSeries::operator<<(const magnet::xml::Node &XML) {
+  if (XML.hasAttribute("File"))
+    _filename = XML.getAttribute("File").as<std::string>();
+}
+
+void OPTimeSeries::initialise() {
+  _misc = Sim->getOutputPlugin<OPMisc>();
+  if (!_misc)
+    M_throw() << "TimeSeries requires the Misc plugin";
+
+  _writer.reset(new magnet::stream::TimeSeriesWriter(
+      _filename, {"time", "events", "kT", "U", "E", "Px", "Py", "Pz"}));
+
+  dout << "Streaming observables to " << _filename << std::endl;
+  ticker();
+}
+
+void OPTimeSeries::ticker() {
+  const double energy = Sim->units.unitEnergy();
+  const Vector momentum =
+      _misc->getCurrentMomentum() / Sim->units.unitMomentum();
+  _writer->append({double(Sim->systemTime / Sim->units.unitTime()),
+                   double(Sim->eventCount), _misc->getCurrentkT() / energy,
+                   _misc->getConfigurationalU() / energy,
+                   _misc->getTotalEnergy() / energy, momentum[0], momentum[1],
+                   momentum[2]});
+}
+
+void OPTimeSeries::output(magnet::xml::XmlStream &XML) {
+  // Make sure the file is complete before anything reads the output
+  _writer->flush();
+
+  XML << magnet::xml::tag("TimeSeries") << magnet::xml::attr("File")
+      << _filename << magnet::xml::attr("Rows") << _writer->rows()
+      << magnet::xml::attr("Columns") << _writer->columns().size()
+      << magnet::xml::endtag("TimeSeries");
+}
+} // namespace dynamo
@@ -0,0 +1,58 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/outputplugins/tickerproperty/ticker.hpp>
+#include <magnet/stream/timeseries.hpp>
+#include <memory>
+
+namespace dynamo {
+class OPMisc;
+
+/*! \brief Streams the instantaneous thermodynamic observables to a
+    binary time-series file every tick.
+
+  Each tick appends one row (time, event count, kT, configurational
+  energy, total energy, and the system momentum, all in simulation
+  units) to the file given by the "File" option (default
+  timeseries.dat). The file is written in the background by a
+  magnet::stream::TimeSeriesWriter and may be read while the
+  simulation is running with pydynamo.timeseries. Only a summary is
+  written to the output file.
+ */
+class OPTimeSeries : public OPTicker {
+public:
+  OPTimeSeries(const dynamo::Simulation *, const magnet::xml::Node &);
+
+  virtual void initialise();
+
+  virtual void stream(double) {}
+
+  virtual void ticker();
+
+  virtual void output(magnet::xml::XmlStream &);
+
+  virtual void replicaExchange(OutputPlugin &) {}
+
+  void operator<<(const magnet::xml::Node &);
+
+protected:
+  std::string _filename;
+  shared_ptr<const OPMisc> _misc;
+  std::unique_ptr<magnet::stream::TimeSeriesWriter> _writer;
+};
+} // namespace dynamo
@@ -15,19 +15,226 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <dynamo/BC/BC.hpp>
 #include <dynamo/dynamics/dynamics.hpp>
 #include <dynamo/include.hpp>
 #include <dynamo/outputplugins/tickerproperty/vtk.hpp>
 #include <dynamo/simulation.hpp>
+#include <iomanip>
+#include <magnet/thread/parallel_for.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <sstream>
+#ifdef DYNAMO_zlib_support
+#include <zlib.h>
+#endif
 
 namespace dynamo {
+namespace {
+/*! \brief Writes the DataArrays of a VTK XML file, either inline as
+    ASCII or as raw binary in the AppendedData section of the file.
+
+  Binary data is written in the native byte order, which is assumed
+  to be little endian, with UInt64 block headers. If compression is
+  enabled, each array is split into blocks which are compressed with
+  zlib, in the layout of VTK's vtkZLibDataCompressor.
+ */
+class VTKDataWriter {
+public:
+  VTKDataWriter(bool binary, bool compress)
+      : _binary(binary), _compress(compress) {}
+
+  //! \brief Writes the attributes of the VTKFile tag.
+  void fileAttributes(magnet::xml::XmlStream &XML) const {
+    using namespace magnet::xml;
+    XML << attr("version") << "0.1" << attr("byte_order") << "LittleEndian";
+    if (_binary)
+      XML << attr("header_type") << "UInt64";
+    if (_compress)
+      XML << attr("compressor") << "vtkZLibDataCompressor";
+  }
+
+  //! \brief Writes a Float32 DataArray.
+  void dataArray(magnet::xml::XmlStream &XML, const std::string &name,
+                 size_t components, const std::vector<float> &data) {
+    using namespace magnet::xml;
+    XML << tag("DataArray") << attr("type") << "Float32" << attr("Name")
+        << name << attr("NumberOfComponents") << components
+        << attr("format");
+
+    if (!_binary) {
+      XML << "ascii" << chardata();
+      for (size_t i(0); i < data.size(); ++i)
+        XML << data[i] << (((i + 1) % components) ? " " : "\n");
+      XML << endtag("DataArray");
+      return;
+    }
+
+    XML << "appended" << attr("offset") << _appended.size()
+        << endtag("DataArray");
+    appendBlock(reinterpret_cast<const char *>(data.data()),
+                data.size() * sizeof(float));
+  }
+
+  //! \brief Writes the AppendedData section, if any data is binary.
+  void appendedData(magnet::xml::XmlStream &XML) const {
+    using namespace magnet::xml;
+    if (!_binary)
+      return;
+    XML << tag("AppendedData") << attr("encoding") << "raw" << chardata()
+        << "_";
+    XML.getUnderlyingStream().write(_appended.data(), _appended.size());
+    XML << "\n" << endtag("AppendedData");
+  }
+
+private:
+  template <class T> void append(const T &val) {
+    const char *ptr = reinterpret_cast<const char *>(&val);
+    _appended.insert(_appended.end(), ptr, ptr + sizeof(T));
+  }
+
+  void appendBlock(const char *data, const size_t len) {
+    if (!_compress) {
+      append<uint64_t>(len);
+      _appended.insert(_appended.end(), data, data + len);
+      return;
+    }
+
+#ifdef DYNAMO_zlib_support
+    // VTK's default block size
+    const size_t blockSize = 1 << 15;
+    const size_t nblocks = (len + blockSize - 1) / blockSize;
+    std::vector<std::vector<Bytef>> blocks(nblocks);
+    for (size_t i(0); i < nblocks; ++i) {
+      const size_t blockLen = std::min(blockSize, len - i * blockSize);
+      uLongf compressedLen = compressBound(blockLen);
+      blocks[i].resize(compressedLen);
+      if (compress2(blocks[i].data(), &compressedLen,
+                    reinterpret_cast<const Bytef *>(data + i * blockSize),
+                    blockLen, Z_DEFAULT_COMPRESSION) != Z_OK)
+        M_throw() << "zlib failed to compress a VTK data block";
+      blocks[i].resize(compressedLen);
+    }
+
+    append<uint64_t>(nblocks);
+    append<uint64_t>(blockSize);
+    append<uint64_t>((nblocks && (len % blockSize)) ? len % blockSize
+                                                    : blockSize);
+    for (const auto &block : blocks)
+      append<uint64_t>(block.size());
+    for (const auto &block : blocks)
+      _appended.insert(_appended.end(), block.begin(), block.end());
+#else
+    M_throw() << "zlib support was not built in!";
+#endif
+  }
+
+  bool _binary;
+  bool _compress;
+  std::vector<char> _appended;
+};
+
+void writeVTKFile(const std::string &filename, bool binary, bool compress,
+                  const std::vector<float> &positions,
+                  const std::vector<float> &velocities) {
+  using namespace magnet::xml;
+  VTKDataWriter writer(binary, compress);
+  XmlStream XML(filename);
+  XML << prolog() << tag("VTKFile") << attr("type") << "UnstructuredGrid";
+  writer.fileAttributes(XML);
+  XML << tag("UnstructuredGrid") << tag("Piece") << attr("NumberOfPoints")
+      << positions.size() / 3 << attr("NumberOfCells") << 0 << tag("Points");
+
+  writer.dataArray(XML, "Position", 3, positions);
+
+  XML << endtag("Points") << tag("Cells")
+
+      << tag("DataArray") << attr("type") << "Int32" << attr("Name")
+      << "connectivity" << attr("format") << "ascii" << endtag("DataArray")
+
+      << tag("DataArray") << attr("type") << "Int32" << attr("Name")
+      << "offsets" << attr("format") << "ascii" << endtag("DataArray")
+
+      << tag("DataArray") << attr("type") << "UInt8" << attr("Name") << "types"
+      << attr("format") << "ascii" << endtag("DataArray")
+
+      << endtag("Cells") << tag("CellData") << endtag("CellData")
+      << tag("PointData");
+
+  writer.dataArray(XML, "Velocities", 3, velocities);
+
+  XML << endtag("PointData") << endtag("Piece") << endtag("UnstructuredGrid");
+  writer.appendedData(XML);
+  XML << endtag("VTKFile");
+  XML.close();
+}
+
+//! \brief The (already scaled) field data of a single frame.
+struct VTKFields {
+  std::array<size_t, 3> binCounts;
+  Vector origin;
+  Vector spacing;
+  std::vector<float> number;
+  std::vector<float> mass;
+  std::vector<float> momentum;
+  std::vector<float> temperature;
+};
+
+void writeVTKFieldsFile(const std::string &filename, bool binary,
+                        bool compress, const VTKFields &fields) {
+  using namespace magnet::xml;
+  VTKDataWriter writer(binary, compress);
+  XmlStream XML(filename);
+  XML << tag("VTKFile") << attr("type") << "ImageData";
+  writer.fileAttributes(XML);
+  XML << tag("ImageData") << attr("WholeExtent");
+
+  for (size_t iDim(0); iDim < NDIM; ++iDim)
+    XML << " " << "0 " << fields.binCounts[iDim] - 1;
+
+  XML << attr("Origin");
+
+  for (size_t iDim(0); iDim < NDIM; ++iDim)
+    XML << fields.origin[iDim] << " ";
+
+  XML << attr("Spacing");
+
+  for (size_t iDim(0); iDim < NDIM; ++iDim)
+    XML << fields.spacing[iDim] << " ";
+
+  XML << tag("Piece") << attr("Extent");
+
+  for (size_t iDim(0); iDim < NDIM; ++iDim)
+    XML << " " << "0 " << fields.binCounts[iDim] - 1;
+
+  XML << tag("PointData");
+  writer.dataArray(XML, "Number density", NDIM, fields.number);
+  writer.dataArray(XML, "Mass density", NDIM, fields.mass);
+  writer.dataArray(XML, "Momentum density", NDIM, fields.momentum);
+  writer.dataArray(XML, "Temperature", 1, fields.temperature);
+
+  ////////////Postamble
+  XML << endtag("PointData") << tag("CellData") << endtag("CellData")
+      << endtag("Piece") << endtag("ImageData");
+  writer.appendedData(XML);
+  XML << endtag("VTKFile");
+  XML.close();
+}
+} // namespace
+
 OPVTK::OPVTK(const dynamo::Simulation *tmp, const magnet::xml::Node &XML)
-    : OPTicker(tmp, "VTK"), imageCount(0), _fields(true) {
+    : OPTicker(tmp, "VTK"), imageCount(0), _fields(true), _binary(true),
+      _compress(false), _async(true) {
   OPVTK::operator<<(XML);
 }
 
+OPVTK::~OPVTK() {
+  // Don't throw from the destructor, errors are reported by output()
+  try {
+    waitForFrame();
+  } catch (...) {
+  }
+}
+
 void OPVTK::operator<<(const magnet::xml::Node &XML) {
   double minBinWidth = 1;
   if (XML.hasAttribute("MinBinWidth"))
@@ -37,6 +244,30 @@ void OPVTK::operator<<(const magnet::xml::Node &XML) {
 
   if (XML.hasAttribute("NoFields"))
     _fields = false;
+
+  if (XML.hasAttribute("Format")) {
+    const std::string format = XML.getAttribute("Format");
+    if (format == "ascii")
+      _binary = false;
+    else if (format == "binary")
+      _binary = true;
+    else
+      M_throw() << "Unknown VTK Format \"" << format
+                << "\", expected ascii or binary";
+  }
+
+  if (XML.hasAttribute("Compress")) {
+#ifndef DYNAMO_zlib_support
+    M_throw() << "Cannot compress the VTK output, zlib support was not "
+                 "built in!";
+#endif
+    if (!_binary)
+      M_throw() << "Only binary VTK output can be compressed";
+    _compress = true;
+  }
+
+  if (XML.hasAttribute("Synchronous"))
+    _async = false;
 }
 
 void OPVTK::initialise() {
@@ -73,181 +304,133 @@ void OPVTK::initialise() {
   ticker();
 }
 
-void OPVTK::ticker() {
-  using namespace magnet::xml;
-  XmlStream XML;
-
-  XML << prolog() << tag("VTKFile") << attr("type") << "UnstructuredGrid"
-      << attr("version") << "0.1" << attr("byte_order") << "LittleEndian"
-      << tag("UnstructuredGrid") << tag("Piece") << attr("NumberOfPoints")
-      << Sim->particles.size() << attr("NumberOfCells") << 0 << tag("Points")
-      << tag("DataArray") << attr("type") << "Float32" << attr("format")
-      << "ascii" << attr("NumberOfComponents") << "3" << chardata();
-
-  for (const Particle &part : Sim->particles) {
-    Vector r = part.getPosition();
-    Sim->BCs->applyBC(r);
-    r = r / Sim->units.unitLength();
-    XML << r[0] << " " << r[1] << " " << r[2] << "\n";
-  }
-
-  XML << endtag("DataArray") << endtag("Points") << tag("Cells")
-
-      << tag("DataArray") << attr("type") << "Int32" << attr("Name")
-      << "connectivity" << attr("format") << "ascii" << endtag("DataArray")
-
-      << tag("DataArray") << attr("type") << "Int32" << attr("Name")
-      << "offsets" << attr("format") << "ascii" << endtag("DataArray")
-
-      << tag("DataArray") << attr("type") << "UInt8" << attr("Name") << "types"
-      << attr("format") << "ascii" << endtag("DataArray")
-
-      << endtag("Cells") << tag("CellData") << endtag("CellData")
-      << tag("PointData");
-
-  // Velocity data
-  XML << tag("DataArray") << attr("type") << "Float32" << attr("Name")
-      << "Velocities" << attr("NumberOfComponents") << "3" << attr("format")
-      << "ascii" << chardata();
-
-  for (const Particle &part : Sim->particles)
-    XML << part.getVelocity()[0] / Sim->units.unitVelocity() << " "
-        << part.getVelocity()[1] / Sim->units.unitVelocity() << " "
-        << part.getVelocity()[2] / Sim->units.unitVelocity() << "\n";
-
-  XML << endtag("DataArray");
+void OPVTK::waitForFrame() {
+  if (_pendingFrame.valid())
+    _pendingFrame.get();
+}
 
-  XML << endtag("PointData") << endtag("Piece") << endtag("UnstructuredGrid")
-      << endtag("VTKFile");
+void OPVTK::ticker() {
+  const size_t N = Sim->N();
+  const size_t nthreads = Sim->threadCount;
+
+  std::vector<float> positions(3 * N), velocities(3 * N);
+  magnet::thread::parallel_for(
+      0, N, nthreads, [&](size_t, size_t begin, size_t end) {
+        for (size_t i(begin); i < end; ++i) {
+          Vector r = Sim->particles[i].getPosition();
+          Sim->BCs->applyBC(r);
+          r = r / Sim->units.unitLength();
+          const Vector v =
+              Sim->particles[i].getVelocity() / Sim->units.unitVelocity();
+          for (size_t iDim(0); iDim < 3; ++iDim) {
+            positions[3 * i + iDim] = r[iDim];
+            velocities[3 * i + iDim] = v[iDim];
+          }
+        }
+      });
 
   std::ostringstream filename_oss;
   filename_oss << "particles_" << std::setw(5) << std::setfill('0')
                << imageCount << ".vtu";
-  XML.write_file(filename_oss.str());
+  const std::string particleFile = filename_oss.str();
 
+  std::string fieldsFile;
+  VTKFields fields;
   if (_fields) {
+    // Each thread bins its own particles, and the bins are then summed
+    const size_t nbins = _numberField.size();
+    std::vector<std::vector<size_t>> number(nthreads);
+    std::vector<std::vector<double>> mass(nthreads), kineticEnergy(nthreads);
+    std::vector<std::vector<Vector>> momentum(nthreads);
+
+    const size_t nblocks = magnet::thread::parallel_for(
+        0, N, nthreads, [&](size_t block, size_t begin, size_t end) {
+          number[block].assign(nbins, 0);
+          mass[block].assign(nbins, 0);
+          kineticEnergy[block].assign(nbins, 0);
+          momentum[block].assign(nbins, Vector{0, 0, 0});
+
+          for (size_t i(begin); i < end; ++i) {
+            const Particle &p = Sim->particles[i];
+            Vector position = p.getPosition(), velocity = p.getVelocity();
+            Sim->BCs->applyBC(position, velocity);
+
+            size_t cellID(0);
+            size_t factor(1);
+            for (size_t iDim(0); iDim < NDIM; ++iDim) {
+              const double x =
+                  position[iDim] + 0.5 * Sim->primaryCellSize[iDim];
+              cellID += factor * static_cast<size_t>(x / _binWidths[iDim]);
+              factor *= _binCounts[iDim];
+            }
+
+            const double m = Sim->species[p]->getMass(p.getID());
+            ++number[block][cellID];
+            mass[block][cellID] += m;
+            momentum[block][cellID] += m * velocity;
+            kineticEnergy[block][cellID] += m * velocity.nrm2() / 2;
+          }
+        });
+
     std::fill(_numberField.begin(), _numberField.end(), 0);
     std::fill(_massField.begin(), _massField.end(), 0.0);
     std::fill(_momentumField.begin(), _momentumField.end(), Vector{0, 0, 0});
     std::fill(_kineticEnergyField.begin(), _kineticEnergyField.end(), 0.0);
-
-    for (const Particle &p : Sim->particles) {
-      Vector position = p.getPosition(), velocity = p.getVelocity();
-      Sim->BCs->applyBC(position, velocity);
-
-      size_t cellID(0);
-      size_t factor(1);
-      for (size_t iDim(0); iDim < NDIM; ++iDim) {
-        cellID +=
-            factor * static_cast<size_t>(
-                         (position[iDim] + 0.5 * Sim->primaryCellSize[iDim]) /
-                         _binWidths[iDim]);
-        factor *= _binCounts[iDim];
+    for (size_t block(0); block < nblocks; ++block)
+      for (size_t id(0); id < nbins; ++id) {
+        _numberField[id] += number[block][id];
+        _massField[id] += mass[block][id];
+        _momentumField[id] += momentum[block][id];
+        _kineticEnergyField[id] += kineticEnergy[block][id];
       }
 
-      const double mass = Sim->species[p]->getMass(p.getID());
-      ++_numberField[cellID];
-      _massField[cellID] += mass;
-      _momentumField[cellID] += mass * velocity;
-      _kineticEnergyField[cellID] += mass * velocity.nrm2() / 2;
-    }
-
-    XmlStream XML;
-    XML << magnet::xml::tag("VTKFile") << magnet::xml::attr("type")
-        << "ImageData" << magnet::xml::attr("version") << "0.1"
-        << magnet::xml::attr("byte_order") << "LittleEndian"
-        << magnet::xml::attr("compressor") << "vtkZLibDataCompressor"
-        << magnet::xml::tag("ImageData") << magnet::xml::attr("WholeExtent");
-
-    for (size_t iDim(0); iDim < NDIM; ++iDim)
-      XML << " " << "0 " << _binCounts[iDim] - 1;
-
-    XML << magnet::xml::attr("Origin");
-
-    for (size_t iDim(0); iDim < NDIM; ++iDim)
-      XML << (Sim->primaryCellSize[iDim] * (-0.5)) / Sim->units.unitLength()
-          << " ";
-
-    XML << magnet::xml::attr("Spacing");
-
-    for (size_t iDim(0); iDim < NDIM; ++iDim)
-      XML << _binWidths[iDim] / Sim->units.unitLength() << " ";
-
-    XML << magnet::xml::tag("Piece") << magnet::xml::attr("Extent");
-
-    for (size_t iDim(0); iDim < NDIM; ++iDim)
-      XML << " " << "0 " << _binCounts[iDim] - 1;
-
     double cellVol = 1;
     for (size_t iDim(0); iDim < NDIM; ++iDim)
       cellVol *= _binWidths[iDim];
 
-    XML << magnet::xml::tag("PointData");
-
-    ////////////Mass field
-    XML << magnet::xml::tag("DataArray") << magnet::xml::attr("type")
-        << "Float32" << magnet::xml::attr("Name") << "Number density"
-        << magnet::xml::attr("NumberOfComponents") << NDIM
-        << magnet::xml::attr("format") << "ascii" << magnet::xml::chardata();
-
-    for (size_t id(0); id < _numberField.size(); ++id)
-      for (size_t iDim(0); iDim < NDIM; ++iDim)
-        XML << _numberField[id] * Sim->units.unitVolume() / cellVol << " ";
-
-    XML << "\n" << magnet::xml::endtag("DataArray");
-
-    ////////////Mass field
-    XML << magnet::xml::tag("DataArray") << magnet::xml::attr("type")
-        << "Float32" << magnet::xml::attr("Name") << "Mass density"
-        << magnet::xml::attr("NumberOfComponents") << NDIM
-        << magnet::xml::attr("format") << "ascii" << magnet::xml::chardata();
-
-    for (size_t id(0); id < _massField.size(); ++id)
-      for (size_t iDim(0); iDim < NDIM; ++iDim)
-        XML << _massField[id] * Sim->units.unitVolume() /
-                   (cellVol * Sim->units.unitMass())
-            << " ";
-
-    XML << "\n" << magnet::xml::endtag("DataArray");
-
-    ////////////Momentum field
-    XML << magnet::xml::tag("DataArray") << magnet::xml::attr("type")
-        << "Float32" << magnet::xml::attr("Name") << "Momentum density"
-        << magnet::xml::attr("NumberOfComponents") << NDIM
-        << magnet::xml::attr("format") << "ascii" << magnet::xml::chardata();
-
-    for (size_t id(0); id < _momentumField.size(); ++id)
-      for (size_t iDim(0); iDim < NDIM; ++iDim)
-        XML << _momentumField[id][iDim] * Sim->units.unitVolume() /
-                   (cellVol * Sim->units.unitMomentum())
-            << " ";
-
-    XML << "\n" << magnet::xml::endtag("DataArray");
-
-    ////////////Energy
-    XML << magnet::xml::tag("DataArray") << magnet::xml::attr("type")
-        << "Float32" << magnet::xml::attr("Name") << "Temperature"
-        << magnet::xml::attr("format") << "ascii" << magnet::xml::chardata();
-
-    for (size_t id(0); id < _kineticEnergyField.size(); ++id)
-      XML << 2 * _kineticEnergyField[id] /
-                 (NDIM * (_numberField[id] + (_numberField[id] == 1)) *
-                  Sim->units.unitEnergy())
-          << " ";
-
-    XML << "\n" << magnet::xml::endtag("DataArray");
-
-    ////////////Postamble
-    XML << magnet::xml::endtag("PointData") << magnet::xml::tag("CellData")
-        << magnet::xml::endtag("CellData") << magnet::xml::endtag("Piece")
-        << magnet::xml::endtag("ImageData") << magnet::xml::endtag("VTKFile");
+    fields.binCounts = _binCounts;
+    fields.origin = (Sim->primaryCellSize * (-0.5)) / Sim->units.unitLength();
+    fields.spacing = _binWidths / Sim->units.unitLength();
+    for (size_t id(0); id < nbins; ++id) {
+      for (size_t iDim(0); iDim < NDIM; ++iDim) {
+        fields.number.push_back(_numberField[id] * Sim->units.unitVolume() /
+                                cellVol);
+        fields.mass.push_back(_massField[id] * Sim->units.unitVolume() /
+                              (cellVol * Sim->units.unitMass()));
+        fields.momentum.push_back(_momentumField[id][iDim] *
+                                  Sim->units.unitVolume() /
+                                  (cellVol * Sim->units.unitMomentum()));
+      }
+      fields.temperature.push_back(
+          2 * _kineticEnergyField[id] /
+          (NDIM * (_numberField[id] + (_numberField[id] == 1)) *
+           Sim->units.unitEnergy()));
+    }
 
-    std::ostringstream filename_oss;
-    filename_oss << "fields_" << std::setw(5) << std::setfill('0') << imageCount
-                 << ".vti";
-    XML.write_file(filename_oss.str());
+    std::ostringstream fields_oss;
+    fields_oss << "fields_" << std::setw(5) << std::setfill('0') << imageCount
+               << ".vti";
+    fieldsFile = fields_oss.str();
   }
   ++imageCount;
+
+  // Only one frame is written at a time, which also reports any error
+  // from writing the previous frame
+  waitForFrame();
+
+  auto writeFrame = [binary = _binary, compress = _compress, particleFile,
+                     fieldsFile, positions = std::move(positions),
+                     velocities = std::move(velocities),
+                     fields = std::move(fields)]() {
+    writeVTKFile(particleFile, binary, compress, positions, velocities);
+    if (!fieldsFile.empty())
+      writeVTKFieldsFile(fieldsFile, binary, compress, fields);
+  };
+
+  if (_async)
+    _pendingFrame = std::async(std::launch::async, std::move(writeFrame));
+  else
+    writeFrame();
 }
 
 namespace {
@@ -258,7 +441,7 @@ void writePVDfile(std::string prefix, std::string ext, size_t imgCount,
   XmlStream XML;
   XML << prolog() << tag("VTKFile") << attr("type") << "Collection"
       << attr("version") << "0.1" << attr("byte_order") << "LittleEndian"
-      << attr("compressor") << "vtkZLibDataCompressor" << tag("Collection");
+      << tag("Collection");
   for (size_t i(0); i < imgCount; ++i) {
     std::ostringstream filename_oss;
     filename_oss << prefix << "_" << std::setw(5) << std::setfill('0') << i
@@ -274,8 +457,10 @@ void writePVDfile(std::string prefix, std::string ext, size_t imgCount,
 } // namespace
 
 void OPVTK::output(magnet::xml::XmlStream &) {
+  waitForFrame();
   const double dt = getTickerTime();
   writePVDfile("particles", "vtu", imageCount, dt);
-  writePVDfile("fields", "vti", imageCount, dt);
+  if (_fields)
+    writePVDfile("fields", "vti", imageCount, dt);
 }
 } // namespace dynamo
@@ -17,14 +17,26 @@
 
 #pragma once
 #include <dynamo/outputplugins/tickerproperty/ticker.hpp>
+#include <future>
 #include <magnet/math/vector.hpp>
 #include <vector>
 
 namespace dynamo {
+/*! \brief Writes the particles (and binned fields) as VTK XML files
+    for visualisation, e.g. with ParaView.
+
+  By default the data is written as raw binary in the AppendedData
+  section of each file (Format=ascii selects the inline text format),
+  optionally zlib compressed (Compress). Frames are written by a
+  background thread while the simulation continues, unless
+  Synchronous is set.
+ */
 class OPVTK : public OPTicker {
 public:
   OPVTK(const dynamo::Simulation *, const magnet::xml::Node &);
 
+  ~OPVTK();
+
   virtual void initialise();
 
   virtual void stream(double) {}
@@ -45,5 +57,14 @@ protected:
 
   size_t imageCount;
   bool _fields;
+  bool _binary;
+  bool _compress;
+  bool _async;
+
+  //! \brief The frame being written in the background, if any.
+  std::future<void> _pendingFrame;
+
+  //! \brief Waits for the pending frame, rethrowing any write error.
+  void waitForFrame();
 };
 } // namespace dynamo
@@ -0,0 +1,102 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <dynamo/BC/LEBC.hpp>
+#include <dynamo/pairsearch.hpp>
+#include <dynamo/simulation.hpp>
+#include <limits>
+
+namespace dynamo {
+PairSearch::PairSearch(const dynamo::Simulation *tmp, double cutoff)
+    : SimBase_const(tmp, "PairSearch"), _cutoff(cutoff),
+      _shearing(std::dynamic_pointer_cast<BCLeesEdwards>(Sim->BCs)),
+      _ordering(std::array<size_t, 3>{{1, 1, 1}}) {
+  const size_t N = Sim->N();
+
+  // Take a copy of the positions in the primary image, and find
+  // their bounding box
+  Vector lo{std::numeric_limits<double>::infinity(),
+            std::numeric_limits<double>::infinity(),
+            std::numeric_limits<double>::infinity()};
+  Vector hi = -lo;
+  _positions.resize(N);
+  for (size_t id(0); id < N; ++id) {
+    Vector pos = Sim->particles[id].getPosition();
+    Sim->BCs->applyBC(pos);
+    _positions[id] = pos;
+    for (size_t iDim = 0; iDim < NDIM; ++iDim) {
+      lo[iDim] = std::min(lo[iDim], pos[iDim]);
+      hi[iDim] = std::max(hi[iDim], pos[iDim]);
+    }
+  }
+
+  // Cells must be at least the cutoff wide, but there is no point
+  // having many more cells than particles.
+  std::array<size_t, 3> cellCount{{1, 1, 1}};
+  Vector cellWidth{0, 0, 0};
+  for (size_t iDim = 0; iDim < NDIM; ++iDim)
+    if (N && (hi[iDim] > lo[iDim]) && std::isfinite(_cutoff))
+      cellCount[iDim] = std::max<size_t>(
+          1, std::min<double>((hi[iDim] - lo[iDim]) /
+                                  std::max(_cutoff, 0.0),
+                              1 << 20));
+
+  while (cellCount[0] * cellCount[1] * cellCount[2] > std::max<size_t>(N, 8))
+    for (size_t &count : cellCount)
+      count = std::max<size_t>(1, count / 2);
+
+  for (size_t iDim = 0; iDim < NDIM; ++iDim)
+    cellWidth[iDim] = (hi[iDim] - lo[iDim]) / cellCount[iDim];
+
+  _ordering = magnet::containers::RowMajorOrdering<3>(cellCount);
+
+  // Sort the particles into the cells (a counting sort, so that the
+  // contents of each cell are contiguous in memory)
+  _particleCell.resize(N);
+  _cellStart.assign(_ordering.length() + 1, 0);
+  for (size_t id(0); id < N; ++id) {
+    std::array<size_t, 3> coords{{0, 0, 0}};
+    for (size_t iDim = 0; iDim < NDIM; ++iDim)
+      if (cellWidth[iDim] > 0)
+        coords[iDim] = std::min(
+            cellCount[iDim] - 1,
+            size_t((_positions[id][iDim] - lo[iDim]) / cellWidth[iDim]));
+    _particleCell[id] = _ordering.toIndex(coords);
+    ++_cellStart[_particleCell[id] + 1];
+  }
+
+  for (size_t cell(0); cell < _ordering.length(); ++cell)
+    _cellStart[cell + 1] += _cellStart[cell];
+
+  std::vector<size_t> fill(_cellStart.begin(), _cellStart.end() - 1);
+  _cellContents.resize(N);
+  for (size_t id(0); id < N; ++id)
+    _cellContents[fill[_particleCell[id]]++] = id;
+}
+
+const Particle &PairSearch::getParticle(size_t id) const {
+  return Sim->particles[id];
+}
+
+bool PairSearch::isWithinCutoff(size_t id1, size_t id2) const {
+  Vector rij = _positions[id1] - _positions[id2];
+  Sim->BCs->applyBC(rij);
+  return rij.nrm2() <= _cutoff * _cutoff;
+}
+} // namespace dynamo
@@ -0,0 +1,147 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/base.hpp>
+#include <dynamo/particle.hpp>
+#include <magnet/containers/ordering.hpp>
+#include <magnet/thread/parallel_for.hpp>
+#include <vector>
+
+namespace dynamo {
+/*! \brief Finds all pairs of particles within a cutoff distance of
+    each other, using a regular grid of cells.
+
+  This is intended for diagnostics and analysis code which would
+  otherwise loop over all N^2 pairs of particles. Unlike the
+  scheduler's neighbour list (e.g., GCells), the grid is built on
+  demand from the current particle positions for the requested
+  cutoff, so it can be used with any scheduler, cutoff, or even
+  before the simulation is initialised.
+
+  The particle positions should be up to date (see
+  Dynamics::updateAllParticles) before the search is constructed,
+  and must not change while it is in use.
+
+  The grid spans the bounding box of the particle positions (after
+  the boundary conditions are applied) and neighbouring cells are
+  always linked periodically. Any extra pairs this adds in
+  non-periodic directions are removed by the distance test, which
+  uses the minimum image of the BoundaryCondition. For Lees-Edwards
+  boundaries the rows of cells across the sheared boundary are
+  searched entirely.
+ */
+class PairSearch : public SimBase_const {
+public:
+  /*! \brief Sorts the particles into the grid.
+
+    \param cutoff Pairs at this distance or closer are reported.
+   */
+  PairSearch(const dynamo::Simulation *, double cutoff);
+
+  /*! \brief Calls \c func(block, p1, p2) once for each pair of
+      particles within the cutoff (with p1.getID() < p2.getID()).
+
+    The particles are split into contiguous blocks of IDs, one per
+    thread, and \c block is the index of the block processing the
+    pair. This allows callers to keep per-block accumulators which
+    they reduce once this function returns. \c func must be safe to
+    call concurrently if more than one thread is requested.
+
+    \return The number of blocks used.
+   */
+  template <class F> size_t forEachPair(size_t nthreads, F func) const {
+    return magnet::thread::parallel_for(
+        0, _positions.size(), nthreads,
+        [&](size_t block, size_t begin, size_t end) {
+          for (size_t id1 = begin; id1 < end; ++id1)
+            visitNeighbours(id1, [&](size_t id2) {
+              if (id2 > id1)
+                func(block, getParticle(id1), getParticle(id2));
+            });
+        });
+  }
+
+  /*! \brief Calls \c func(p2) for each particle within the cutoff
+      of the particle \c p1 (excluding itself).
+   */
+  template <class F> void forEachNeighbour(const Particle &p1, F func) const {
+    visitNeighbours(p1.getID(), [&](size_t id2) { func(getParticle(id2)); });
+  }
+
+  double getCutoff() const { return _cutoff; }
+
+protected:
+  const Particle &getParticle(size_t id) const;
+
+  template <class F> void visitNeighbours(const size_t id1, F func) const {
+    const auto &dims = _ordering.getDimensions();
+    const auto c = _ordering.toCoord(_particleCell[id1]);
+
+    // The range of cells to search in each dimension. Grids
+    // narrower than three cells are searched entirely to avoid
+    // visiting a cell twice.
+    std::array<size_t, 3> start, count;
+    for (size_t iDim = 0; iDim < NDIM; ++iDim)
+      if (dims[iDim] < 3) {
+        start[iDim] = 0;
+        count[iDim] = dims[iDim];
+      } else {
+        start[iDim] = c[iDim] + dims[iDim] - 1;
+        count[iDim] = 3;
+      }
+
+    std::array<size_t, 3> n;
+    for (size_t z = 0; z < count[2]; ++z)
+      for (size_t y = 0; y < count[1]; ++y) {
+        n[2] = start[2] + z;
+        n[1] = start[1] + y;
+        size_t xstart = start[0], xcount = count[0];
+        // Across a sheared boundary the image in x may be anywhere
+        if (_shearing &&
+            ((dims[1] < 3) || (n[1] % dims[1] == 0 && c[1] == dims[1] - 1) ||
+             (n[1] % dims[1] == dims[1] - 1 && c[1] == 0))) {
+          xstart = 0;
+          xcount = dims[0];
+        }
+
+        for (size_t x = 0; x < xcount; ++x) {
+          n[0] = xstart + x;
+          const size_t cell = _ordering.toIndex(n);
+          for (size_t i = _cellStart[cell]; i < _cellStart[cell + 1]; ++i) {
+            const size_t id2 = _cellContents[i];
+            if (id2 != id1 && isWithinCutoff(id1, id2))
+              func(id2);
+          }
+        }
+      }
+  }
+
+  bool isWithinCutoff(size_t id1, size_t id2) const;
+
+  double _cutoff;
+  bool _shearing;
+  magnet::containers::RowMajorOrdering<3> _ordering;
+  //! The positions of the particles, after the BCs were applied.
+  std::vector<Vector> _positions;
+  std::vector<size_t> _particleCell;
+  //! The offset of each cell's contents in _cellContents.
+  std::vector<size_t> _cellStart;
+  //! The particle IDs, sorted by their cell index.
+  std::vector<size_t> _cellContents;
+};
+} // namespace dynamo
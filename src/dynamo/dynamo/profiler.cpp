@@ -0,0 +1,110 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/outputplugins/outputplugin.hpp>
+#include <dynamo/profiler.hpp>
+#include <dynamo/simulation.hpp>
+#include <magnet/xmlwriter.hpp>
+
+namespace dynamo {
+namespace {
+#define printEnum(VAL)                                                         \
+  case Profiler::VAL:                                                          \
+    return #VAL;
+
+const char *stageName(Profiler::Stage stage) {
+  switch (stage) {
+    PROFILER_STAGE_FACTORY(printEnum)
+  case Profiler::STAGE_COUNT:
+  default:
+    break;
+  }
+  M_throw() << "Unknown profiler stage " << int(stage);
+}
+
+#undef printEnum
+
+void outputCounter(magnet::xml::XmlStream &XML,
+                   const Profiler::Counter &counter) {
+  XML << magnet::xml::attr("Calls") << counter.calls
+      << magnet::xml::attr("Cycles") << counter.cycles
+      << magnet::xml::attr("CyclesPerCall")
+      << (counter.calls ? double(counter.cycles) / counter.calls : 0.0);
+}
+} // namespace
+
+void Profiler::clear() {
+  for (auto &stage : _counters)
+    for (auto &source : stage)
+      source.fill(Counter());
+  _plugins.clear();
+  _source = NOSOURCE;
+  _type = NONE;
+}
+
+void Profiler::output(magnet::xml::XmlStream &XML,
+                      const Simulation &Sim) const {
+  XML << magnet::xml::tag("Profiler") << magnet::xml::attr("Clock")
+#if defined(__x86_64__) || defined(__i386__) || defined(_MSC_VER)
+      << "TSC"
+#else
+      << "ns"
+#endif
+      << magnet::xml::attr("Events") << Sim.eventCount;
+
+  for (size_t stage(0); stage < STAGE_COUNT; ++stage) {
+    Counter total;
+    for (const auto &source : _counters[stage])
+      for (const Counter &counter : source) {
+        total.calls += counter.calls;
+        total.cycles += counter.cycles;
+      }
+
+    if (!total.calls)
+      continue;
+
+    XML << magnet::xml::tag("Stage") << magnet::xml::attr("Name")
+        << stageName(Stage(stage));
+    outputCounter(XML, total);
+
+    for (size_t source(0); source < SOURCE_COUNT; ++source)
+      for (size_t type(0); type < TYPE_COUNT; ++type) {
+        const Counter &counter = _counters[stage][source][type];
+        if (!counter.calls)
+          continue;
+        XML << magnet::xml::tag("Event") << magnet::xml::attr("Source")
+            << EventSource(source) << magnet::xml::attr("Type")
+            << EEventType(type);
+        outputCounter(XML, counter);
+        XML << magnet::xml::endtag("Event");
+      }
+
+    XML << magnet::xml::endtag("Stage");
+  }
+
+  XML << magnet::xml::tag("OutputPlugins");
+  for (size_t i(0); i < std::min(_plugins.size(), Sim.outputPlugins.size());
+       ++i) {
+    XML << magnet::xml::tag("Plugin") << magnet::xml::attr("Name")
+        << Sim.outputPlugins[i]->getName();
+    outputCounter(XML, _plugins[i]);
+    XML << magnet::xml::endtag("Plugin");
+  }
+  XML << magnet::xml::endtag("OutputPlugins")
+      << magnet::xml::endtag("Profiler");
+}
+} // namespace dynamo
@@ -0,0 +1,189 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <dynamo/eventtypes.hpp>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace magnet {
+namespace xml {
+class XmlStream;
+}
+} // namespace magnet
+
+namespace dynamo {
+class Simulation;
+
+/*! \brief Cycle/call counters for the stages of the event loop.
+
+  The profiler records how many times each stage of
+  Scheduler::runNextEvent is entered and how many cycles were spent
+  inside it. Each stage is broken down by the EventSource and
+  EEventType of the event that was being processed when the stage
+  ran, so (for example) the sorter pushes caused by a cell transition
+  are reported separately to those caused by a hard core collision.
+
+  The counters are only touched through the DYNAMO_PROFILE_SCOPE and
+  DYNAMO_PROFILE_PLUGIN macros, which expand to nothing unless the
+  code is built with DYNAMO_PROFILER defined (the PROFILER_ENABLED
+  cmake option). Stage timings are inclusive, e.g., the
+  EVENT_PREDICTION stage of a new neighbour is also counted in the
+  CELL_TRANSITION stage which triggered it. EVENT_PREDICTION times
+  the whole Simulation::getEvent call, so it includes the lookup of
+  the Interaction and the virtual dispatch as well as the root
+  finding of the Dynamics.
+
+  The Simulation only holds a Profiler when built with
+  DYNAMO_PROFILER, so unprofiled builds carry none of the counters.
+ */
+class Profiler {
+public:
+#define PROFILER_STAGE_FACTORY(F)                                              \
+  F(SORTER_POP)          /*!< Removing the next event from the FEL */          \
+  F(SORTER_PUSH)         /*!< Inserting a new event into the FEL */            \
+  F(SORTER_INVALIDATE)   /*!< Clearing the PEL of a particle */                \
+  F(EVENT_RECALCULATION) /*!< Re-testing the event at the top of the FEL */    \
+  F(EVENT_REJECTION)     /*!< Rebuilding the PEL after a rejected event */     \
+  F(EVENT_PREDICTION)    /*!< Sim->getEvent, incl. dispatch and solving */     \
+  F(EVENT_EXECUTION)     /*!< Interaction/Local/Global/System runEvent */      \
+  F(CELL_TRANSITION)     /*!< Neighbour list cell changes */                   \
+  F(PLUGIN_UPDATE)       /*!< OutputPlugin::eventUpdate calls */
+
+#define buildEnum(VAL) VAL,
+  typedef enum { PROFILER_STAGE_FACTORY(buildEnum) STAGE_COUNT } Stage;
+#undef buildEnum
+
+  struct Counter {
+    uint64_t calls = 0;
+    uint64_t cycles = 0;
+
+    void add(uint64_t c) {
+      ++calls;
+      cycles += c;
+    }
+  };
+
+  //! \brief Read the cycle counter (falls back to a nanosecond clock).
+  static inline uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_MSC_VER)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+  }
+
+  /*! \brief Sets the event which further stages are attributed to.
+   */
+  void setCurrentEvent(const Event &event) {
+    _source = (event._source < NOSOURCE) ? event._source : NOSOURCE;
+    _type = (event._type < FINAL_ENUM_TO_CATCH_THE_COMMA) ? event._type : NONE;
+  }
+
+  void record(const Stage stage, const uint64_t c) {
+    _counters[stage][_source][_type].add(c);
+  }
+
+  //! \brief The counter of a stage for events of one source and type.
+  const Counter &getCounter(const Stage stage, const EventSource source,
+                            const EEventType type) const {
+    return _counters[stage][source][type];
+  }
+
+  void recordPlugin(const size_t plugin, const uint64_t c) {
+    if (plugin >= _plugins.size())
+      _plugins.resize(plugin + 1);
+    _plugins[plugin].add(c);
+  }
+
+  void clear();
+
+  void output(magnet::xml::XmlStream &, const Simulation &) const;
+
+  /*! \brief RAII helper which records the cycles spent in its scope.
+   */
+  class Scope {
+  public:
+    Scope(Profiler &profiler, const Stage stage)
+        : _profiler(profiler), _stage(stage), _start(cycles()) {}
+
+    ~Scope() { _profiler.record(_stage, cycles() - _start); }
+
+  private:
+    Profiler &_profiler;
+    const Stage _stage;
+    const uint64_t _start;
+  };
+
+  class PluginScope {
+  public:
+    PluginScope(Profiler &profiler, const size_t plugin)
+        : _profiler(profiler), _plugin(plugin), _start(cycles()) {}
+
+    ~PluginScope() { _profiler.recordPlugin(_plugin, cycles() - _start); }
+
+  private:
+    Profiler &_profiler;
+    const size_t _plugin;
+    const uint64_t _start;
+  };
+
+private:
+  static const size_t SOURCE_COUNT = NOSOURCE + 1;
+  static const size_t TYPE_COUNT = FINAL_ENUM_TO_CATCH_THE_COMMA;
+
+  std::array<std::array<std::array<Counter, TYPE_COUNT>, SOURCE_COUNT>,
+             STAGE_COUNT>
+      _counters;
+  std::vector<Counter> _plugins;
+
+  EventSource _source = NOSOURCE;
+  EEventType _type = NONE;
+};
+} // namespace dynamo
+
+#define DYNAMO_PROFILE_CAT_DETAIL(A, B) A##B
+#define DYNAMO_PROFILE_CAT(A, B) DYNAMO_PROFILE_CAT_DETAIL(A, B)
+
+#ifdef DYNAMO_PROFILER
+/*! \brief Time the remainder of the enclosing scope as the given
+    Profiler::Stage of the passed Simulation pointer.*/
+#define DYNAMO_PROFILE_SCOPE(SIM, STAGE)                                       \
+  dynamo::Profiler::Scope DYNAMO_PROFILE_CAT(_dynamo_profile_, __LINE__)(      \
+      (SIM)->profiler, dynamo::Profiler::STAGE)
+/*! \brief Time the remainder of the enclosing scope as an eventUpdate
+    of the OutputPlugin with the given index.*/
+#define DYNAMO_PROFILE_PLUGIN(SIM, INDEX)                                      \
+  dynamo::Profiler::PluginScope DYNAMO_PROFILE_CAT(_dynamo_profile_,           \
+                                                   __LINE__)((SIM)->profiler,  \
+                                                             (INDEX))
+//! \brief Attribute the following stages to the passed Event.
+#define DYNAMO_PROFILE_EVENT(SIM, EVENT) (SIM)->profiler.setCurrentEvent(EVENT)
+#else
+#define DYNAMO_PROFILE_SCOPE(SIM, STAGE)
+#define DYNAMO_PROFILE_PLUGIN(SIM, INDEX)
+#define DYNAMO_PROFILE_EVENT(SIM, EVENT)
+#endif
@@ -27,6 +27,76 @@
 #include <vector>
 
 namespace dynamo {
+class Property;
+
+/*! \brief A typed, read-only view of the values of a Property for
+    each particle.
+
+  Reading a Property through its virtual getProperty() is costly in
+  the event loop, so columns are resolved from the Property once
+  (e.g., when an Interaction is initialised) and read directly
+  afterwards. A uniform value is stored as a column with a stride of
+  zero, so uniform and per-particle values are read by the same
+  (branch-free) code. Property types without contiguous storage
+  give a column which falls back to their getProperty().
+
+  The column refers to the Property it was resolved from (so unit
+  rescaling is seen), and must be resolved again if the number of
+  particles changes. A default constructed column is not valid and
+  must not be read.
+*/
+class PropertyColumn {
+public:
+  PropertyColumn() : _property(nullptr), _data(nullptr), _stride(0) {}
+
+  PropertyColumn(const double *data, size_t stride)
+      : _property(nullptr), _data(data), _stride(stride) {}
+
+  /*! \brief A column which reads the values through the Property,
+      for types without contiguous storage.
+   */
+  explicit PropertyColumn(const Property *property)
+      : _property(property), _data(nullptr), _stride(0) {}
+
+  //! Fetch the value for a particle with a certain ID
+  inline double operator[](size_t ID) const;
+
+  //! Fetch the value for a particle pairing (see Property::getProperty)
+  inline double operator()(size_t ID1, size_t ID2) const {
+    return (operator[](ID1) + operator[](ID2)) / 2;
+  }
+
+  //! Test if the column has been resolved
+  inline bool valid() const { return _data || _property; }
+
+  inline bool isUniform() const { return _data && !_stride; }
+
+  /*! \brief Returns a uniform column if all of the passed particle
+      IDs have the same value, otherwise returns this column.
+   */
+  template <class Container>
+  PropertyColumn foldUniform(const Container &IDs) const {
+    if (!_data || isUniform() || (IDs.begin() == IDs.end()))
+      return *this;
+
+    const size_t first = *IDs.begin();
+    for (const size_t ID : IDs)
+      if (operator[](ID) != operator[](first))
+        return *this;
+
+    PropertyColumn retval(*this);
+    retval._data = _data + first * _stride;
+    retval._stride = 0;
+    return retval;
+  }
+
+private:
+  //! The Property to read if there is no contiguous storage.
+  const Property *_property;
+  const double *_data;
+  size_t _stride;
+};
+
 /*! \brief A interface class which allows other classes to access a property
   of a particle.
 
@@ -55,6 +125,17 @@ public:
     return (getProperty(ID1) + getProperty(ID2)) / 2;
   }
 
+  /*! \brief Resolve a PropertyColumn for the values of this
+      property for N particles.
+
+    The default implementation reads the values through
+    getProperty(), types with contiguous storage override this to
+    return a view of it.
+   */
+  virtual PropertyColumn getColumn(size_t N) const {
+    return PropertyColumn(this);
+  }
+
   //! Fetch the maximum value of this property
   inline virtual const double getMaxValue() const {
     M_throw() << "Unimplemented";
@@ -107,6 +188,10 @@ protected:
   magnet::units::Units _units;
 };
 
+inline double PropertyColumn::operator[](size_t ID) const {
+  return _data ? _data[ID * _stride] : _property->getProperty(ID);
+}
+
 /*! \brief A class where the name is the value of the property.
 
   This property is used whenever a single value is set for a
@@ -121,6 +206,12 @@ public:
 
   //! Always returns a single value.
   inline virtual const double getProperty(size_t ID) const { return _val; }
+
+  //! Returns a uniform column.
+  virtual PropertyColumn getColumn(size_t) const {
+    return PropertyColumn(&_val, 0);
+  }
+
   //! Returns the value as a string.
   inline virtual std::string getName() const {
     return boost::lexical_cast<std::string>(_val);
@@ -196,6 +287,14 @@ public:
 
   inline virtual std::string getName() const { return _name; }
 
+  virtual PropertyColumn getColumn(size_t N) const {
+    if (N > _values.size())
+      M_throw() << "ParticleProperty \"" << _name << "\" has "
+                << _values.size() << " entries, but " << N
+                << " particles are in the simulation";
+    return PropertyColumn(_values.data(), 1);
+  }
+
   inline virtual const double getMaxValue() const {
     return *std::max_element(_values.begin(), _values.end());
   }
@@ -16,7 +16,9 @@
 */
 
 #pragma once
+#include <dynamo/particle.hpp>
 #include <memory>
+#include <vector>
 
 namespace magnet {
 namespace xml {
@@ -27,19 +29,74 @@ class XmlStream;
 namespace dynamo {
 using std::shared_ptr;
 class Simulation;
-class Particle;
+class IDRange;
 
+/*! \brief A set of pairs of particles, used to select the pairs of
+    particles an Interaction applies to.
+
+  Like IDRange, the virtual tests of each pair range type are
+  replaced by per-particle bitsets once the range is compiled (see
+  compile()). The common types (All, None, Self, Single and Pair)
+  then need no virtual calls at all, while any other type is
+  filtered by the bitset of its member particles before its own
+  test is called.
+*/
 class IDPairRange {
 public:
   virtual ~IDPairRange() {}
 
   /*! \brief Test if the pair of particles are represented in this
     Range. */
-  virtual bool isInRange(const Particle &, const Particle &) const = 0;
+  inline bool isInRange(const Particle &p1, const Particle &p2) const {
+    const size_t ID1 = p1.getID(), ID2 = p2.getID();
+    if ((ID1 < _domain) && (ID2 < _domain))
+      switch (_form) {
+      case ALL:
+        return true;
+      case NONE:
+        return false;
+      case SELF:
+        return (ID1 == ID2) && _first[ID1];
+      case PRODUCT:
+        return (_first[ID1] && _second[ID2]) || (_first[ID2] && _second[ID1]);
+      case FILTERED:
+        if (!(_first[ID1] && _first[ID2]))
+          return false;
+        break;
+      default:
+        break;
+      }
+    return testInRange(p1, p2);
+  }
 
   /*! \brief Test if this one particle is within the Range, with any
     other particle. */
-  virtual bool isInRange(const Particle &) const = 0;
+  inline bool isInRange(const Particle &p1) const {
+    const size_t ID = p1.getID();
+    if (ID < _domain)
+      switch (_form) {
+      case ALL:
+        return true;
+      case NONE:
+        return false;
+      case PRODUCT:
+        return _first[ID] || _second[ID];
+      case SELF:
+      case FILTERED:
+        return _first[ID];
+      default:
+        break;
+      }
+    return testInRange(p1);
+  }
+
+  /*! \brief Builds the compiled form of the range.
+
+    Any IDRange's used by the range are compiled too. As with
+    IDRange::compile, this must be called again if the number of
+    particles changes.
+   */
+  virtual void compile(const std::vector<Particle> &particles);
 
   static IDPairRange *getClass(const magnet::xml::Node &,
                                const dynamo::Simulation *);
@@ -48,6 +105,51 @@ public:
                                             const IDPairRange &range);
 
 protected:
+  virtual bool testInRange(const Particle &, const Particle &) const = 0;
+
+  virtual bool testInRange(const Particle &) const = 0;
+
   virtual void outputXML(magnet::xml::XmlStream &XML) const = 0;
+
+  /*! \brief The compiled forms of a pair range.
+
+    A pair (i,j) is in an ALL range if i and j are both particles,
+    in a SELF range if i == j and _first[i], and in a PRODUCT range
+    if (_first[i] and _second[j]) or (_first[j] and _second[i]). The
+    member particles of a FILTERED range are marked in _first, any
+    pair which passes this filter must be tested by testInRange().
+   */
+  enum CompiledForm { UNCOMPILED, ALL, NONE, SELF, PRODUCT, FILTERED };
+
+  /*! \brief Sets the compiled form of the range, taking the bitsets
+      from the passed IDRange's.
+   */
+  void setCompiledForm(CompiledForm form,
+                       const std::vector<Particle> &particles,
+                       const IDRange *first = nullptr,
+                       const IDRange *second = nullptr);
+
+  /*! \brief Sets a FILTERED compiled form from a bitset of the
+      member particles, for ranges which can mark their members
+      faster than by testing every particle.
+   */
+  void setFilteredForm(std::vector<bool> members);
+
+  /*! \brief Discards the compiled form, so testInRange() is used
+      until the range is compiled again.
+   */
+  void invalidate() {
+    _form = UNCOMPILED;
+    _domain = 0;
+    _first.clear();
+    _second.clear();
+  }
+
+private:
+  CompiledForm _form = UNCOMPILED;
+  //! The number of particles when the range was compiled.
+  size_t _domain = 0;
+  std::vector<bool> _first;
+  std::vector<bool> _second;
 };
 } // namespace dynamo
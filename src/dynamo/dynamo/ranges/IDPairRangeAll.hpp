@@ -28,12 +28,17 @@ public:
 
   IDPairRangeAll(const magnet::xml::Node &XML, const dynamo::Simulation *) {}
 
-  virtual bool isInRange(const Particle &, const Particle &) const {
-    return true;
+  virtual void compile(const std::vector<Particle> &particles) {
+    setCompiledForm(ALL, particles);
   }
-  virtual bool isInRange(const Particle &) const { return true; }
 
 protected:
+  virtual bool testInRange(const Particle &, const Particle &) const {
+    return true;
+  }
+
+  virtual bool testInRange(const Particle &) const { return true; }
+
   virtual void outputXML(magnet::xml::XmlStream &XML) const {
     XML << magnet::xml::attr("Type") << "All";
   }
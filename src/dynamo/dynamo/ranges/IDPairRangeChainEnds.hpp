@@ -50,7 +50,8 @@ public:
                 << " number of intervals";
   }
 
-  virtual bool isInRange(const Particle &p1, const Particle &p2) const {
+protected:
+  virtual bool testInRange(const Particle &p1, const Particle &p2) const {
     if (p1.getID() > p2.getID())
       return ((p1.getID() <= rangeEnd) && (p2.getID() >= rangeStart) &&
               !((p2.getID() - rangeStart) % interval) &&
@@ -61,14 +62,13 @@ public:
               (p2.getID() - p1.getID() == interval - 1));
   }
 
-  virtual bool isInRange(const Particle &p1) const {
+  virtual bool testInRange(const Particle &p1) const {
     return (p1.getID() <= rangeEnd) &&
            (p1.getID() >= rangeStart) // Check if the particle is in the range
            && (!((p1.getID() - rangeStart) % interval) // is it the start?
                || !((p1.getID() - rangeStart + 1) % interval)); // Or the end?
   }
 
-protected:
   virtual void outputXML(magnet::xml::XmlStream &XML) const {
     XML << magnet::xml::attr("Type") << "ChainEnds"
         << magnet::xml::attr("Start") << rangeStart << magnet::xml::attr("End")
@@ -39,7 +39,8 @@ public:
           << "Range of IDPairRangeChains does not split evenly into interval";
   }
 
-  virtual bool isInRange(const Particle &p1, const Particle &p2) const {
+protected:
+  virtual bool testInRange(const Particle &p1, const Particle &p2) const {
     size_t a = std::min(p1.getID(), p2.getID()),
            b = std::max(p1.getID(), p2.getID());
 
@@ -49,11 +50,10 @@ public:
                ((b - range1) / interval)); // and belong to the same segment
   }
 
-  virtual bool isInRange(const Particle &p1) const {
+  virtual bool testInRange(const Particle &p1) const {
     return (p1.getID() >= range1) && (p1.getID() <= range2);
   }
 
-protected:
   virtual void outputXML(magnet::xml::XmlStream &XML) const {
     XML << magnet::xml::attr("Type") << "Chains" << magnet::xml::attr("Start")
         << range1 << magnet::xml::attr("End") << range2
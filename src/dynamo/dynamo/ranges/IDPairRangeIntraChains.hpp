@@ -44,7 +44,8 @@ public:
                    "interval";
   }
 
-  virtual bool isInRange(const Particle &p1, const Particle &p2) const {
+protected:
+  virtual bool testInRange(const Particle &p1, const Particle &p2) const {
     // A version with no ? : operators at the expense of one more <=
     // operator, seems fastest
     return
@@ -58,11 +59,10 @@ public:
         (p1.getID() >= range1) && (p1.getID() <= range2);
   }
 
-  virtual bool isInRange(const Particle &p1) const {
+  virtual bool testInRange(const Particle &p1) const {
     return (p1.getID() >= range1) && (p1.getID() <= range2);
   }
 
-protected:
   virtual void outputXML(magnet::xml::XmlStream &XML) const {
     XML << magnet::xml::attr("Type") << "IntraChains"
         << magnet::xml::attr("Start") << range1 << magnet::xml::attr("End")
@@ -22,6 +22,7 @@
 #include <magnet/xmlreader.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <unordered_set>
+#include <utility>
 
 namespace dynamo {
 class IDPairRangeList : public IDPairRange {
@@ -35,24 +36,25 @@ public:
 
   IDPairRangeList() {}
 
-  virtual bool isInRange(const Particle &p1, const Particle &p2) const {
-    return pairmap.find(Key(std::min(p1.getID(), p2.getID()),
-                            std::max(p1.getID(), p2.getID()))) != pairmap.end();
-  }
-
-  virtual bool isInRange(const Particle &p1) const {
-    // Look for the key by hand!
-    for (const auto &element : pairmap)
-      if ((element.first == p1.getID()) || (element.second == p1.getID()))
-        return true;
-
-    return false;
-  }
-
   void addPair(unsigned long a, unsigned long b) {
+    invalidate();
     pairmap.insert(Key(std::min(a, b), std::max(a, b)));
   }
 
+  /*! \brief Marks the member particles in a single pass over the
+      pairs, instead of searching the pairs for every particle.
+   */
+  virtual void compile(const std::vector<Particle> &particles) {
+    std::vector<bool> members(particles.size(), false);
+    for (const Key &key : pairmap) {
+      if (key.first < members.size())
+        members[key.first] = true;
+      if (key.second < members.size())
+        members[key.second] = true;
+    }
+    setFilteredForm(std::move(members));
+  }
+
   const Container &getPairMap() const { return pairmap; }
 
   virtual void operator<<(const magnet::xml::Node &XML) {
@@ -62,6 +64,20 @@ public:
   }
 
 protected:
+  virtual bool testInRange(const Particle &p1, const Particle &p2) const {
+    return pairmap.find(Key(std::min(p1.getID(), p2.getID()),
+                            std::max(p1.getID(), p2.getID()))) != pairmap.end();
+  }
+
+  virtual bool testInRange(const Particle &p1) const {
+    // Look for the key by hand!
+    for (const auto &element : pairmap)
+      if ((element.first == p1.getID()) || (element.second == p1.getID()))
+        return true;
+
+    return false;
+  }
+
   virtual void outputXML(magnet::xml::XmlStream &XML) const {
     XML << magnet::xml::attr("Type") << "List";
     for (const Key &key : pairmap)
@@ -25,12 +25,17 @@ public:
 
   IDPairRangeNone(const magnet::xml::Node &XML, const dynamo::Simulation *) {}
 
-  virtual bool isInRange(const Particle &, const Particle &) const {
-    return false;
+  virtual void compile(const std::vector<Particle> &particles) {
+    setCompiledForm(NONE, particles);
   }
-  virtual bool isInRange(const Particle &) const { return false; }
 
 protected:
+  virtual bool testInRange(const Particle &, const Particle &) const {
+    return false;
+  }
+
+  virtual bool testInRange(const Particle &) const { return false; }
+
   virtual void outputXML(magnet::xml::XmlStream &XML) const {
     XML << magnet::xml::attr("Type") << "None";
   }
@@ -31,16 +31,22 @@ public:
     range2 = shared_ptr<IDRange>(IDRange::getClass(subRangeXML, Sim));
   }
 
-  virtual bool isInRange(const Particle &p1, const Particle &p2) const {
+  virtual void compile(const std::vector<Particle> &particles) {
+    range1->compile(particles);
+    range2->compile(particles);
+    setCompiledForm(PRODUCT, particles, range1.get(), range2.get());
+  }
+
+protected:
+  virtual bool testInRange(const Particle &p1, const Particle &p2) const {
     return (range1->isInRange(p1) && range2->isInRange(p2)) ||
            (range1->isInRange(p2) && range2->isInRange(p1));
   }
 
-  virtual bool isInRange(const Particle &p1) const {
+  virtual bool testInRange(const Particle &p1) const {
     return range1->isInRange(p1) || range2->isInRange(p1);
   }
 
-protected:
   virtual void outputXML(magnet::xml::XmlStream &XML) const {
     XML << magnet::xml::attr("Type") << "Pair" << range1 << range2;
   }
@@ -43,7 +43,8 @@ public:
           << "Range of IDPairRangeChains does not split evenly into interval";
   }
 
-  virtual bool isInRange(const Particle &p1, const Particle &p2) const {
+protected:
+  virtual bool testInRange(const Particle &p1, const Particle &p2) const {
     if (p1.getID() > p2.getID()) {
       if (p1.getID() - p2.getID() != 1) {
         if ((p1.getID() - p2.getID() == interval - 1) &&
@@ -70,11 +71,10 @@ public:
     return false;
   }
 
-  virtual bool isInRange(const Particle &p1) const {
+  virtual bool testInRange(const Particle &p1) const {
     return (p1.getID() >= range1) && (p1.getID() <= range2);
   }
 
-protected:
   virtual void outputXML(magnet::xml::XmlStream &XML) const {
     XML << magnet::xml::attr("Type") << "Rings" << magnet::xml::attr("Start")
         << range1 << magnet::xml::attr("End") << range2
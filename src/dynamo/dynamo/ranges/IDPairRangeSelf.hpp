@@ -30,17 +30,22 @@ public:
     range = shared_ptr<IDRange>(IDRange::getClass(XML.getNode("IDRange"), Sim));
   }
 
-  virtual bool isInRange(const Particle &p1, const Particle &p2) const {
+  virtual void compile(const std::vector<Particle> &particles) {
+    range->compile(particles);
+    setCompiledForm(SELF, particles, range.get());
+  }
+
+  const shared_ptr<IDRange> &getRange() const { return range; }
+
+protected:
+  virtual bool testInRange(const Particle &p1, const Particle &p2) const {
     return (p1.getID() == p2.getID()) && range->isInRange(p1);
   }
 
-  virtual bool isInRange(const Particle &p1) const {
+  virtual bool testInRange(const Particle &p1) const {
     return range->isInRange(p1);
   }
 
-  const shared_ptr<IDRange> &getRange() const { return range; }
-
-protected:
   virtual void outputXML(magnet::xml::XmlStream &XML) const {
     XML << magnet::xml::attr("Type") << "Self" << range;
   }
@@ -31,17 +31,22 @@ public:
     range = shared_ptr<IDRange>(IDRange::getClass(XML.getNode("IDRange"), Sim));
   }
 
-  virtual bool isInRange(const Particle &p1, const Particle &p2) const {
+  virtual void compile(const std::vector<Particle> &particles) {
+    range->compile(particles);
+    setCompiledForm(PRODUCT, particles, range.get(), range.get());
+  }
+
+  const shared_ptr<IDRange> &getRange() const { return range; }
+
+protected:
+  virtual bool testInRange(const Particle &p1, const Particle &p2) const {
     return range->isInRange(p1) && range->isInRange(p2);
   }
 
-  virtual bool isInRange(const Particle &p1) const {
+  virtual bool testInRange(const Particle &p1) const {
     return range->isInRange(p1);
   }
 
-  const shared_ptr<IDRange> &getRange() const { return range; }
-
-protected:
   virtual void outputXML(magnet::xml::XmlStream &XML) const {
     XML << magnet::xml::attr("Type") << "Single" << range;
   }
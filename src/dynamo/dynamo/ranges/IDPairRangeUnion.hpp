@@ -38,25 +38,32 @@ public:
     }
   }
 
-  virtual bool isInRange(const Particle &p1, const Particle &p2) const {
+  void addRange(IDPairRange *nRange) {
+    invalidate();
+    ranges.push_back(shared_ptr<IDPairRange>(nRange));
+  }
+
+  virtual void compile(const std::vector<Particle> &particles) {
+    for (const shared_ptr<IDPairRange> &rPtr : ranges)
+      rPtr->compile(particles);
+    IDPairRange::compile(particles);
+  }
+
+protected:
+  virtual bool testInRange(const Particle &p1, const Particle &p2) const {
     for (const shared_ptr<IDPairRange> &rPtr : ranges)
       if (rPtr->isInRange(p1, p2))
         return true;
     return false;
   }
 
-  virtual bool isInRange(const Particle &p1) const {
+  virtual bool testInRange(const Particle &p1) const {
     for (const shared_ptr<IDPairRange> &rPtr : ranges)
       if (rPtr->isInRange(p1))
         return true;
     return false;
   }
 
-  void addRange(IDPairRange *nRange) {
-    ranges.push_back(shared_ptr<IDPairRange>(nRange));
-  }
-
-protected:
   virtual void outputXML(magnet::xml::XmlStream &XML) const {
     XML << magnet::xml::attr("Type") << "Union";
 
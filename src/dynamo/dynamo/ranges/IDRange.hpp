@@ -16,8 +16,10 @@
 */
 
 #pragma once
+#include <dynamo/particle.hpp>
 #include <iterator>
 #include <memory>
+#include <vector>
 
 namespace magnet {
 namespace xml {
@@ -29,8 +31,17 @@ class XmlStream;
 namespace dynamo {
 using std::shared_ptr;
 class Simulation;
-class Particle;
 
+/*! \brief A set of particle IDs, used to select the particles of a
+    Species, Local, Global, etc.
+
+  Each range type defines its contents through the virtual
+  testInRange(), size() and operator[] members. These are slow to
+  call per element (especially for nested IDRangeUnion's), so once
+  the particles are known (see Simulation::initialise) the range is
+  compiled into a flat form by compile(). Iteration and isInRange()
+  then use the compiled form without any virtual calls.
+*/
 class IDRange {
 public:
   class iterator {
@@ -62,7 +73,16 @@ public:
       return *this;
     }
 
-    inline size_t operator*() const { return (*rangePtr)[pos]; }
+    inline size_t operator*() const {
+      switch (rangePtr->_form) {
+      case INTERVAL:
+        return rangePtr->_start + pos;
+      case SPAN:
+        return rangePtr->_ids[pos];
+      default:
+        return (*rangePtr)[pos];
+      }
+    }
 
     typedef size_t difference_type;
     typedef size_t value_type;
@@ -79,7 +99,33 @@ public:
 
   virtual ~IDRange() {};
 
-  virtual bool isInRange(const Particle &) const = 0;
+  /*! \brief Test if the particle is in the range. */
+  inline bool isInRange(const Particle &p) const {
+    const size_t ID = p.getID();
+    if (ID < _domain)
+      switch (_form) {
+      case INTERVAL:
+        return ID - _start < _count;
+      case SPAN:
+        return _members[ID];
+      default:
+        break;
+      }
+    return testInRange(p);
+  }
+
+  /*! \brief Builds the compiled form of the range.
+
+    The range is flattened into either a contiguous interval of IDs
+    or a list of the IDs in iteration order, along with a bitset of
+    the members. The compiled form is only valid while the particles
+    passed are unchanged in number, so this must be called again if
+    particles are added or removed. Ranges which change their own IDs
+    (e.g., IDRangeList::getContainer and IDRangeUnion::addRange)
+    discard their compiled form, but any range holding them must
+    also be compiled again.
+   */
+  void compile(const std::vector<Particle> &particles);
 
   virtual unsigned long size() const = 0;
 
@@ -94,11 +140,40 @@ public:
                                             const IDRange &range);
 
   iterator begin() const { return IDRange::iterator(0, this); }
-  iterator end() const { return IDRange::iterator(size(), this); }
+  iterator end() const {
+    return IDRange::iterator((_form == UNCOMPILED) ? size() : _count, this);
+  }
 
   inline bool empty() const { return begin() == end(); }
 
 protected:
+  virtual bool testInRange(const Particle &) const = 0;
+
   virtual void outputXML(magnet::xml::XmlStream &) const = 0;
+
+  /*! \brief Discards the compiled form, so the virtual accessors are
+      used until the range is compiled again.
+   */
+  void invalidate() {
+    _form = UNCOMPILED;
+    _domain = 0;
+    _ids.clear();
+    _members.clear();
+  }
+
+private:
+  enum CompiledForm { UNCOMPILED, INTERVAL, SPAN };
+
+  CompiledForm _form = UNCOMPILED;
+  //! The number of particles when the range was compiled.
+  size_t _domain = 0;
+  //! The first ID of an INTERVAL.
+  size_t _start = 0;
+  //! The number of IDs in the compiled range.
+  size_t _count = 0;
+  //! The IDs of a SPAN, in iteration order.
+  std::vector<size_t> _ids;
+  //! The membership of each particle in a SPAN.
+  std::vector<bool> _members;
 };
 } // namespace dynamo
@@ -33,8 +33,6 @@ public:
     operator<<(XML);
   }
 
-  virtual bool isInRange(const Particle &) const { return true; }
-
   void operator<<(const magnet::xml::Node &XML) {}
 
   virtual unsigned long size() const { return Sim->particles.size(); }
@@ -49,6 +47,8 @@ public:
   }
 
 protected:
+  virtual bool testInRange(const Particle &) const { return true; }
+
   void outputXML(magnet::xml::XmlStream &XML) const {
     XML << magnet::xml::attr("Type") << "All";
   }
@@ -35,15 +35,13 @@ public:
 
   IDRangeList() {}
 
-  virtual bool isInRange(const Particle &part) const {
-    for (const unsigned long ID : IDs)
-      if (part.getID() == ID)
-        return true;
-    return false;
+  /*! \brief Returns the IDs for modification, which discards any
+      compiled form of the range. */
+  std::vector<size_t> &getContainer() {
+    invalidate();
+    return IDs;
   }
 
-  std::vector<size_t> &getContainer() { return IDs; }
-
   virtual unsigned long size() const { return IDs.size(); }
 
   virtual unsigned long operator[](unsigned long i) const { return IDs[i]; }
@@ -51,6 +49,13 @@ public:
   virtual unsigned long at(unsigned long i) const { return IDs.at(i); }
 
 protected:
+  virtual bool testInRange(const Particle &part) const {
+    for (const unsigned long ID : IDs)
+      if (part.getID() == ID)
+        return true;
+    return false;
+  }
+
   virtual void outputXML(magnet::xml::XmlStream &XML) const {
     XML << magnet::xml::attr("Type") << "List";
     for (unsigned long ID : IDs)
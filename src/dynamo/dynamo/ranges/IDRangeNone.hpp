@@ -28,8 +28,6 @@ public:
 
   IDRangeNone(const magnet::xml::Node &XML) {}
 
-  virtual bool isInRange(const Particle &) const { return false; }
-
   virtual unsigned long size() const { return 0; }
 
   virtual unsigned long operator[](unsigned long i) const {
@@ -41,6 +39,8 @@ public:
   }
 
 protected:
+  virtual bool testInRange(const Particle &) const { return false; }
+
   virtual void outputXML(magnet::xml::XmlStream &XML) const {
     XML << magnet::xml::attr("Type") << "None";
   }
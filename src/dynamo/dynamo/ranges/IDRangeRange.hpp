@@ -34,10 +34,6 @@ public:
 
   IDRangeRange(size_t s, size_t e) : startID(s), endID(e) {}
 
-  virtual bool isInRange(const Particle &part) const {
-    return (part.getID() >= startID) && (part.getID() <= endID);
-  }
-
   virtual unsigned long size() const { return endID - startID + 1; };
 
   virtual unsigned long operator[](unsigned long i) const {
@@ -51,6 +47,10 @@ public:
   }
 
 protected:
+  virtual bool testInRange(const Particle &part) const {
+    return (part.getID() >= startID) && (part.getID() <= endID);
+  }
+
   virtual void outputXML(magnet::xml::XmlStream &XML) const {
     XML << magnet::xml::attr("Type") << "Ranged" << magnet::xml::attr("Start")
         << startID << magnet::xml::attr("End") << endID;
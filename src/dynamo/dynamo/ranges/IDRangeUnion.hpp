@@ -36,12 +36,9 @@ public:
 
   IDRangeUnion() {}
 
-  virtual bool isInRange(const Particle &part) const {
-    for (const shared_ptr<IDRange> &r : ranges)
-      if (r->isInRange(part))
-        return true;
-
-    return false;
+  void addRange(IDRange *nRange) {
+    invalidate();
+    ranges.push_back(shared_ptr<IDRange>(nRange));
   }
 
   virtual unsigned long size() const {
@@ -63,6 +60,14 @@ public:
   virtual unsigned long at(unsigned long i) const { return operator[](i); }
 
 protected:
+  virtual bool testInRange(const Particle &part) const {
+    for (const shared_ptr<IDRange> &r : ranges)
+      if (r->isInRange(part))
+        return true;
+
+    return false;
+  }
+
   virtual void outputXML(magnet::xml::XmlStream &XML) const {
     XML << magnet::xml::attr("Type") << "Union";
     for (const shared_ptr<IDRange> &r : ranges)
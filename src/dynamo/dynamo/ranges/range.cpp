@@ -36,6 +36,78 @@ magnet::xml::XmlStream &operator<<(magnet::xml::XmlStream &XML,
   return XML;
 }
 
+void IDRange::compile(const std::vector<Particle> &particles) {
+  // Flatten the range using the virtual accessors
+  _form = UNCOMPILED;
+  std::vector<size_t> ids(size());
+  for (size_t i(0); i < ids.size(); ++i)
+    ids[i] = operator[](i);
+
+  _domain = particles.size();
+  _count = ids.size();
+  _start = ids.empty() ? 0 : ids[0];
+  _ids.clear();
+  _members.clear();
+
+  bool contiguous = true;
+  for (size_t i(1); i < ids.size(); ++i)
+    if (ids[i] != _start + i) {
+      contiguous = false;
+      break;
+    }
+
+  if (contiguous) {
+    _form = INTERVAL;
+    return;
+  }
+
+  _members.assign(_domain, false);
+  for (const size_t ID : ids)
+    if (ID < _domain)
+      _members[ID] = true;
+
+  _ids.swap(ids);
+  _form = SPAN;
+}
+
+void IDPairRange::compile(const std::vector<Particle> &particles) {
+  setCompiledForm(FILTERED, particles);
+}
+
+void IDPairRange::setCompiledForm(CompiledForm form,
+                                  const std::vector<Particle> &particles,
+                                  const IDRange *first,
+                                  const IDRange *second) {
+  // The member tests below must not use the old compiled form
+  _form = UNCOMPILED;
+  _domain = 0;
+  _first.assign(particles.size(), false);
+  _second.clear();
+
+  if (form == FILTERED)
+    for (const Particle &p : particles)
+      _first[p.getID()] = testInRange(p);
+  else if (first)
+    for (const Particle &p : particles)
+      _first[p.getID()] = first->isInRange(p);
+
+  if (second) {
+    _second.assign(particles.size(), false);
+    for (const Particle &p : particles)
+      _second[p.getID()] = second->isInRange(p);
+  }
+
+  _domain = particles.size();
+  _form = form;
+}
+
+void IDPairRange::setFilteredForm(std::vector<bool> members) {
+  _first.swap(members);
+  _second.clear();
+  _domain = _first.size();
+  _form = FILTERED;
+}
+
 IDRange *IDRange::getClass(const magnet::xml::Node &XML,
                            const dynamo::Simulation *Sim) {
   if (!XML.getAttribute("Type").getValue().compare("All"))
@@ -68,6 +68,16 @@ void SNeighbourList::initialiseNBlist() {
 }
 
 void SNeighbourList::initialise() {
+  connectNBlist();
+  Scheduler::initialise();
+}
+
+void SNeighbourList::loadCheckpoint(CheckpointReader &in) {
+  connectNBlist();
+  Scheduler::loadCheckpoint(in);
+}
+
+void SNeighbourList::connectNBlist() {
   shared_ptr<GNeighbourList> nblist =
       std::dynamic_pointer_cast<GNeighbourList>(Sim->globals[NBListID]);
 
@@ -82,11 +92,10 @@ void SNeighbourList::initialise() {
               << " but the longest interaction distance is "
               << Sim->getLongestInteraction() / Sim->units.unitLength();
 
-  nblist->_sigNewNeighbour.connect<Scheduler, &Scheduler::addInteractionEvent>(
-      this);
+  nblist->_sigNewNeighbours
+      .connect<Scheduler, &Scheduler::addInteractionEvents>(this);
   nblist->_sigReInitialise.connect<SNeighbourList, &SNeighbourList::initialise>(
       this);
-  Scheduler::initialise();
 }
 
 void SNeighbourList::outputXML(magnet::xml::XmlStream &XML) const {
@@ -27,6 +27,7 @@ public:
 
   virtual void initialise();
   virtual void initialiseNBlist();
+  virtual void loadCheckpoint(CheckpointReader &);
 
   virtual double getNeighbourhoodDistance() const;
   virtual std::unique_ptr<IDRange>
@@ -37,6 +38,9 @@ public:
 protected:
   virtual void outputXML(magnet::xml::XmlStream &) const;
 
+  //! Connects the scheduler to the signals of the neighbour list.
+  void connectNBlist();
+
   size_t NBListID;
 };
 } // namespace dynamo
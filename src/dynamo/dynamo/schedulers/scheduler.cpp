@@ -16,11 +16,13 @@
 */
 
 #include <dynamo/NparticleEventData.hpp>
+#include <dynamo/checkpoint.hpp>
 #include <dynamo/dynamics/dynamics.hpp>
 #include <dynamo/globals/global.hpp>
 #include <dynamo/interactions/interaction.hpp>
 #include <dynamo/locals/local.hpp>
 #include <dynamo/outputplugins/outputplugin.hpp>
+#include <dynamo/profiler.hpp>
 #include <dynamo/schedulers/include.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/simulation.hpp>
@@ -89,13 +91,33 @@ void Scheduler::rebuildList() {
   rebuildSystemEvents();
 }
 
+void Scheduler::saveCheckpoint(CheckpointWriter &out) const {
+  out.write(_interactionRejectionCounter);
+  out.write(_localRejectionCounter);
+  sorter->saveCheckpoint(out);
+}
+
+void Scheduler::loadCheckpoint(CheckpointReader &in) {
+  sorter->clear();
+  sorter->init(Sim->N() + 1);
+  in.read(_interactionRejectionCounter);
+  in.read(_localRejectionCounter);
+  sorter->loadCheckpoint(in);
+}
+
 void Scheduler::addEvents(Particle &part) {
   Sim->dynamics->updateParticle(part);
 
   // Add the global events
   for (const shared_ptr<Global> &glob : Sim->globals)
-    if (glob->isInteraction(part))
-      sorter->push(glob->getEvent(part));
+    if (glob->isInteraction(part)) {
+      const Event event = [&] {
+        DYNAMO_PROFILE_SCOPE(Sim, EVENT_PREDICTION);
+        return glob->getEvent(part);
+      }();
+      DYNAMO_PROFILE_SCOPE(Sim, SORTER_PUSH);
+      sorter->push(event);
+    }
 
   // Add the local cell events
   std::unique_ptr<IDRange> ids(getParticleLocals(part));
@@ -135,18 +157,39 @@ void Scheduler::rebuildSystemEvents() const {
   for (const auto &sysptr : Sim->systems) {
     Event event = sysptr->getEvent();
     event._particle1ID = systemParticleID;
+    DYNAMO_PROFILE_SCOPE(Sim, SORTER_PUSH);
     sorter->push(event);
   }
 }
 
-void Scheduler::popNextEvent() { sorter->pop(); }
+void Scheduler::popNextEvent() {
+  DYNAMO_PROFILE_SCOPE(Sim, SORTER_POP);
+  sorter->pop();
+}
 
-void Scheduler::pushEvent(const Event &newevent) { sorter->push(newevent); }
+void Scheduler::pushEvent(const Event &newevent) {
+  DYNAMO_PROFILE_SCOPE(Sim, SORTER_PUSH);
+  sorter->push(newevent);
+}
 
 void Scheduler::invalidateEvents(const Particle &part) {
+  DYNAMO_PROFILE_SCOPE(Sim, SORTER_INVALIDATE);
   sorter->invalidate(part.getID());
 }
 
+void Scheduler::outputPluginUpdate(const Event &event, const NEventData &data) {
+#ifdef DYNAMO_PROFILER
+  for (size_t i(0); i < Sim->outputPlugins.size(); ++i) {
+    DYNAMO_PROFILE_SCOPE(Sim, PLUGIN_UPDATE);
+    DYNAMO_PROFILE_PLUGIN(Sim, i);
+    Sim->outputPlugins[i]->eventUpdate(event, data);
+  }
+#else
+  for (shared_ptr<OutputPlugin> &Ptr : Sim->outputPlugins)
+    Ptr->eventUpdate(event, data);
+#endif
+}
+
 void Scheduler::runNextEvent() {
 #ifdef DYNAMO_DEBUG
   if (sorter->empty())
@@ -154,6 +197,7 @@ void Scheduler::runNextEvent() {
 #endif
 
   Event next_event = sorter->top();
+  DYNAMO_PROFILE_EVENT(Sim, next_event);
 
   ////////////////////////////////////////////////////////////////////
   // We can't perform such strict testing as commented out
@@ -236,14 +280,17 @@ void Scheduler::runNextEvent() {
                 << "\nInteraction = " << Sim->getInteraction(p1, p2)->getName();
 
     // Ready the next event in the FEL
-    sorter->pop();
+    popNextEvent();
 
     // Now recalculate the current FEL event (to check if
     // accumilation of numerical errors have caused the order of
     // events to change). This also gives us more information on
     // the event.
     Sim->dynamics->updateParticlePair(p1, p2);
-    const Event Event = Sim->getEvent(p1, p2);
+    const Event Event = [&] {
+      DYNAMO_PROFILE_SCOPE(Sim, EVENT_RECALCULATION);
+      return Sim->getEvent(p1, p2);
+    }();
 
     // Now check if the recalculated event is still the first
     // event in the FEL. If not, force a recalculation of this
@@ -265,6 +312,7 @@ void Scheduler::runNextEvent() {
     if ((Event._type == NONE) ||
         ((Event._dt > next_event._dt) &&
          (++_interactionRejectionCounter < rejectionLimit))) {
+      DYNAMO_PROFILE_SCOPE(Sim, EVENT_REJECTION);
       this->fullUpdate(p1, p2);
       return;
     }
@@ -296,30 +344,61 @@ void Scheduler::runNextEvent() {
     // event
     Sim->stream(Event._dt);
 
-    PairEventData eventdata =
-        Sim->interactions[Event._sourceID]->runEvent(p1, p2, Event);
+    PairEventData eventdata = [&] {
+      DYNAMO_PROFILE_SCOPE(Sim, EVENT_EXECUTION);
+      return Sim->interactions[Event._sourceID]->runEvent(p1, p2, Event);
+    }();
 
     Sim->_sigParticleUpdate(eventdata);
     Sim->scheduler->fullUpdate(p1, p2);
-    for (shared_ptr<OutputPlugin> &Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(Event, eventdata);
+    outputPluginUpdate(Event, eventdata);
     break;
   }
   case GLOBAL: {
-    if (!std::isfinite(next_event._dt))
-      M_throw() << "Next event time is not finite!"
-                << "\ndt = " << next_event._dt
-                << "\nEvent Type = " << next_event._type
-                << "\nParticle ID = " << next_event._particle1ID
-                << "\nGlobal (ID=" << next_event._sourceID
-                << ")= " << Sim->globals[next_event._sourceID]->getName();
-
-    // We don't stream the system for globals as neighbour lists
-    // optimise this (they dont need it).  We also don't recheck
-    // Global events! (Check, some events might rely on this
-    // behavior)
-    Sim->globals[next_event._sourceID]->runEvent(
-        Sim->particles[next_event._particle1ID], next_event._dt);
+    // Globals (e.g., the cell transitions of neighbour lists) do not
+    // advance the event count, so a run of them at the top of the
+    // queue is executed here without returning to the simulation
+    // loop. The queue is re-read after each, so the event order is
+    // unchanged. Globals which count as events (e.g., GWaker) or
+    // stream the system (e.g., GPBCSentinel) end the run, so the
+    // simulation loop still sees every event and time step.
+    const size_t globalBatchLimit = 1024;
+    const size_t startEventCount = Sim->eventCount;
+    const long double startTime = Sim->systemTime;
+    size_t batch = 0;
+    for (;;) {
+      if (!std::isfinite(next_event._dt))
+        M_throw() << "Next event time is not finite!"
+                  << "\ndt = " << next_event._dt
+                  << "\nEvent Type = " << next_event._type
+                  << "\nParticle ID = " << next_event._particle1ID
+                  << "\nGlobal (ID=" << next_event._sourceID
+                  << ")= " << Sim->globals[next_event._sourceID]->getName();
+
+      // We don't stream the system for globals as neighbour lists
+      // optimise this (they dont need it).  We also don't recheck
+      // Global events! (Check, some events might rely on this
+      // behavior)
+      {
+        DYNAMO_PROFILE_SCOPE(Sim, EVENT_EXECUTION);
+        Sim->globals[next_event._sourceID]->runEvent(
+            Sim->particles[next_event._particle1ID], next_event._dt);
+      }
+
+      if ((++batch == globalBatchLimit) ||
+          (Sim->eventCount != startEventCount) ||
+          (Sim->systemTime != startTime))
+        break;
+
+      next_event = sorter->top();
+      if ((next_event._source != GLOBAL) ||
+          (next_event._type == RECALCULATE) || (next_event._type == NONE))
+        break;
+
+      DYNAMO_PROFILE_EVENT(Sim, next_event);
+      if (next_event._dt == -std::numeric_limits<float>::infinity())
+        next_event._dt = 0;
+    }
     break;
   }
   case LOCAL: {
@@ -335,9 +414,12 @@ void Scheduler::runNextEvent() {
                 << ")= " << Sim->locals[next_event._sourceID]->getName();
 
     // Ready the next event in the FEL
-    sorter->pop();
+    popNextEvent();
     Sim->dynamics->updateParticle(part);
-    Event iEvent(Sim->locals[localID]->getEvent(part));
+    const Event iEvent = [&] {
+      DYNAMO_PROFILE_SCOPE(Sim, EVENT_RECALCULATION);
+      return Sim->locals[localID]->getEvent(part);
+    }();
 
     next_event = sorter->top();
     // Check the recalculated event is valid and not later than
@@ -345,6 +427,7 @@ void Scheduler::runNextEvent() {
     if ((iEvent._type == NONE) ||
         ((iEvent._dt > next_event._dt) &&
          (++_localRejectionCounter < rejectionLimit))) {
+      DYNAMO_PROFILE_SCOPE(Sim, EVENT_REJECTION);
       this->fullUpdate(part);
       return;
     }
@@ -365,15 +448,17 @@ void Scheduler::runNextEvent() {
     // dynamics must be updated first
     Sim->stream(iEvent._dt);
 
-    const ParticleEventData data = Sim->locals[localID]->runEvent(part, iEvent);
+    const ParticleEventData data = [&] {
+      DYNAMO_PROFILE_SCOPE(Sim, EVENT_EXECUTION);
+      return Sim->locals[localID]->runEvent(part, iEvent);
+    }();
     Sim->_sigParticleUpdate(data);
     Sim->scheduler->fullUpdate(part);
-    for (shared_ptr<OutputPlugin> &Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(iEvent, data);
+    outputPluginUpdate(iEvent, data);
     break;
   }
   case SYSTEM: {
-    sorter->pop();
+    popNextEvent();
     // System events can use the value -std::numeric_limits<float>::infinity()
     // to request immediate processing, therefore, only NaN and
     // +std::numeric_limits<float>::infinity() values are invalid
@@ -390,7 +475,10 @@ void Scheduler::runNextEvent() {
     stream(next_event._dt);
     Sim->stream(next_event._dt);
 
-    const NEventData data = Sim->systems[next_event._sourceID]->runEvent();
+    const NEventData data = [&] {
+      DYNAMO_PROFILE_SCOPE(Sim, EVENT_EXECUTION);
+      return Sim->systems[next_event._sourceID]->runEvent();
+    }();
 
     if (!data.L1partChanges.empty() || !data.L2partChanges.empty()) {
       Sim->_sigParticleUpdate(data);
@@ -400,14 +488,13 @@ void Scheduler::runNextEvent() {
         this->fullUpdate(Sim->particles[d2.particle1_.getParticleID()],
                          Sim->particles[d2.particle2_.getParticleID()]);
 
-      for (shared_ptr<OutputPlugin> &Ptr : Sim->outputPlugins)
-        Ptr->eventUpdate(next_event, data);
+      outputPluginUpdate(next_event, data);
     }
 
     const size_t systemParticleID = Sim->N();
     Event event = Sim->systems[next_event._sourceID]->getEvent();
     event._particle1ID = systemParticleID;
-    sorter->push(event);
+    pushEvent(event);
     break;
   }
   default:
@@ -423,11 +510,41 @@ void Scheduler::addInteractionEvent(const Particle &part,
   Particle &part1(Sim->particles[part.getID()]);
   Particle &part2(Sim->particles[id]);
   Sim->dynamics->updateParticle(part2);
-  sorter->push(Sim->getEvent(part1, part2));
+  const Event event = [&] {
+    DYNAMO_PROFILE_SCOPE(Sim, EVENT_PREDICTION);
+    return Sim->getEvent(part1, part2);
+  }();
+  DYNAMO_PROFILE_SCOPE(Sim, SORTER_PUSH);
+  sorter->push(event);
+}
+
+void Scheduler::addInteractionEvents(const Particle &part,
+                                     const std::vector<size_t> &ids) const {
+  Particle &part1(Sim->particles[part.getID()]);
+  for (const size_t &id : ids)
+    Sim->dynamics->updateParticle(Sim->particles[id]);
+
+  _eventBuffer.clear();
+  {
+    DYNAMO_PROFILE_SCOPE(Sim, EVENT_PREDICTION);
+    for (const size_t &id : ids)
+      if (id != part.getID())
+        _eventBuffer.push_back(Sim->getEvent(part1, Sim->particles[id]));
+  }
+
+  DYNAMO_PROFILE_SCOPE(Sim, SORTER_PUSH);
+  for (const Event &event : _eventBuffer)
+    sorter->push(event);
 }
 
 void Scheduler::addLocalEvent(const Particle &part, const size_t &id) const {
-  if (Sim->locals[id]->isInteraction(part))
-    sorter->push(Sim->locals[id]->getEvent(part));
+  if (Sim->locals[id]->isInteraction(part)) {
+    const Event event = [&] {
+      DYNAMO_PROFILE_SCOPE(Sim, EVENT_PREDICTION);
+      return Sim->locals[id]->getEvent(part);
+    }();
+    DYNAMO_PROFILE_SCOPE(Sim, SORTER_PUSH);
+    sorter->push(event);
+  }
 }
 } // namespace dynamo
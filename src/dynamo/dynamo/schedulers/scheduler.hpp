@@ -33,6 +33,9 @@ class Node;
 namespace dynamo {
 class Particle;
 class Event;
+class NEventData;
+class CheckpointWriter;
+class CheckpointReader;
 
 class Scheduler : public dynamo::SimBase {
 public:
@@ -45,6 +48,18 @@ public:
 
   void rebuildList();
 
+  /*! \brief Write the contents of the event queue to a checkpoint
+      (see Simulation::writeCheckpoint).
+   */
+  void saveCheckpoint(CheckpointWriter &) const;
+
+  /*! \brief Restore the event queue from a checkpoint.
+
+    This is called in place of initialise(), so the configuration is
+    not revalidated and no events are recalculated.
+   */
+  virtual void loadCheckpoint(CheckpointReader &);
+
   /*! \brief Retest for events for a single particle.
    */
   inline void fullUpdate(Particle &part) {
@@ -99,6 +114,16 @@ public:
 
   void addInteractionEvent(const Particle &, const size_t &) const;
 
+  /*! \brief Add the interaction events of a particle with a batch of
+      (new neighbour) particles.
+
+    This is equivalent to calling addInteractionEvent() for each
+    particle in turn, but streams the partners, predicts the events
+    and pushes them to the sorter in separate passes.
+   */
+  void addInteractionEvents(const Particle &,
+                            const std::vector<size_t> &) const;
+
   void addLocalEvent(const Particle &, const size_t &) const;
 
   virtual double getNeighbourhoodDistance() const = 0;
@@ -115,6 +140,12 @@ protected:
   size_t _interactionRejectionCounter;
   size_t _localRejectionCounter;
 
+  //! \brief Storage for the events of addInteractionEvents().
+  mutable std::vector<Event> _eventBuffer;
+
+  //! \brief Pass an executed event to all of the OutputPlugins.
+  void outputPluginUpdate(const Event &, const NEventData &);
+
   virtual void outputXML(magnet::xml::XmlStream &) const = 0;
 };
 } // namespace dynamo
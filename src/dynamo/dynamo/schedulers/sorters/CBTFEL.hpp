@@ -17,8 +17,11 @@
 
 #pragma once
 #include <cmath>
+#include <cstdint>
+#include <dynamo/checkpoint.hpp>
 #include <dynamo/eventtypes.hpp>
 #include <dynamo/schedulers/sorters/FEL.hpp>
+#include <dynamo/schedulers/sorters/compactEvent.hpp>
 #include <magnet/exception.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <vector>
@@ -64,8 +67,11 @@ public:
     // Blank approximately half the events by clearing the PEL of the
     // particle.
     _Min[ID + 1].clear();
-    // Catch the others with lazy deletion.
-    ++_eventCount[ID];
+    // Catch the others with lazy deletion. The counters are stored
+    // in 32 bits in the CompactEvents, and the largest value is
+    // reserved, so they wrap early.
+    if (++_eventCount[ID] == std::numeric_limits<uint32_t>::max())
+      _eventCount[ID] = 0;
   }
 
   inline void pop() {
@@ -78,16 +84,16 @@ public:
     if (_CBT.empty() || _Min[_CBT[1]].empty())
       return true;
 
-    // Check for lazy deletion of the next event
-    Event next_event = _Min[_CBT[1]].top();
-    while ((next_event._source == INTERACTION) &&
-           (next_event._particle2eventcounter !=
-            _eventCount[next_event._particle2ID])) {
+    // Check for lazy deletion of the next event, without expanding
+    // it from its compact form
+    const CompactEvent *next_event = &_Min[_CBT[1]].front();
+    while ((next_event->_source == INTERACTION) &&
+           (next_event->_data2 != _eventCount[next_event->_data1])) {
       pop();
       flushChanges();
       if (_CBT.empty() || _Min[_CBT[1]].empty())
         return true;
-      next_event = _Min[_CBT[1]].top();
+      next_event = &_Min[_CBT[1]].front();
     }
 
     return false;
@@ -124,6 +130,38 @@ public:
     _pecTime *= factor;
   }
 
+  virtual void saveCheckpoint(CheckpointWriter &out) const {
+    out.writeTag("CBTFEL");
+    out.write(_N);
+    out.write(_NP);
+    out.write(_streamFreq);
+    out.write(_nUpdate);
+    out.write(_pecTime);
+    out.write(_activeID);
+    out.write(_CBT);
+    out.write(_Leaf);
+    out.write(_eventCount);
+    for (const auto &pDat : _Min)
+      pDat.save(out);
+  }
+
+  virtual void loadCheckpoint(CheckpointReader &in) {
+    in.checkTag("CBTFEL");
+    if (in.read<size_t>() != _N)
+      M_throw() << "The checkpoint was written for a different number of "
+                   "particles";
+    in.read(_NP);
+    in.read(_streamFreq);
+    in.read(_nUpdate);
+    in.read(_pecTime);
+    in.read(_activeID);
+    in.read(_CBT);
+    in.read(_Leaf);
+    in.read(_eventCount);
+    for (auto &pDat : _Min)
+      pDat.load(in);
+  }
+
 protected:
   size_t _activeID;
 
@@ -132,7 +170,7 @@ protected:
     if ((_activeID != ID) &&
         (_activeID != std::numeric_limits<size_t>::max())) {
       if (_Min[_activeID + 1].empty() ||
-          (_Min[_activeID + 1].top()._dt ==
+          (_Min[_activeID + 1].front()._dt ==
            std::numeric_limits<float>::infinity())) {
         if (_Leaf[_activeID + 1] != std::numeric_limits<size_t>::max()) {
           Delete(_activeID + 1);
@@ -155,7 +193,7 @@ protected:
 
   double _pecTime;
 
-  std::vector<size_t> _eventCount;
+  std::vector<uint32_t> _eventCount;
 
   ///////////////////////////BINARY TREE IMPLEMENTATION
   inline void UpdateCBT(const size_t i) {
@@ -15,6 +15,7 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <dynamo/checkpoint.hpp>
 #include <dynamo/schedulers/sorters/CBTFEL.hpp>
 #include <dynamo/schedulers/sorters/MinMaxPEL.hpp>
 #include <dynamo/schedulers/sorters/boundedPQFEL.hpp>
@@ -47,6 +48,14 @@ shared_ptr<FEL> FEL::getClass(const magnet::xml::Node &XML) {
     M_throw() << "Unknown type of Sorter encountered";
 }
 
+void FEL::saveCheckpoint(CheckpointWriter &) const {
+  M_throw() << "This sorter does not support checkpointing";
+}
+
+void FEL::loadCheckpoint(CheckpointReader &) {
+  M_throw() << "This sorter does not support checkpointing";
+}
+
 magnet::xml::XmlStream &operator<<(magnet::xml::XmlStream &XML,
                                    const FEL &srtr) {
   srtr.outputXML(XML);
@@ -27,6 +27,9 @@ class XmlStream;
 } // namespace magnet
 
 namespace dynamo {
+class CheckpointWriter;
+class CheckpointReader;
+
 /*! \brief Future Event Lists (FEL) sort the Particle Event Lists
     (PEL) to determine the next event to occur.
 
@@ -100,6 +103,21 @@ public:
 
   virtual Event top() = 0;
 
+  /*! \brief Write the queued events, and the sorting structure, to a
+      checkpoint (see Simulation::writeCheckpoint).
+
+    The default implementation throws, as the FEL cannot be
+    restored.
+   */
+  virtual void saveCheckpoint(CheckpointWriter &) const;
+
+  /*! \brief Restore the state written by saveCheckpoint().
+
+    The FEL must have been initialised (see init()) for the same
+    number of particles.
+   */
+  virtual void loadCheckpoint(CheckpointReader &);
+
   static shared_ptr<FEL> getClass(const magnet::xml::Node &);
   friend ::magnet::xml::XmlStream &operator<<(::magnet::xml::XmlStream &,
                                               const FEL &);
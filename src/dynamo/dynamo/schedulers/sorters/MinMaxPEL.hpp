@@ -16,7 +16,9 @@
 */
 
 #pragma once
+#include <dynamo/checkpoint.hpp>
 #include <dynamo/eventtypes.hpp>
+#include <dynamo/schedulers/sorters/compactEvent.hpp>
 #include <magnet/containers/MinMaxHeap.hpp>
 #include <string>
 
@@ -28,16 +30,20 @@ namespace dynamo {
   std::numeric_limits<float>::infinity(), whenever the queue is cleared, or
   pop'd empty. This means no conditional logic is required to deal with the
   comparison of empty queues.
+
+  The events are stored as CompactEvents, so the whole heap of a
+  particle spans only a few cache lines.
 */
 template <size_t Size> class MinMaxPEL {
-  magnet::containers::MinMaxHeap<Event, Size> _store;
+  magnet::containers::MinMaxHeap<CompactEvent, Size> _store;
 
 public:
   static const bool partial_invalidate_support = false;
 
   MinMaxPEL() { clear(); }
 
-  inline void push(const Event &e) {
+  inline void push(const Event &event) {
+    const CompactEvent e(event);
     if (!_store.full())
       _store.insert(e);
     else {
@@ -50,7 +56,7 @@ public:
 
   inline void clear() {
     _store.clear();
-    (*_store.begin()) = Event();
+    (*_store.begin()) = CompactEvent();
   }
 
   inline size_t size() const { return _store.size(); }
@@ -63,24 +69,36 @@ public:
       clear();
   }
 
-  inline Event top() const { return *_store.begin(); }
+  inline Event top() const { return _store.begin()->expand(); }
+
+  //! \brief The next event, without expanding it to an Event.
+  inline const CompactEvent &front() const { return *_store.begin(); }
 
-  inline bool operator>(const MinMaxPEL &o) const { return top() > o.top(); }
+  inline bool operator>(const MinMaxPEL &o) const {
+    return front() > o.front();
+  }
 
-  inline bool operator<(const MinMaxPEL &o) const { return top() < o.top(); }
+  inline bool operator<(const MinMaxPEL &o) const {
+    return front() < o.front();
+  }
 
   inline void stream(const double dt) {
-    for (Event &event : _store)
+    for (CompactEvent &event : _store)
       event._dt -= dt;
   }
 
   inline void rescaleTimes(const double scale) {
-    for (Event &event : _store)
+    for (CompactEvent &event : _store)
       event._dt *= scale;
   }
 
   inline void swap(MinMaxPEL &rhs) { _store.swap(rhs._store); }
 
+  // The heap is written verbatim to preserve the order of any ties
+  inline void save(CheckpointWriter &out) const { out.write(_store); }
+
+  inline void load(CheckpointReader &in) { in.read(_store); }
+
   static inline std::string name() { return "MinMax" + std::to_string(Size); }
 };
 } // namespace dynamo
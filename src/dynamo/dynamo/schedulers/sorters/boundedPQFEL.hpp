@@ -32,6 +32,21 @@ namespace dynamo {
 namespace detail {
 template <class PEL> struct BPQEntry : public PEL {
   BPQEntry() : next(NO_LINK), previous(NO_LINK), qIndex(NO_LINK) {}
+
+  void save(CheckpointWriter &out) const {
+    PEL::save(out);
+    out.write(next);
+    out.write(previous);
+    out.write(qIndex);
+  }
+
+  void load(CheckpointReader &in) {
+    PEL::load(in);
+    in.read(next);
+    in.read(previous);
+    in.read(qIndex);
+  }
+
   size_t next, previous, qIndex;
 };
 } // namespace detail
@@ -87,6 +102,28 @@ public:
     scale /= factor;
   }
 
+  virtual void saveCheckpoint(CheckpointWriter &out) const {
+    Base::saveCheckpoint(out);
+    out.writeTag("BoundedPQ");
+    out.write(currentIndex);
+    out.write(scale);
+    out.write(nlists);
+    out.write(exceptionCount);
+    out.write(_optimizeCounter);
+    out.write(linearLists);
+  }
+
+  virtual void loadCheckpoint(CheckpointReader &in) {
+    Base::loadCheckpoint(in);
+    in.checkTag("BoundedPQ");
+    in.read(currentIndex);
+    in.read(scale);
+    in.read(nlists);
+    in.read(exceptionCount);
+    in.read(_optimizeCounter);
+    in.read(linearLists);
+  }
+
 private:
   virtual void
   flushChanges(const size_t ID = std::numeric_limits<size_t>::max()) {
@@ -111,9 +148,9 @@ private:
     size_t counter(0);
 
     for (const auto &dat : Base::_Min)
-      if (!std::isinf(dat.top()._dt)) {
-        minVal = std::min(minVal, dat.top()._dt);
-        maxVal = std::max(maxVal, dat.top()._dt);
+      if (!std::isinf(dat.front()._dt)) {
+        minVal = std::min(minVal, dat.front()._dt);
+        maxVal = std::max(maxVal, dat.front()._dt);
         ++counter;
       }
 
@@ -159,11 +196,11 @@ private:
     // Check that the Q is not empty or filled with events which will never
     // happen
     if (Base::_Min[p].empty() ||
-        (Base::_Min[p].top()._dt == std::numeric_limits<float>::infinity()))
+        (Base::_Min[p].front()._dt == std::numeric_limits<float>::infinity()))
       // Don't bother adding it to the queue.
       return;
 
-    const double dt = Base::_Min[p].top()._dt;
+    const double dt = Base::_Min[p].front()._dt;
     const double box = scale * dt;
     size_t i;
     if ((dt == -std::numeric_limits<float>::infinity()) || (box < currentIndex))
@@ -185,7 +222,7 @@ private:
     if (i >= linearLists.size())
       M_throw() << "i=" << p << " is out of range of linearLists (size()="
                 << linearLists.size() << ") box=" << box
-                << " dt=" << Base::_Min[p].top()._dt << " scale=" << scale;
+                << " dt=" << Base::_Min[p].front()._dt << " scale=" << scale;
 #endif
 
     Base::_Min[p].qIndex = i;
@@ -255,7 +292,7 @@ private:
           no_events =
               no_events &&
               ((dat.empty()) ||
-               (dat.top()._dt == std::numeric_limits<float>::infinity()));
+               (dat.front()._dt == std::numeric_limits<float>::infinity()));
           dat.stream(listWidth);
         }
         // update the peculiar time
@@ -0,0 +1,87 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <cstdint>
+#include <dynamo/eventtypes.hpp>
+#include <limits>
+#include <magnet/exception.hpp>
+
+namespace dynamo {
+/*! \brief The form of an Event stored in the particle event lists.
+
+  An Event is 48 bytes, but the IDs and additional data all fit in
+  32 bits, and the source and type in a byte each. Storing events
+  in this 32 byte form fits two events in each cache line of the
+  PELs, and they are only expanded to an Event when the sorter
+  hands them to the scheduler.
+
+  The time is kept in double precision, as rounding it would
+  reorder nearly simultaneous events. The largest 32 bit value is
+  reserved for the std::numeric_limits<size_t>::max() value used to
+  mark unset IDs and data.
+*/
+class CompactEvent {
+public:
+  double _dt;
+  uint32_t _particle1ID;
+  uint32_t _sourceID;
+  uint32_t _data1;
+  uint32_t _data2;
+  uint8_t _source;
+  uint8_t _type;
+
+  CompactEvent() : CompactEvent(Event()) {}
+
+  CompactEvent(const Event &e)
+      : _dt(e._dt), _particle1ID(pack(e._particle1ID)),
+        _sourceID(pack(e._sourceID)), _data1(pack(e._additionalData1)),
+        _data2(pack(e._additionalData2)), _source(uint8_t(e._source)),
+        _type(uint8_t(e._type)) {}
+
+  //! \brief Expand back to the full Event.
+  inline Event expand() const {
+    return Event(unpack(_particle1ID), _dt, EventSource(_source),
+                 EEventType(_type), unpack(_sourceID), unpack(_data1),
+                 unpack(_data2));
+  }
+
+  inline bool operator<(const CompactEvent &o) const { return _dt < o._dt; }
+
+  inline bool operator>(const CompactEvent &o) const { return _dt > o._dt; }
+
+  static inline uint32_t pack(const size_t val) {
+    if (val == std::numeric_limits<size_t>::max())
+      return std::numeric_limits<uint32_t>::max();
+#ifdef DYNAMO_DEBUG
+    if (val >= std::numeric_limits<uint32_t>::max())
+      M_throw() << "Value " << val
+                << " is too large to be stored in a CompactEvent";
+#endif
+    return uint32_t(val);
+  }
+
+  static inline size_t unpack(const uint32_t val) {
+    if (val == std::numeric_limits<uint32_t>::max())
+      return std::numeric_limits<size_t>::max();
+    return val;
+  }
+};
+
+static_assert(sizeof(CompactEvent) == 32,
+              "CompactEvent should fit two events in a cache line");
+} // namespace dynamo
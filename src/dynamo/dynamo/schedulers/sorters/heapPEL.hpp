@@ -17,22 +17,27 @@
 
 #pragma once
 #include <algorithm>
+#include <dynamo/checkpoint.hpp>
 #include <dynamo/eventtypes.hpp>
+#include <dynamo/schedulers/sorters/compactEvent.hpp>
 #include <functional>
 #include <vector>
 
 namespace dynamo {
 class HeapPEL {
-  std::vector<Event> _store;
+  std::vector<CompactEvent> _store;
 
 public:
   static const bool partial_invalidate_support = false;
 
-  inline void push(Event e) {
+  inline void push(const Event &e) {
     _store.push_back(e);
-    std::push_heap(_store.begin(), _store.end(), std::greater<Event>());
+    std::push_heap(_store.begin(), _store.end(),
+                   std::greater<CompactEvent>());
   }
 
+  // The capacity is kept, so a particle's storage is reused after
+  // it is invalidated.
   inline void clear() { _store.clear(); }
 
   inline size_t size() const { return _store.size(); }
@@ -40,33 +45,46 @@ public:
   inline bool empty() const { return _store.empty(); }
 
   inline void pop() {
-    std::pop_heap(_store.begin(), _store.end(), std::greater<Event>());
+    std::pop_heap(_store.begin(), _store.end(),
+                  std::greater<CompactEvent>());
     _store.pop_back();
   }
 
-  inline Event top() const {
+  inline Event top() const { return front().expand(); }
+
+  //! \brief The next event, without expanding it to an Event.
+  inline const CompactEvent &front() const {
+    static const CompactEvent none;
     if (!empty())
       return _store.front();
     else
-      return Event();
+      return none;
   }
 
-  inline bool operator>(const HeapPEL &FEL) const { return top() > FEL.top(); }
+  inline bool operator>(const HeapPEL &FEL) const {
+    return front() > FEL.front();
+  }
 
-  inline bool operator<(const HeapPEL &FEL) const { return top() < FEL.top(); }
+  inline bool operator<(const HeapPEL &FEL) const {
+    return front() < FEL.front();
+  }
 
   inline void stream(const double dt) {
-    for (Event &event : _store)
+    for (CompactEvent &event : _store)
       event._dt -= dt;
   }
 
   inline void rescaleTimes(const double scale) {
-    for (Event &event : _store)
+    for (CompactEvent &event : _store)
       event._dt *= scale;
   }
 
   inline void swap(HeapPEL &rhs) { std::swap(_store, rhs._store); }
 
+  inline void save(CheckpointWriter &out) const { out.write(_store); }
+
+  inline void load(CheckpointReader &in) { in.read(_store); }
+
   static inline std::string name() { return "Heap"; }
 };
 } // namespace dynamo
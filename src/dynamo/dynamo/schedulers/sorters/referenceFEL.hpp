@@ -16,6 +16,7 @@
 */
 
 #pragma once
+#include <dynamo/checkpoint.hpp>
 #include <dynamo/schedulers/sorters/FEL.hpp>
 
 namespace dynamo {
@@ -64,6 +65,12 @@ public:
     _store.erase(std::min_element(_store.begin(), _store.end()));
   }
 
+  virtual void saveCheckpoint(CheckpointWriter &out) const {
+    out.write(_store);
+  }
+
+  virtual void loadCheckpoint(CheckpointReader &in) { in.read(_store); }
+
 private:
   virtual void outputXML(magnet::xml::XmlStream &) const {}
 };
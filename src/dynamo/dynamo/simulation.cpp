@@ -15,9 +15,11 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <boost/filesystem.hpp>
 #include <dynamo/BC/BC.hpp>
 #include <dynamo/BC/include.hpp>
+#include <dynamo/checkpoint.hpp>
 #include <dynamo/dynamics/dynamics.hpp>
 #include <dynamo/dynamics/newtonian.hpp>
 #include <dynamo/globals/PBCSentinel.hpp>
@@ -26,6 +28,8 @@
 #include <dynamo/locals/local.hpp>
 #include <dynamo/outputplugins/misc.hpp>
 #include <dynamo/outputplugins/tickerproperty/ticker.hpp>
+#include <dynamo/pairsearch.hpp>
+#include <dynamo/ranges/IDRange.hpp>
 #include <dynamo/schedulers/neighbourlist.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/schedulers/sorters/MinMaxPEL.hpp>
@@ -34,13 +38,21 @@
 #include <dynamo/species/species.hpp>
 #include <dynamo/systems/sysTicker.hpp>
 #include <dynamo/topology/topology.hpp>
+#include <fstream>
 #include <iomanip>
 #include <set>
+#include <sstream>
 
 //! The configuration file version, a version mismatch prevents an XML file
 //! load.
 static const std::string configFileVersion("1.5.0");
 
+//! The first bytes of a checkpoint file, used to detect checkpoints.
+static const std::string checkpointMagic("DYNAMOCP");
+
+//! The checkpoint format version, a mismatch prevents a checkpoint load.
+static const uint32_t checkpointVersion(3);
+
 namespace dynamo {
 typedef BoundedPQFEL<MinMaxPEL<3>> DefaultSorter;
 
@@ -49,9 +61,10 @@ Simulation::Simulation()
       dynamics(new DynNewtonian(this)),
       scheduler(new SNeighbourList(this, new DefaultSorter())), systemTime(0.0),
       eventCount(0), endEventCount(100000), eventPrintInterval(50000),
-      nextPrintEvent(0), _force_unwrapped(false), primaryCellSize({1, 1, 1}),
-      ranGenerator(std::random_device()()), lastRunMFT(0.0), simID(0),
-      stateID(0), replexExchangeNumber(0), status(START) {}
+      nextPrintEvent(0), _force_unwrapped(false), threadCount(1),
+      primaryCellSize({1, 1, 1}), ranGenerator(std::random_device()()),
+      lastRunMFT(0.0), simID(0), stateID(0), replexExchangeNumber(0),
+      status(START) {}
 
 namespace {
 /*! \brief Hidden functor used for sorting containers of
@@ -75,12 +88,18 @@ void Simulation::reset() {
   eventCount = 0;
   nextPrintEvent = 0;
   lastRunMFT = 0.0;
+#ifdef DYNAMO_PROFILER
+  profiler.clear();
+#endif
 }
 
 void Simulation::initialise() {
   if (status != START)
     M_throw() << "Sim initialised at wrong time";
 
+  dout << "Compiling particle ranges" << std::endl;
+  compileRanges();
+
   for (shared_ptr<Species> &ptr : species)
     ptr->initialise();
 
@@ -224,8 +243,9 @@ void Simulation::initialise() {
     M_throw() << "The scheduler has not been set!";
 
   dout << "Initialising Scheduler" << std::endl;
-  if (endEventCount)
-    // Only initialise the scheduler if we're simulating
+  if (endEventCount && _checkpointData.empty())
+    // Only initialise the scheduler if we're simulating (a
+    // checkpoint restores it below)
     scheduler->initialise();
 
   status = SCHEDULER_INIT;
@@ -240,6 +260,9 @@ void Simulation::initialise() {
 
   status = OUTPUTPLUGIN_INIT;
 
+  if (!_checkpointData.empty())
+    restoreCheckpoint();
+
   _nextPrint = eventCount + eventPrintInterval;
   status = INITIALISED;
 }
@@ -336,9 +359,34 @@ void Simulation::loadXMLfile(std::string fileName) {
   if (!boost::filesystem::exists(fileName))
     M_throw() << "Could not find the XML file named " << fileName
               << "\nPlease check the file exists.";
-  dout << "Parsing the XML" << std::endl;
+  // Detect checkpoint files, which store the XML configuration
+  // followed by the binary state of the simulation
+  std::unique_ptr<Document> docptr;
+  std::string state;
+  {
+    std::ifstream file(fileName, std::ios::binary);
+    std::string magic(checkpointMagic.size(), '\0');
+    file.read(&magic[0], magic.size());
+    if (file && (magic == checkpointMagic)) {
+      dout << "Loading a checkpoint" << std::endl;
+      CheckpointReader in(file);
+      if (in.read<uint32_t>() != checkpointVersion)
+        M_throw() << "The checkpoint " << fileName
+                  << " was written by an incompatible version of DynamO";
+      std::string xml;
+      in.read(xml);
+      in.read(state);
+      dout << "Parsing the XML" << std::endl;
+      docptr.reset(new Document(xml.data(), xml.size()));
+    }
+  }
 
-  Document doc(fileName);
+  if (!docptr) {
+    dout << "Parsing the XML" << std::endl;
+    docptr.reset(new Document(fileName));
+  }
+
+  Document &doc = *docptr;
 
   dout << "Loading tags from the XML" << std::endl;
 
@@ -429,15 +477,166 @@ void Simulation::loadXMLfile(std::string fileName) {
   _properties.rescaleUnit(Property::Units::M, units.unitMass());
 
   ensemble = dynamo::Ensemble::loadEnsemble(*this);
+
+  if (!state.empty()) {
+    // Restore the state needed before initialisation, the rest is
+    // restored at the end of initialise()
+    std::istringstream is(state);
+    CheckpointReader in(is);
+    in.checkTag("Simulation");
+    in.read(systemTime);
+    in.read(eventCount);
+    in.read(lastRunMFT);
+
+    in.checkTag("RNG");
+    std::string rng;
+    in.read(rng);
+    std::istringstream(rng) >> ranGenerator;
+
+    in.checkTag("Particles");
+    if (in.read<uint64_t>() != particles.size())
+      M_throw() << "The checkpoint particle data does not match the "
+                   "configuration";
+    for (Particle &part : particles)
+      in.read(part);
+
+    in.checkTag("BC");
+    BCs->loadCheckpoint(in);
+
+    _checkpointData = state.substr(is.tellg());
+  }
+}
+
+void Simulation::writeCheckpoint(std::string fileName) {
+  if (status != INITIALISED)
+    M_throw() << "Cannot checkpoint an uninitialised simulation";
+
+  namespace xml = magnet::xml;
+  xml::XmlStream XML;
+  XML.setFormatXML(true);
+  // The particles are written unwrapped as the neighbour list cells
+  // are stored for the particles' current images.
+  writeXML(XML, false, false);
+
+  std::ostringstream state;
+  CheckpointWriter out(state);
+  out.writeTag("Simulation");
+  out.write(systemTime);
+  out.write(eventCount);
+  out.write(lastRunMFT);
+
+  out.writeTag("RNG");
+  std::ostringstream rng;
+  rng << ranGenerator;
+  out.write(rng.str());
+
+  out.writeTag("Particles");
+  out.write(particles);
+
+  out.writeTag("BC");
+  BCs->saveCheckpoint(out);
+
+  out.writeTag("Dynamics");
+  dynamics->saveCheckpoint(out);
+
+  // Globals, Systems and OutputPlugins are stored by name, as some
+  // are added at run time and may not be present when restored.
+  out.writeTag("Globals");
+  out.write<uint64_t>(globals.size());
+  for (const shared_ptr<Global> &ptr : globals) {
+    out.beginBlock(ptr->getName());
+    ptr->saveCheckpoint(out);
+    out.endBlock();
+  }
+
+  out.writeTag("Systems");
+  out.write<uint64_t>(systems.size());
+  for (const shared_ptr<System> &ptr : systems) {
+    out.beginBlock(ptr->getName());
+    ptr->saveCheckpoint(out);
+    out.endBlock();
+  }
+
+  out.writeTag("OutputPlugins");
+  out.write<uint64_t>(outputPlugins.size());
+  for (const shared_ptr<OutputPlugin> &ptr : outputPlugins) {
+    out.beginBlock(ptr->getName());
+    ptr->saveCheckpoint(out);
+    out.endBlock();
+  }
+
+  out.writeTag("Scheduler");
+  scheduler->saveCheckpoint(out);
+
+  std::ofstream file(fileName, std::ios::binary);
+  if (!file)
+    M_throw() << "Failed to open " << fileName << " for writing.";
+  file << checkpointMagic;
+  CheckpointWriter header(file);
+  header.write(checkpointVersion);
+  header.write(XML.str());
+  header.write(state.str());
+  if (!file)
+    M_throw() << "Failed while writing the checkpoint " << fileName;
+
+  dout << "Checkpoint written to " << fileName << std::endl;
+}
+
+void Simulation::restoreCheckpoint() {
+  dout << "Restoring the checkpoint state" << std::endl;
+  std::istringstream is(_checkpointData);
+  CheckpointReader in(is);
+
+  in.checkTag("Dynamics");
+  dynamics->loadCheckpoint(in);
+
+  // Restores each named object, skipping any which are missing
+  auto restoreNamed = [&](const std::string &tag, auto &container) {
+    in.checkTag(tag);
+    const uint64_t count = in.read<uint64_t>();
+    for (uint64_t i(0); i < count; ++i) {
+      const std::string name = in.beginBlock();
+      auto it = std::find_if(
+          container.begin(), container.end(),
+          [&](const auto &ptr) { return ptr->getName() == name; });
+      if (it != container.end())
+        (*it)->loadCheckpoint(in);
+      else
+        derr << "Discarding the checkpoint data of \"" << name
+             << "\" from the " << tag << ", as it is not loaded"
+             << std::endl;
+      in.endBlock();
+    }
+  };
+
+  restoreNamed("Globals", globals);
+  restoreNamed("Systems", systems);
+  restoreNamed("OutputPlugins", outputPlugins);
+
+  in.checkTag("Scheduler");
+  if (endEventCount) {
+    scheduler->loadCheckpoint(in);
+    // The Systems may have been replaced (e.g., the halt time)
+    scheduler->rebuildSystemEvents();
+  }
+
+  _checkpointData.clear();
 }
 
 void Simulation::writeXMLfile(std::string fileName, bool applyBC, bool round) {
+  magnet::xml::XmlStream XML(fileName);
+  XML.setFormatXML(true);
+  writeXML(XML, applyBC, round);
+  XML.close();
+  dout << "Config written to " << fileName << std::endl;
+}
+
+void Simulation::writeXML(magnet::xml::XmlStream &XML, bool applyBC,
+                          bool round) {
   // Facilitate forced unwrapping when needed
   applyBC = applyBC && !_force_unwrapped;
 
   namespace xml = magnet::xml;
-  xml::XmlStream XML;
-  XML.setFormatXML(true);
 
   dynamics->updateAllParticles();
 
@@ -500,14 +699,10 @@ void Simulation::writeXMLfile(std::string fileName, bool applyBC, bool round) {
 
   XML << xml::endtag("DynamOconfig");
 
-  dout << "Config written to " << fileName << std::endl;
-
   // Rescale the properties back to the simulation units
   _properties.rescaleUnit(Property::Units::L, units.unitLength());
   _properties.rescaleUnit(Property::Units::T, units.unitTime());
   _properties.rescaleUnit(Property::Units::M, units.unitMass());
-
-  XML.write_file(fileName);
 }
 
 void Simulation::replexerSwap(Simulation &other) {
@@ -673,11 +868,10 @@ double Simulation::getPackingFraction() const {
   return volume / getSimVolume();
 }
 
-size_t Simulation::checkSystem() {
+size_t Simulation::checkSystem(const bool allPairs) {
   dynamics->updateAllParticles();
 
   size_t errors = 0;
-  std::vector<Particle>::const_iterator iPtr1, iPtr2;
 
   for (const shared_ptr<Interaction> &interaction_ptr : interactions) {
     dout << "Checking Interaction \"" << interaction_ptr->getName() << "\""
@@ -685,10 +879,13 @@ size_t Simulation::checkSystem() {
     errors += interaction_ptr->validateState();
   }
 
-  dout << "Testing all particle pairs for invalid states" << std::endl;
-  for (iPtr1 = particles.begin(); iPtr1 != particles.end(); ++iPtr1)
-    for (iPtr2 = iPtr1 + 1; iPtr2 != particles.end(); ++iPtr2)
-      errors += getInteraction(*iPtr1, *iPtr2)->validateState(*iPtr1, *iPtr2);
+  if (allPairs)
+    dout << "Testing all particle pairs for invalid states" << std::endl;
+  else
+    dout << "Testing the particle pairs within the interaction range for "
+            "invalid states"
+         << std::endl;
+  errors += checkPairs(allPairs);
 
   for (const Particle &part : particles)
     for (const shared_ptr<Local> &lcl : locals)
@@ -698,12 +895,66 @@ size_t Simulation::checkSystem() {
   return errors;
 }
 
+void Simulation::compileRanges() {
+  for (const shared_ptr<Species> &ptr : species)
+    ptr->getRange()->compile(particles);
+
+  for (const shared_ptr<Interaction> &ptr : interactions)
+    ptr->getRange()->compile(particles);
+
+  for (const shared_ptr<Local> &ptr : locals)
+    if (ptr->getRange())
+      ptr->getRange()->compile(particles);
+
+  for (const shared_ptr<Global> &ptr : globals)
+    if (ptr->getRange())
+      ptr->getRange()->compile(particles);
+
+  for (const shared_ptr<Topology> &ptr : topology)
+    for (const shared_ptr<IDRange> &range : ptr->getMolecules())
+      range->compile(particles);
+}
+
+size_t Simulation::checkPairs(const bool allPairs) const {
+  typedef std::vector<std::pair<size_t, size_t>> PairList;
+  const size_t nthreads = getDiagnosticThreadCount();
+  std::vector<PairList> invalid(nthreads);
+
+  // Test the pairs quietly in parallel, then report them serially
+  // An infinite cutoff places every particle in a single cell
+  PairSearch search(this, allPairs ? HUGE_VAL : getLongestInteraction());
+  search.forEachPair(nthreads, [&](size_t block, const Particle &p1,
+                                   const Particle &p2) {
+    if (getInteraction(p1, p2)->validateState(p1, p2, false))
+      invalid[block].push_back(std::make_pair(p1.getID(), p2.getID()));
+  });
+
+  PairList pairs;
+  for (const PairList &list : invalid)
+    pairs.insert(pairs.end(), list.begin(), list.end());
+  std::sort(pairs.begin(), pairs.end());
+
+  for (const auto &IDs : pairs)
+    getInteraction(particles[IDs.first], particles[IDs.second])
+        ->validateState(particles[IDs.first], particles[IDs.second]);
+
+  return pairs.size();
+}
+
+size_t Simulation::getDiagnosticThreadCount() const {
+  for (const shared_ptr<Interaction> &interaction_ptr : interactions)
+    if (!interaction_ptr->isThreadSafe())
+      return 1;
+
+  return std::max<size_t>(threadCount, 1);
+}
+
 void Simulation::outputData(std::string filename) {
   if (status < INITIALISED)
     M_throw() << "Cannot output data when not initialised!";
 
   namespace xml = magnet::xml;
-  xml::XmlStream XML;
+  xml::XmlStream XML(filename);
   XML.setFormatXML(true);
 
   XML << std::setprecision(std::numeric_limits<double>::digits10 + 2)
@@ -716,17 +967,23 @@ void Simulation::outputData(std::string filename) {
   for (shared_ptr<Interaction> &Ptr : interactions)
     Ptr->outputData(XML);
 
+  for (shared_ptr<Global> &Ptr : globals)
+    Ptr->outputData(XML);
+
   for (shared_ptr<Local> &Ptr : locals)
     Ptr->outputData(XML);
 
   for (shared_ptr<System> &Ptr : systems)
     Ptr->outputData(XML);
 
+#ifdef DYNAMO_PROFILER
+  profiler.output(XML, *this);
+#endif
+
   XML << xml::endtag("OutputData");
+  XML.close();
 
   dout << "Output written to " << filename << std::endl;
-
-  XML.write_file(filename);
 }
 
 void Simulation::setTickerPeriod(double nP) {
@@ -20,12 +20,19 @@
 #include <dynamo/ensemble.hpp>
 #include <dynamo/eventtypes.hpp>
 #include <dynamo/particle.hpp>
+#include <dynamo/profiler.hpp>
 #include <dynamo/property.hpp>
 #include <dynamo/units/units.hpp>
 #include <magnet/function/delegate.hpp>
 #include <random>
 #include <vector>
 
+namespace magnet {
+namespace xml {
+class XmlStream;
+}
+} // namespace magnet
+
 namespace dynamo {
 class Scheduler;
 class OutputPlugin;
@@ -216,8 +223,45 @@ public:
     overlapped state, but this error state is a minor precision
     error. Therefore, there may be around 2 errors which are just
     minor precision errors and can be discounted.
+
+    Only the pairs within the longest interaction range are tested
+    (see checkPairs()), as pairs further apart cannot be in an
+    invalid state for a correctly defined Interaction. An
+    Interaction which reports a longer range than it actually has
+    will not be caught by this, so all pairs can be tested instead.
+
+    \param allPairs Test every pair of particles, which is O(N^2).
+  */
+  size_t checkSystem(bool allPairs = false);
+
+  /*! \brief Compiles the IDRange's and IDPairRange's of the
+      Species, Interactions, Locals, Globals and Topology.
+
+    This is called by initialise() once the particles are loaded,
+    and must be called again if the number of particles changes.
+  */
+  void compileRanges();
+
+  /*! \brief Tests each pair of particles within the longest
+    interaction range for an invalid state (e.g., an overlap),
+    writing a report for each one found.
+
+    The pairs are found using a PairSearch, and are tested
+    concurrently (see getDiagnosticThreadCount()). The reports are
+    written afterwards in order of the particle IDs.
+
+    \param allPairs Test every pair, regardless of their separation.
+    \return The number of invalid pairs.
+  */
+  size_t checkPairs(bool allPairs = false) const;
+
+  /*! \brief The number of threads diagnostics may use to test
+      Interactions concurrently.
+
+      This is threadCount, unless one of the Interactions is not
+      thread-safe (see Interaction::isThreadSafe()).
   */
-  size_t checkSystem();
+  size_t getDiagnosticThreadCount() const;
 
   void addSystemTicker();
 
@@ -261,10 +305,35 @@ public:
 
     \param filename The path to the XML file to load. The filename
     must end in either ".xml" (or ".xml.bz2" where bzip2 compressed
-    configuration files are supported).
+    configuration files are supported). Checkpoints written by
+    writeCheckpoint() are also detected and loaded, and the rest of
+    their state is restored by initialise().
   */
   void loadXMLfile(std::string filename);
 
+  /*! \brief Writes a binary checkpoint of an initialised Simulation
+      for a fast restart.
+
+    The checkpoint contains the configuration, as written by
+    writeXMLfile() (without applying the boundary conditions), and
+    the state which is rebuilt when a configuration is loaded: the
+    event queue of the Scheduler, the contents of the neighbour list
+    cells, the random number generator, the exact particle data and
+    the accumulators of the Systems and OutputPlugins which support
+    it (see the saveCheckpoint() functions).
+
+    A checkpoint is loaded with loadXMLfile(). The Scheduler is then
+    restored in place of being initialised, so the run resumes
+    exactly where it stopped without revalidating the configuration
+    or recalculating any events. The event count is restored, so
+    endEventCount is relative to the count when the checkpoint was
+    written.
+
+    The data is stored in the native binary format, so it may only
+    be restored by the same build of DynamO.
+  */
+  void writeCheckpoint(std::string filename);
+
   /*! \brief Writes the Simulation configuration to a file at the passed path.
 
     \param filename The path to the XML file to write (this file
@@ -349,6 +418,14 @@ public:
       periodicity (like SOCells).*/
   bool _force_unwrapped;
 
+  /*! \brief The number of threads that may be used for concurrent
+      processing while loading, initialising and during diagnostics
+      (e.g., building capture maps).
+
+      The event loop itself is always serial. This is set from the
+      "n-threads" option by the Engine and defaults to 1.*/
+  size_t threadCount;
+
   /*! \brief Number of Particle's in the system. */
   size_t N() const { return particles.size(); }
 
@@ -413,8 +490,30 @@ public:
    */
   magnet::Signal<void(const NEventData &)> _sigParticleUpdate;
 
+#ifdef DYNAMO_PROFILER
+  /*! \brief Cycle counters for the stages of the event loop.
+
+    These are only present when built with DYNAMO_PROFILER defined,
+    and are written to the output file.
+   */
+  Profiler profiler;
+#endif
+
 private:
+  //! Writes the XML configuration of the Simulation to a stream.
+  void writeXML(magnet::xml::XmlStream &, bool applyBC, bool round);
+
+  /*! \brief Restores the remaining state of a loaded checkpoint, in
+      place of initialising the Scheduler.
+   */
+  void restoreCheckpoint();
+
   size_t _nextPrint;
+
+  /*! \brief The state of a loaded checkpoint which is restored at the
+      end of initialise().
+   */
+  std::string _checkpointData;
 };
 
 } // namespace dynamo
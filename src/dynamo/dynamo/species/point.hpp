@@ -41,8 +41,6 @@ public:
     SpPoint::operator<<(XML);
   }
 
-  virtual void initialise() {}
-
   virtual void operator<<(const magnet::xml::Node &XML);
 
   virtual double getScalarMomentOfInertia(size_t ID) const {
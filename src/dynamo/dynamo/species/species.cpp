@@ -22,6 +22,10 @@
 namespace dynamo {
 Species::~Species() {}
 
+void Species::initialise() {
+  _massColumn = _mass->getColumn(Sim->N()).foldUniform(*range);
+}
+
 shared_ptr<Species> Species::getClass(const magnet::xml::Node &XML,
                                       dynamo::Simulation *tmp, size_t nID) {
   if (!XML.getAttribute("Type").getValue().compare("Point"))
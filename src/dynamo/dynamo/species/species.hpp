@@ -43,8 +43,13 @@ public:
   inline bool isSpecies(const Particle &p1) const {
     return range->isInRange(p1);
   }
+  /*! \brief The mass of a particle of this Species.
+
+    Before the Species is initialised (e.g., while a configuration is
+    being built) the mass Property is read directly.
+   */
   inline const double getMass(size_t ID) const {
-    return _mass->getProperty(ID);
+    return _massColumn.valid() ? _massColumn[ID] : _mass->getProperty(ID);
   }
   inline unsigned long getCount() const { return range->size(); }
   inline unsigned int getID() const { return ID; }
@@ -54,7 +59,12 @@ public:
 
   virtual void operator<<(const magnet::xml::Node &) = 0;
 
-  virtual void initialise() = 0;
+  /*! \brief Resolves the mass Property of the Species.
+
+    If the mass is the same for every particle of the Species it is
+    folded into a constant.
+   */
+  virtual void initialise();
 
   friend magnet::xml::XmlStream &operator<<(magnet::xml::XmlStream &,
                                             const Species &);
@@ -78,6 +88,8 @@ protected:
   virtual void outputXML(magnet::xml::XmlStream &) const = 0;
 
   shared_ptr<Property> _mass;
+  //! The resolved _mass, valid once the Species is initialised.
+  PropertyColumn _massColumn;
   shared_ptr<IDRange> range;
   std::string spName;
   unsigned int ID;
@@ -19,19 +19,22 @@
 
 #include <dynamo/BC/BC.hpp>
 #include <dynamo/NparticleEventData.hpp>
+#include <dynamo/checkpoint.hpp>
 #include <dynamo/dynamics/dynamics.hpp>
 #include <dynamo/outputplugins/outputplugin.hpp>
 #include <dynamo/particle.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/species/species.hpp>
 #include <dynamo/units/units.hpp>
+#include <magnet/thread/parallel_for.hpp>
 #include <magnet/xmlreader.hpp>
 #include <magnet/xmlwriter.hpp>
+#include <numeric>
 
 namespace dynamo {
 SysDSMCSpheres::SysDSMCSpheres(const magnet::xml::Node &XML,
                                dynamo::Simulation *tmp)
-    : System(tmp), maxprob(0.0) {
+    : System(tmp), maxprob(0.0), cellWidth(0), overlapFraction(0) {
   dt = std::numeric_limits<float>::infinity();
   SysDSMCSpheres::operator<<(XML);
   type = DSMC;
@@ -39,15 +42,21 @@ SysDSMCSpheres::SysDSMCSpheres(const magnet::xml::Node &XML,
 
 SysDSMCSpheres::SysDSMCSpheres(dynamo::Simulation *nSim, double nd,
                                double ntstp, double nChi, double ne,
-                               std::string nName, IDRange *r1, IDRange *r2)
+                               std::string nName, IDRange *r1, IDRange *r2,
+                               double ncellWidth)
     : System(nSim), tstep(ntstp), chi(nChi), d2(nd * nd), diameter(nd),
-      maxprob(0.0), e(ne), range1(r1), range2(r2) {
+      maxprob(0.0), e(ne), cellWidth(ncellWidth), range1(r1), range2(r2),
+      overlapFraction(0) {
   sysName = nName;
   type = DSMC;
 }
 
 NEventData SysDSMCSpheres::runEvent() {
   dt = tstep;
+
+  if (cellWidth > 0)
+    return runCellEvent();
+
   std::normal_distribution<> norm_sampler;
   std::uniform_real_distribution<> uniform_sampler;
   std::uniform_int_distribution<size_t> id1sampler(0, range1->size() - 1);
@@ -83,7 +92,11 @@ NEventData SysDSMCSpheres::runEvent() {
     // This is the extra diameter term missing from the "factor" variable
     rij *= diameter / rij.nrm();
 
-    if (Sim->dynamics->DSMCSpheresTest(p1, p2, maxprob, factor, rij)) {
+    const double prob =
+        Sim->dynamics->DSMCSpheresProbability(p1, p2, factor, rij);
+    maxprob = std::max(maxprob, prob);
+
+    if (prob > uniform_sampler(Sim->ranGenerator) * maxprob) {
       ++Sim->eventCount;
       retval.L2partChanges.push_back(
           PairEventData(Sim->dynamics->DSMCSpheresRun(p1, p2, e, rij)));
@@ -92,9 +105,150 @@ NEventData SysDSMCSpheres::runEvent() {
   return retval;
 }
 
+size_t SysDSMCSpheres::getCellID(const Particle &p) const {
+  Vector pos = p.getPosition();
+  Sim->BCs->applyBC(pos);
+
+  size_t retval = 0;
+  for (size_t iDim = NDIM; iDim-- > 0;) {
+    const double coord =
+        std::floor((pos[iDim] + 0.5 * Sim->primaryCellSize[iDim]) /
+                   cellDimension[iDim]);
+    // Particles outside of the primary image (non-periodic
+    // boundaries) are placed in the edge cells
+    const size_t cell = static_cast<size_t>(std::min(
+        std::max(coord, 0.0), static_cast<double>(cellCount[iDim] - 1)));
+    retval = retval * cellCount[iDim] + cell;
+  }
+  return retval;
+}
+
+void SysDSMCSpheres::binIDs(const std::vector<size_t> &IDs,
+                            std::vector<size_t> &start,
+                            std::vector<size_t> &contents) const {
+  const size_t ncells = cellCount[0] * cellCount[1] * cellCount[2];
+  std::vector<size_t> cellIDs(IDs.size());
+
+  magnet::thread::parallel_for(
+      0, IDs.size(), Sim->threadCount, [&](size_t, size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+          Particle &p = Sim->particles[IDs[i]];
+          Sim->dynamics->updateParticle(p);
+          cellIDs[i] = getCellID(p);
+        }
+      });
+
+  // A counting sort of the IDs by their cell
+  start.assign(ncells + 1, 0);
+  for (const size_t cell : cellIDs)
+    ++start[cell + 1];
+  std::partial_sum(start.begin(), start.end(), start.begin());
+
+  contents.resize(IDs.size());
+  std::vector<size_t> fill(start.begin(), start.end() - 1);
+  for (size_t i = 0; i < IDs.size(); ++i)
+    contents[fill[cellIDs[i]]++] = IDs[i];
+}
+
+NEventData SysDSMCSpheres::runCellEvent() {
+  std::vector<size_t> start1, contents1, start2, contents2;
+  binIDs(cellIDs1, start1, contents1);
+  binIDs(cellIDs2, start2, contents2);
+
+  // The factor was calculated with the mean density of range2, this
+  // corrects the number of candidate pairs in each cell to its local
+  // density (the NTC scheme).
+  const double cellVolume =
+      cellDimension[0] * cellDimension[1] * cellDimension[2];
+  const double densityFactor =
+      Sim->getSimVolume() / (cellVolume * range2->size());
+
+  // Each block of cells gets its own random number stream, its own
+  // estimate of maxprob and its own list of collisions, which are
+  // merged in block order afterwards.
+  const size_t nthreads = Sim->dynamics->isDSMCThreadSafe()
+                              ? std::max<size_t>(1, Sim->threadCount)
+                              : 1;
+  std::vector<baseRNG::result_type> seeds(nthreads);
+  for (auto &seed : seeds)
+    seed = Sim->ranGenerator();
+  std::vector<double> blockMaxprob(nthreads, maxprob);
+  std::vector<std::vector<PairEventData>> blockEvents(nthreads);
+
+  const size_t nblocks = magnet::thread::parallel_for(
+      0, start1.size() - 1, nthreads,
+      [&](size_t block, size_t cellBegin, size_t cellEnd) {
+        baseRNG rng(seeds[block]);
+        std::normal_distribution<> norm_sampler;
+        std::uniform_real_distribution<> uniform_sampler;
+        double &localMaxprob = blockMaxprob[block];
+        std::vector<PairEventData> &events = blockEvents[block];
+
+        for (size_t cell = cellBegin; cell < cellEnd; ++cell) {
+          const size_t n1 = start1[cell + 1] - start1[cell];
+          const size_t n2 = start2[cell + 1] - start2[cell];
+          if (!n1 || !n2)
+            continue;
+
+          // A particle of range1 cannot pair with itself, so on
+          // average it has n2 - overlapFraction partners
+          const size_t nmax = static_cast<size_t>(
+              0.5 * localMaxprob * n1 * (n2 - overlapFraction) *
+                  densityFactor +
+              uniform_sampler(rng));
+
+          std::uniform_int_distribution<size_t> id1sampler(start1[cell],
+                                                           start1[cell + 1] -
+                                                               1);
+          std::uniform_int_distribution<size_t> id2sampler(start2[cell],
+                                                           start2[cell + 1] -
+                                                               1);
+
+          for (size_t n = 0; n < nmax; ++n) {
+            Particle &p1(Sim->particles[contents1[id1sampler(rng)]]);
+            size_t p2id = contents2[id2sampler(rng)];
+
+            // Find another particle which is not p1, if p1 is the only
+            // candidate partner in this cell the pair is rejected
+            if ((p2id == p1.getID()) && (n2 == 1))
+              continue;
+            while (p2id == p1.getID())
+              p2id = contents2[id2sampler(rng)];
+
+            Particle &p2(Sim->particles[p2id]);
+
+            Vector rij;
+            for (size_t iDim(0); iDim < NDIM; ++iDim)
+              rij[iDim] = norm_sampler(rng);
+            rij *= diameter / rij.nrm();
+
+            const double prob =
+                Sim->dynamics->DSMCSpheresProbability(p1, p2, factor, rij);
+            localMaxprob = std::max(localMaxprob, prob);
+
+            if (prob > uniform_sampler(rng) * localMaxprob)
+              events.push_back(Sim->dynamics->DSMCSpheresRun(p1, p2, e, rij));
+          }
+        }
+      });
+
+  NEventData retval;
+  for (size_t block = 0; block < nblocks; ++block) {
+    maxprob = std::max(maxprob, blockMaxprob[block]);
+    Sim->eventCount += blockEvents[block].size();
+    retval.L2partChanges.insert(retval.L2partChanges.end(),
+                                blockEvents[block].begin(),
+                                blockEvents[block].end());
+  }
+  return retval;
+}
+
 void SysDSMCSpheres::initialise(size_t nID) {
   ID = nID;
   dt = tstep;
+  // The candidate pairs are drawn by indexing into the ranges
+  range1->compile(Sim->particles);
+  range2->compile(Sim->particles);
 
   // An extra factor of diameter is missing here, which is used to
   // give the vector rij below and in runEvent the "correct"
@@ -103,6 +257,41 @@ void SysDSMCSpheres::initialise(size_t nID) {
   factor = 4.0 * range2->size() * diameter * M_PI * chi * tstep /
            Sim->getSimVolume();
 
+  if (cellWidth > 0) {
+    for (size_t iDim(0); iDim < NDIM; ++iDim) {
+      cellCount[iDim] = std::max<size_t>(
+          1, static_cast<size_t>(Sim->primaryCellSize[iDim] / cellWidth));
+      cellDimension[iDim] = Sim->primaryCellSize[iDim] / cellCount[iDim];
+    }
+
+    dout << "DSMC cells " << cellCount[0] << "x" << cellCount[1] << "x"
+         << cellCount[2] << std::endl;
+
+    for (const auto &IDs : {std::make_pair(range1.get(), &cellIDs1),
+                            std::make_pair(range2.get(), &cellIDs2)}) {
+      std::vector<bool> seen(Sim->N(), false);
+      IDs.second->clear();
+      for (const size_t ID : *IDs.first)
+        if (!seen[ID]) {
+          seen[ID] = true;
+          IDs.second->push_back(ID);
+        }
+    }
+
+    std::vector<bool> inRange2(Sim->N(), false);
+    for (const size_t ID : cellIDs2)
+      inRange2[ID] = true;
+    size_t overlap = 0;
+    for (const size_t ID : cellIDs1)
+      overlap += inRange2[ID];
+    overlapFraction = double(overlap) / cellIDs1.size();
+
+    if (!Sim->dynamics->isDSMCThreadSafe() && (Sim->threadCount > 1))
+      dout << "The Dynamics are not thread safe for DSMC, the cells are "
+              "processed serially"
+           << std::endl;
+  }
+
   if (maxprob == 0.0) {
     std::normal_distribution<> norm_sampler;
     std::uniform_int_distribution<size_t> id1sampler(0, range1->size() - 1);
@@ -128,7 +317,8 @@ void SysDSMCSpheres::initialise(size_t nID) {
 
       rij *= diameter / rij.nrm();
 
-      Sim->dynamics->DSMCSpheresTest(p1, p2, maxprob, factor, rij);
+      maxprob = std::max(
+          maxprob, Sim->dynamics->DSMCSpheresProbability(p1, p2, factor, rij));
     }
   }
 
@@ -157,6 +347,19 @@ void SysDSMCSpheres::operator<<(const magnet::xml::Node &XML) {
   range2 = shared_ptr<IDRange>(IDRange::getClass(subRangeXML, Sim));
   if (XML.hasAttribute("MaxProbability"))
     maxprob = XML.getAttribute("MaxProbability").as<double>();
+  if (XML.hasAttribute("CellWidth"))
+    cellWidth =
+        XML.getAttribute("CellWidth").as<double>() * Sim->units.unitLength();
+}
+
+void SysDSMCSpheres::saveCheckpoint(CheckpointWriter &out) const {
+  System::saveCheckpoint(out);
+  out.write(maxprob);
+}
+
+void SysDSMCSpheres::loadCheckpoint(CheckpointReader &in) {
+  System::loadCheckpoint(in);
+  in.read(maxprob);
 }
 
 void SysDSMCSpheres::outputXML(magnet::xml::XmlStream &XML) const {
@@ -165,7 +368,12 @@ void SysDSMCSpheres::outputXML(magnet::xml::XmlStream &XML) const {
       << tstep / Sim->units.unitTime() << magnet::xml::attr("Chi") << chi
       << magnet::xml::attr("Diameter") << diameter / Sim->units.unitLength()
       << magnet::xml::attr("Inelasticity") << e << magnet::xml::attr("Name")
-      << sysName << magnet::xml::attr("MaxProbability") << maxprob << range1
-      << range2 << magnet::xml::endtag("System");
+      << sysName << magnet::xml::attr("MaxProbability") << maxprob;
+
+  if (cellWidth > 0)
+    XML << magnet::xml::attr("CellWidth")
+        << cellWidth / Sim->units.unitLength();
+
+  XML << range1 << range2 << magnet::xml::endtag("System");
 }
 } // namespace dynamo
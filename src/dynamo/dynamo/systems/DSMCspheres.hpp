@@ -19,14 +19,33 @@
 #include <dynamo/ranges/IDRange.hpp>
 #include <dynamo/simulation.hpp>
 #include <dynamo/systems/system.hpp>
+#include <vector>
 
 namespace dynamo {
+/*! \brief An Enskog DSMC (ESMC) collision system for hard spheres.
+
+  Every tStep, candidate pairs of particles are drawn from range1
+  and range2 and collided with a probability proportional to their
+  approach velocity.
+
+  By default, the collision partners are drawn from the entire
+  ranges. If a CellWidth is set, the primary image is divided into
+  cells at least this wide and the candidate pairs are only drawn
+  from within each cell, following Bird's no-time-counter (NTC)
+  scheme with the local density of each cell. The cells are
+  processed in parallel (see Simulation::threadCount), each thread
+  using its own random number stream seeded from the simulation's
+  generator, so runs are reproducible for a fixed thread count. The
+  cells are only processed in parallel if the Dynamics allow it (see
+  Dynamics::isDSMCThreadSafe), as the collisions of different cells
+  are then run concurrently.
+ */
 class SysDSMCSpheres : public System {
 public:
   SysDSMCSpheres(const magnet::xml::Node &XML, dynamo::Simulation *);
 
   SysDSMCSpheres(dynamo::Simulation *, double, double, double, double,
-                 std::string, IDRange *, IDRange *);
+                 std::string, IDRange *, IDRange *, double cellWidth = 0);
 
   virtual NEventData runEvent();
 
@@ -34,9 +53,26 @@ public:
 
   virtual void operator<<(const magnet::xml::Node &);
 
+  virtual void saveCheckpoint(CheckpointWriter &) const;
+  virtual void loadCheckpoint(CheckpointReader &);
+
 protected:
   virtual void outputXML(magnet::xml::XmlStream &) const;
 
+  NEventData runCellEvent();
+
+  /*! \brief Sorts the IDs by the DSMC cell of the particles,
+      bringing the particles up to date.
+
+    \param IDs The unique particle IDs to sort.
+    \param start Set to the offset of each cell's contents in \c
+    contents (with a trailing entry for the end).
+   */
+  void binIDs(const std::vector<size_t> &IDs, std::vector<size_t> &start,
+              std::vector<size_t> &contents) const;
+
+  size_t getCellID(const Particle &) const;
+
   double tstep;
   double chi;
   double d2;
@@ -44,8 +80,26 @@ protected:
   mutable double maxprob;
   double e;
   double factor;
+  //! The minimum width of the DSMC cells, zero to disable the cells.
+  double cellWidth;
+  std::array<size_t, 3> cellCount;
+  Vector cellDimension;
 
   shared_ptr<IDRange> range1;
   shared_ptr<IDRange> range2;
+  /*! \brief The IDs of range1 and range2 without duplicates, which
+      are binned into the cells.
+
+    A particle listed twice would otherwise be updated by two threads
+    at once, and be drawn twice as often as its neighbours.
+   */
+  std::vector<size_t> cellIDs1;
+  std::vector<size_t> cellIDs2;
+  /*! \brief The fraction of cellIDs1 which is also in cellIDs2.
+
+    These particles are not candidate partners of themselves, which
+    reduces the number of candidate pairs in each cell.
+   */
+  double overlapFraction;
 };
 } // namespace dynamo
@@ -19,6 +19,7 @@
 
 #include <dynamo/BC/BC.hpp>
 #include <dynamo/NparticleEventData.hpp>
+#include <dynamo/checkpoint.hpp>
 #include <dynamo/dynamics/dynamics.hpp>
 #include <dynamo/outputplugins/outputplugin.hpp>
 #include <dynamo/particle.hpp>
@@ -94,6 +95,20 @@ void SysAndersen::operator<<(const magnet::xml::Node &XML) {
   range = shared_ptr<IDRange>(IDRange::getClass(XML.getNode("IDRange"), Sim));
 }
 
+void SysAndersen::saveCheckpoint(CheckpointWriter &out) const {
+  System::saveCheckpoint(out);
+  out.write(meanFreeTime);
+  out.write(eventCount);
+  out.write(lastlNColl);
+}
+
+void SysAndersen::loadCheckpoint(CheckpointReader &in) {
+  System::loadCheckpoint(in);
+  in.read(meanFreeTime);
+  in.read(eventCount);
+  in.read(lastlNColl);
+}
+
 void SysAndersen::outputXML(magnet::xml::XmlStream &XML) const {
   XML << magnet::xml::tag("System") << magnet::xml::attr("Type") << "Andersen"
       << magnet::xml::attr("Name") << sysName << magnet::xml::attr("MFT")
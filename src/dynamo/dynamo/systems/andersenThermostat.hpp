@@ -41,6 +41,9 @@ public:
   }
   void setReducedTemperature(double nT);
 
+  virtual void saveCheckpoint(CheckpointWriter &) const;
+  virtual void loadCheckpoint(CheckpointReader &);
+
   virtual void replicaExchange(System &os) {
     SysAndersen &s = static_cast<SysAndersen &>(os);
     std::swap(dt, s.dt);
@@ -19,8 +19,8 @@
 
 #include <dynamo/BC/BC.hpp>
 #include <dynamo/NparticleEventData.hpp>
-#include <dynamo/dynamics/dynamics.hpp>
-#include <dynamo/outputplugins/outputplugin.hpp>
+#include <dynamo/dynamics/newtonian.hpp>
+#include <dynamo/outputplugins/misc.hpp>
 #include <dynamo/particle.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/species/species.hpp>
@@ -59,7 +59,16 @@ void SysRescale::checker(const NEventData &) {
 
 NEventData SysRescale::runEvent() {
   ++Sim->eventCount;
-  const double currentkT(Sim->dynamics->getkT() / Sim->units.unitEnergy());
+  // The Misc plugin tracks the kinetic energy as events are run, so
+  // use it to avoid a sweep over the particles. This is only exact
+  // if the kinetic energy is constant between events.
+  shared_ptr<const OPMisc> misc;
+  const Dynamics &dynamics = *Sim->dynamics;
+  if (typeid(dynamics) == typeid(DynNewtonian))
+    misc = Sim->getOutputPlugin<OPMisc>();
+  const double currentkT(
+      (misc ? misc->getCurrentkT() : Sim->dynamics->getkT()) /
+      Sim->units.unitEnergy());
 
   dout << "Rescaling kT " << currentkT << " To "
        << _kT / Sim->units.unitEnergy() << std::endl;
@@ -16,6 +16,7 @@
 */
 
 #include <dynamo/NparticleEventData.hpp>
+#include <dynamo/checkpoint.hpp>
 #include <dynamo/dynamics/dynamics.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/simulation.hpp>
@@ -118,4 +119,16 @@ void SysSnapshot::setTickerPeriod(const double &nP) {
   if ((Sim->status >= INITIALISED) && Sim->endEventCount)
     Sim->scheduler->rebuildSystemEvents();
 }
+
+void SysSnapshot::saveCheckpoint(CheckpointWriter &out) const {
+  System::saveCheckpoint(out);
+  out.write(_saveCounter);
+  out.write(_lastEventCount);
+}
+
+void SysSnapshot::loadCheckpoint(CheckpointReader &in) {
+  System::loadCheckpoint(in);
+  in.read(_saveCounter);
+  in.read(_lastEventCount);
+}
 } // namespace dynamo
@@ -48,6 +48,9 @@ public:
 
   void setTickerPeriod(const double &);
 
+  virtual void saveCheckpoint(CheckpointWriter &) const;
+  virtual void loadCheckpoint(CheckpointReader &);
+
 protected:
   void eventCallback(const NEventData &);
   virtual void outputXML(magnet::xml::XmlStream &) const {}
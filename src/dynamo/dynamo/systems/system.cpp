@@ -16,6 +16,7 @@
 */
 
 #include <cstring>
+#include <dynamo/checkpoint.hpp>
 #include <dynamo/particle.hpp>
 #include <dynamo/systems/DSMCspheres.hpp>
 #include <dynamo/systems/andersenThermostat.hpp>
@@ -35,6 +36,10 @@ System::System(dynamo::Simulation *tmp)
   type = VIRTUAL;
 }
 
+void System::saveCheckpoint(CheckpointWriter &out) const { out.write(dt); }
+
+void System::loadCheckpoint(CheckpointReader &in) { in.read(dt); }
+
 magnet::xml::XmlStream &operator<<(magnet::xml::XmlStream &XML,
                                    const System &g) {
   g.outputXML(XML);
@@ -27,6 +27,8 @@ class XmlStream;
 } // namespace magnet
 namespace dynamo {
 class NEventData;
+class CheckpointWriter;
+class CheckpointReader;
 
 class System : public dynamo::SimBase {
 public:
@@ -64,6 +66,17 @@ public:
 
   virtual void outputData(magnet::xml::XmlStream &) const {}
 
+  /*! \brief Write the time to the next event, and any other state
+      which cannot be rebuilt from the configuration, to a checkpoint
+      (see Simulation::writeCheckpoint).
+   */
+  virtual void saveCheckpoint(CheckpointWriter &) const;
+
+  /*! \brief Restore the state written by saveCheckpoint(), after
+      the System has been initialised.
+   */
+  virtual void loadCheckpoint(CheckpointReader &);
+
 protected:
   virtual void outputXML(magnet::xml::XmlStream &) const = 0;
 
@@ -33,6 +33,10 @@ public:
 
   void increasedt(double);
 
+  // The halt time is set for each run, and is not restored
+  virtual void saveCheckpoint(CheckpointWriter &) const {}
+  virtual void loadCheckpoint(CheckpointReader &) {}
+
   virtual void replicaExchange(System &os) {
     auto s = static_cast<SystHalt &>(os);
     std::swap(dt, s.dt);
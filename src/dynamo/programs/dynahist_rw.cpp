@@ -16,21 +16,28 @@
 */
 
 #include <magnet/exception.hpp>
+#include <magnet/thread/threadpool.hpp>
 #include <magnet/xmlreader.hpp>
 
+#include <Eigen/Dense>
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 #include <unordered_map>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <fenv.h>
 #include <fstream>
 #include <iomanip>
 #include <iosfwd>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace std;
@@ -39,10 +46,11 @@ using namespace boost;
 const size_t NGamma = 1;
 
 // Set in the main function
-static long double alpha;
-static long double minErr = 1e-16;
-static size_t NStepsPerStep = 0;
+static long double minErr = 1e-14;
+static size_t maxIterations = 1000;
+static size_t NStepsPerStep = 10;
 static boost::program_options::variables_map vm;
+static magnet::thread::ThreadPool threads;
 
 long double betaMax;
 long double betaMin;
@@ -51,15 +59,42 @@ struct SimulationData;
 
 std::vector<SimulationData> SimulationDataData;
 
+/*! \brief Terms of a log-sum-exp smaller than this (relative to the
+    largest term) are skipped.
+
+    The long double epsilon is 2^-63 (about e^-43.7), so skipped
+    terms cannot change the sum; the extra margin is for sums of
+    many small terms. It also keeps std::exp well away from
+    underflow, which would trip the floating point trap.
+ */
+static const long double LSECutoff = -64;
+
 struct SimulationData {
-  SimulationData(std::string nfn)
-      : fileName(nfn), logZ(0.0), new_logZ(0.0), refZ(false) {
-    using namespace magnet::xml;
+  SimulationData() : logZ(0.0), binWidth(0) {}
+
+  /*! \brief Load the histogram from the binary cache next to the
+      output file if it is up to date, otherwise parse the XML (and
+      write the cache for the next run).
+   */
+  void load(std::string nfn, bool useCache) {
+    fileName = nfn;
 
     if (!boost::filesystem::exists(fileName))
       M_throw() << "Could not find the XML file named " << fileName
                 << "\nPlease check the file exists.";
 
+    if (useCache && loadCache())
+      return;
+
+    loadXML();
+
+    if (useCache)
+      saveCache();
+  }
+
+  void loadXML() {
+    using namespace magnet::xml;
+
     Document doc(fileName);
 
     Node mainNode = doc.getNode("OutputData");
@@ -68,7 +103,7 @@ struct SimulationData {
     if (!(mainNode.hasNode("EnergyHist")))
       M_throw()
           << "Could not find the Internal Energy Histogram in output file "
-          << nfn;
+          << fileName;
 
     if (!(mainNode.getNode("EnergyHist").hasAttribute("BinWidth")))
       M_throw() << "Could not find the BinWidth attribute in the Internal "
@@ -98,13 +133,6 @@ struct SimulationData {
       }
     }
 
-    std::cout << "W for file " << nfn;
-    for (std::unordered_map<int, double>::iterator iPtr = _W.begin();
-         iPtr != _W.end(); ++iPtr)
-      std::cout << "\nE = " << iPtr->first * binWidth
-                << ", W = " << iPtr->second;
-    std::cout << std::endl;
-
     // Now navigate to the histogram and load the data
     std::istringstream HistogramData(std::string(
         mainNode.getNode("EnergyHist").getNode("HistogramWeighted")));
@@ -122,6 +150,102 @@ struct SimulationData {
     }
   }
 
+  std::string cacheName() const { return fileName + ".histcache"; }
+
+  /*! \brief The header of the binary histogram cache, used to detect
+      stale caches or caches written on a different platform.
+   */
+  struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t sizeofLongDouble;
+    int64_t sourceSize;
+    int64_t sourceTime;
+  };
+
+  CacheHeader makeCacheHeader() const {
+    CacheHeader header = {
+        {'D', 'Y', 'N', 'A', 'H', 'I', 'S', 'T'},
+        1,
+        sizeof(long double),
+        int64_t(boost::filesystem::file_size(fileName)),
+        int64_t(boost::filesystem::last_write_time(fileName))};
+    return header;
+  }
+
+  template <class T> static void writeBinary(std::ostream &os, const T &val) {
+    os.write(reinterpret_cast<const char *>(&val), sizeof(T));
+  }
+
+  template <class T> static void readBinary(std::istream &is, T &val) {
+    is.read(reinterpret_cast<char *>(&val), sizeof(T));
+  }
+
+  bool loadCache() {
+    std::ifstream is(cacheName(), std::ios::binary);
+    if (!is)
+      return false;
+
+    const CacheHeader expected = makeCacheHeader();
+    CacheHeader header;
+    readBinary(is, header);
+    if (!is || !std::equal(header.magic, header.magic + 8, expected.magic) ||
+        (header.version != expected.version) ||
+        (header.sizeofLongDouble != expected.sizeofLongDouble) ||
+        (header.sourceSize != expected.sourceSize) ||
+        (header.sourceTime != expected.sourceTime))
+      return false;
+
+    uint64_t NW, NData;
+    long double gamma0;
+    readBinary(is, binWidth);
+    readBinary(is, gamma0);
+    readBinary(is, NW);
+    for (uint64_t i(0); i < NW && is; ++i) {
+      int32_t E;
+      double W;
+      readBinary(is, E);
+      readBinary(is, W);
+      _W[E] = W;
+    }
+    readBinary(is, NData);
+    data.resize(NData);
+    if (NData)
+      is.read(reinterpret_cast<char *>(data.data()),
+              NData * sizeof(histogramEntry));
+
+    if (!is) {
+      _W.clear();
+      data.clear();
+      return false;
+    }
+
+    gamma.assign(1, gamma0);
+    return true;
+  }
+
+  void saveCache() const {
+    std::ofstream os(cacheName(), std::ios::binary | std::ios::trunc);
+    if (!os) {
+      std::cerr << "Warning: could not write the histogram cache "
+                << cacheName() << "\n";
+      return;
+    }
+
+    writeBinary(os, makeCacheHeader());
+    writeBinary(os, binWidth);
+    writeBinary(os, gamma[0]);
+    writeBinary(os, uint64_t(_W.size()));
+    for (const auto &W : _W) {
+      writeBinary(os, int32_t(W.first));
+      writeBinary(os, W.second);
+    }
+    writeBinary(os, uint64_t(data.size()));
+    if (!data.empty())
+      os.write(reinterpret_cast<const char *>(data.data()),
+               data.size() * sizeof(histogramEntry));
+  }
+
   bool operator<(const SimulationData &d2) const {
     return gamma[0] < d2.gamma[0];
   }
@@ -133,9 +257,7 @@ struct SimulationData {
   std::string fileName;
   std::vector<long double> gamma;
   long double logZ;
-  long double new_logZ;
   long double binWidth;
-  bool refZ;
 
   // Contains the histogram, first axis is bin entry
   // second axis is value of X with the final entry being the probability
@@ -148,68 +270,6 @@ struct SimulationData {
 
   std::unordered_map<int, double> _W;
 
-  // Bottom and top contain the window of systems used for the calculation
-  long double calc_logZ(size_t bottom = 0, size_t top = 0) const {
-    long double sum1 = 0.0;
-
-    // If top = 0, then use all systems
-    if (top == 0)
-      top = SimulationDataData.size() - 1;
-
-    for (size_t i(bottom); i <= top; ++i)
-      for (const histogramEntry &simdat : SimulationDataData[i].data) {
-        long double sum2 = 0.0;
-
-        for (size_t j(bottom); j <= top; ++j) {
-          // Determine (\gamma_i- \gamma) \cdot X
-          long double dot = 0.0;
-
-          if (NGamma != 1)
-            M_throw() << "For multiple gamma reweighting, one must be "
-                         "designated as E and used in the W lookup";
-
-          {
-            const int i = 0;
-            dot += (SimulationDataData[j].gamma[i] - gamma[i]) * simdat.X[i] +
-                   SimulationDataData[j].W(simdat.X[i]) - W(simdat.X[i]);
-          }
-
-          // This is Z^{-1} \exp[(\gamma_i- \gamma) \cdot X + W_i(X) - W(X)]
-          sum2 += exp(dot - SimulationDataData[j].logZ);
-        }
-
-        // simdat.Probability is H(X,\gamma), in the input H is
-        // normalised. Thus this assumes that all simulations are of
-        // the same statistical weight! (This is true for results
-        // from a single replica exchange simulation)
-        sum1 += simdat.Probability / sum2;
-      }
-
-    return log(sum1);
-  }
-
-  void recalc_newlogZ(size_t bottom, size_t top) {
-    if (!refZ)
-      new_logZ = calc_logZ(bottom, top);
-  }
-
-  long double calc_error() {
-    // Return an error of 0 if this is the reference simulation!
-    if (refZ)
-      return 0;
-
-    // In case of new_logZ going to zero don't use relative values
-    if (new_logZ == 0) {
-      if (logZ == 0)
-        return 0;
-      else
-        return fabs((new_logZ - logZ) / logZ);
-    } else
-      return fabs((new_logZ - logZ) / new_logZ);
-  }
-
-  void iterate_logZ() { logZ = new_logZ; }
-
   inline double W(double E) const {
     std::unordered_map<int, double>::const_iterator iPtr =
         _W.find(lrint(E / binWidth));
@@ -233,88 +293,250 @@ typedef std::map<SimulationData::histogramEntry::Xtype, ldbl> densOStatesMap;
 typedef std::vector<densOStatesPair> densOStatesType;
 densOStatesType densOStates;
 
-void solveWeightsInRange(size_t bottom = 0, size_t top = 0) {
-  // If top = 0, then use all systems
-  if (top == 0)
-    top = SimulationDataData.size() - 1;
+/*! \brief The pooled histogram data used to solve for the logZ's.
+
+  Every histogram is assumed to be normalised and of equal
+  statistical weight (true for the output of a single replica
+  exchange run). The logZ's then minimise the (convex) MBAR
+  objective
+  \f[ F(\ln Z) = \sum_X N(X) \ln\sum_k e^{a_k(X) - \ln Z_k} + \sum_k \ln Z_k
+  \f]
+  where \f$N(X)\f$ is the pooled histogram and \f$a_k(X) = \gamma_k
+  X + W_k(X)\f$. The stationary point of F is the usual
+  multiple-histogram self-consistent solution.
+ */
+struct PooledHistogram {
+  //! The total histogram weight N(X) for each distinct X
+  std::vector<long double> N;
+  //! a_k(X) stored as [X][k]
+  std::vector<long double> a;
+  size_t K = 0;
+
+  void build() {
+    K = SimulationDataData.size();
+    densOStatesMap pooled;
+    for (const SimulationData &dat : SimulationDataData)
+      for (const SimulationData::histogramEntry &simdat : dat.data)
+        pooled[simdat.X] += simdat.Probability;
+
+    N.clear();
+    a.clear();
+    N.reserve(pooled.size());
+    a.reserve(pooled.size() * K);
+    for (const auto &entry : pooled) {
+      N.push_back(entry.second);
+      for (const SimulationData &dat : SimulationDataData) {
+        if (NGamma != 1)
+          M_throw() << "For multiple gamma reweighting, one must be "
+                       "designated as E and used in the W lookup";
+
+        a.push_back(dat.gamma[0] * entry.first[0] + dat.W(entry.first[0]));
+      }
+    }
+  }
 
-  double err = 0.0;
+  typedef Eigen::Matrix<long double, Eigen::Dynamic, 1> VectorType;
+  typedef Eigen::Matrix<long double, Eigen::Dynamic, Eigen::Dynamic>
+      MatrixType;
+
+  /*! \brief Evaluate F, and optionally its gradient and Hessian, for
+      the bins [begin, end).
+   */
+  void accumulate(const VectorType &logZ, size_t begin, size_t end,
+                  long double &F, VectorType *grad, MatrixType *hess) const {
+    std::vector<long double> w(K);
+    for (size_t x(begin); x < end; ++x) {
+      const long double *ax = &a[x * K];
+      long double maxval = -HUGE_VALL;
+      for (size_t k(0); k < K; ++k)
+        maxval = std::max(maxval, ax[k] - logZ[k]);
+
+      long double sum = 0;
+      for (size_t k(0); k < K; ++k) {
+        const long double d = ax[k] - logZ[k] - maxval;
+        w[k] = (d > LSECutoff) ? std::exp(d) : 0;
+        sum += w[k];
+      }
 
-  do {
-    for (size_t i = NStepsPerStep; i != 0; --i) {
-      for (size_t i(bottom); i <= top; ++i)
-        SimulationDataData[i].recalc_newlogZ(bottom, top);
+      F += N[x] * (maxval + std::log(sum));
 
-      for (size_t i(bottom); i <= top; ++i)
-        SimulationDataData[i].iterate_logZ();
-    }
+      if (!grad)
+        continue;
 
-    // Now the error checking run
-    err = 0.0;
-    for (size_t i(bottom); i <= top; ++i) {
-      SimulationDataData[i].recalc_newlogZ(bottom, top);
+      for (size_t k(0); k < K; ++k)
+        w[k] /= sum;
 
-      if (SimulationDataData[i].calc_error() > err)
-        err = SimulationDataData[i].calc_error();
+      for (size_t k(0); k < K; ++k) {
+        if (!w[k])
+          continue;
+        const long double Nw = N[x] * w[k];
+        (*grad)[k] -= Nw;
+        if (!hess)
+          continue;
+        (*hess)(k, k) += Nw;
+        for (size_t l(0); l < K; ++l)
+          (*hess)(k, l) -= Nw * w[l];
+      }
     }
+  }
 
-    // May as well use this as an iteration too
-    for (size_t i(bottom); i <= top; ++i)
-      SimulationDataData[i].iterate_logZ();
+  /*! \brief Evaluate F (and optionally its derivatives) over all
+      bins, splitting the sums over the thread pool.
+   */
+  long double evaluate(const VectorType &logZ, VectorType *grad = nullptr,
+                       MatrixType *hess = nullptr) const {
+    const size_t NTasks = std::max<size_t>(threads.getThreadCount(), 1);
+    const size_t chunk = (N.size() + NTasks - 1) / NTasks;
+
+    std::vector<long double> F(NTasks, 0);
+    std::vector<VectorType> grads(NTasks);
+    std::vector<MatrixType> hessians(NTasks);
+
+    for (size_t t(0); t < NTasks; ++t) {
+      if (grad)
+        grads[t] = VectorType::Zero(K);
+      if (hess)
+        hessians[t] = MatrixType::Zero(K, K);
+
+      const size_t begin = std::min(t * chunk, N.size());
+      const size_t end = std::min(begin + chunk, N.size());
+      threads.queueTask([&, t, begin, end]() {
+        accumulate(logZ, begin, end, F[t], grad ? &grads[t] : nullptr,
+                   hess ? &hessians[t] : nullptr);
+      });
+    }
+    threads.wait();
+
+    long double retval = logZ.sum();
+    if (grad)
+      *grad = VectorType::Ones(K);
+    if (hess)
+      *hess = MatrixType::Zero(K, K);
+
+    for (size_t t(0); t < NTasks; ++t) {
+      retval += F[t];
+      if (grad)
+        *grad += grads[t];
+      if (hess)
+        *hess += hessians[t];
+    }
+    return retval;
+  }
+};
 
-    printf("\r%E", err);
-    fflush(stdout);
-  } while (err > minErr);
-}
+/*! \brief Solve for the logZ's with a damped Newton minimisation of
+    the MBAR objective.
 
-void solveWeightsPiecemeal() {
+  The first (coldest) simulation is used as the reference point
+  (logZ=0) which removes the null direction of the objective.
+*/
+void solveWeights() {
   std::cout << "##################################################\n";
-  std::cout << "Solving for Z's, in a rolling piecemeal fashion\n";
+  std::cout << "Solving for Z's by Newton minimisation\n";
 
-  size_t startingPieceSize = 5;
+  PooledHistogram pooled;
+  pooled.build();
 
-  size_t stoppingPieceSize = SimulationDataData.size() / 2 + 1;
+  const size_t K = pooled.K;
+  typedef PooledHistogram::VectorType VectorType;
+  typedef PooledHistogram::MatrixType MatrixType;
 
-  if (startingPieceSize > SimulationDataData.size())
-    startingPieceSize = SimulationDataData.size();
+  if (K == 1) {
+    SimulationDataData[0].logZ = 0;
+    return;
+  }
 
-  for (size_t pieceSize = startingPieceSize; pieceSize < stoppingPieceSize;
-       pieceSize += 5) {
-    for (SimulationData &simdat : SimulationDataData)
-      simdat.refZ = false;
+  // Initial guess from the exponential averages between neighbouring
+  // histograms, \f$Z_k/Z_{k-1} = \langle e^{a_k(X)-a_{k-1}(X)}
+  // \rangle_{k-1}\f$. For well overlapping histograms (e.g., replica
+  // exchange) this is already close to the solution, which keeps the
+  // Newton iteration away from the flat regions of the objective.
+  VectorType logZ = VectorType::Zero(K);
+  for (size_t k(1); k < K; ++k) {
+    const SimulationData &prev = SimulationDataData[k - 1];
+    const SimulationData &next = SimulationDataData[k];
+    std::vector<long double> terms;
+    long double maxval = -HUGE_VALL;
+    for (const SimulationData::histogramEntry &simdat : prev.data) {
+      if (!(simdat.Probability > 0))
+        continue;
+      const long double E = simdat.X[0];
+      terms.push_back(std::log(simdat.Probability) +
+                      (next.gamma[0] - prev.gamma[0]) * E + next.W(E) -
+                      prev.W(E));
+      maxval = std::max(maxval, terms.back());
+    }
 
-    // Set the first system as the reference point
-    SimulationDataData.front().refZ = true;
+    long double sum = 0;
+    for (const long double term : terms)
+      if (term - maxval > LSECutoff)
+        sum += std::exp(term - maxval);
 
-    std::cout << "\rSolving 0 to " << pieceSize << ", Long iteration step\n";
-    // Now solve the first piece.
-    solveWeightsInRange(0, pieceSize);
+    logZ[k] = logZ[k - 1] + (terms.empty() ? 0 : maxval + std::log(sum));
+  }
 
-    for (size_t bottom(1), top(pieceSize + 1); top < SimulationDataData.size();
-         ++bottom, ++top) {
-      // Freeze the lower half of the last set of systems
+  VectorType grad;
+  MatrixType hess;
+  size_t iteration = 0;
+  for (; iteration < maxIterations; ++iteration) {
+    const long double F = pooled.evaluate(logZ, &grad, &hess);
+
+    const long double err = grad.tail(K - 1).cwiseAbs().maxCoeff();
+    if (!(iteration % NStepsPerStep) || (err < minErr))
+      std::cout << "\rIteration " << iteration << " F = " << F
+                << " max|dF/dlogZ| = " << err << std::flush;
+    if (err < minErr)
+      break;
+
+    // Newton step in the non-reference logZ's
+    VectorType step = VectorType::Zero(K);
+    step.tail(K - 1) =
+        hess.bottomRightCorner(K - 1, K - 1).ldlt().solve(-grad.tail(K - 1));
+
+    if (!(grad.dot(step) < 0))
+      // The Hessian is numerically indefinite, fall back to steepest descent
+      step.tail(K - 1) = -grad.tail(K - 1);
+
+    // Poorly overlapping histograms give a near-singular Hessian, so
+    // limit the change in any logZ per iteration.
+    const long double maxStep = 10;
+    const long double stepSize = step.cwiseAbs().maxCoeff();
+    if (stepSize > maxStep)
+      step *= maxStep / stepSize;
+
+    // Backtracking line search (Armijo condition). Once the predicted
+    // decrease is below the precision of F the line search cannot
+    // resolve it, and the full (quadratically convergent) step is
+    // taken.
+    const long double slope = grad.dot(step);
+    const long double precision =
+        64 * std::numeric_limits<long double>::epsilon() *
+        std::max<long double>(1, std::abs(F));
+    bool accepted = -slope < precision;
+    long double t = 1;
+    VectorType trial = logZ + step;
+    for (size_t i(0); (i < 64) && !accepted; ++i) {
+      trial = logZ + t * step;
+      accepted = pooled.evaluate(trial) <= F + 1e-4 * t * slope;
+      t *= 0.5;
+    }
 
-      // This is required for the first iterations but only one system
-      // is frozen per further iteration
-      for (size_t i = bottom - 1; i < bottom + (top - bottom) / 2; ++i)
-        SimulationDataData[i].refZ = true;
+    // No further progress is possible at this precision
+    if (!accepted)
+      break;
 
-      std::cout << "\rSolving " << bottom << " to " << top << "\n";
-      solveWeightsInRange(bottom, top);
-    }
+    logZ = trial;
   }
+  std::cout << "\n";
 
-  for (SimulationData &simdat : SimulationDataData)
-    simdat.refZ = false;
-
-  // Set the first system as the reference point
-  SimulationDataData.front().refZ = true;
+  if (iteration == maxIterations)
+    std::cerr << "Warning: the logZ's did not converge after " << maxIterations
+              << " iterations\n";
 
-  std::cout << "\rFinal Solution step 0 to " << SimulationDataData.size() - 1
-            << "\n";
-  solveWeightsInRange();
+  for (size_t k(0); k < K; ++k)
+    SimulationDataData[k].logZ = logZ[k];
 
-  std::cout << "\nIteration complete\n";
+  std::cout << "Iteration complete\n";
 }
 
 void calcDensityOfStates() {
@@ -533,15 +755,26 @@ int main(int argc, char *argv[]) {
     systemopts.add_options()("help", "Produces this message")(
         "data-file", po::value<std::vector<std::string>>(),
         "Specify a config file to load, or just list them on the command line")(
-        "alpha", po::value<long double>()->default_value(1),
-        "A fraction of the difference between the old and new logZ's to use, "
-        "use to stop divergence")(
-        "NSteps,N", po::value<size_t>()->default_value(10),
-        "Number of steps to take before testing the error and spitting out the "
-        "current vals")("Tmin", po::value<double>(),
-                        "Set the coldest temperature to output calculated data "
-                        "for (Cv.out, Energy.out) etc. If unset this defaults "
-                        "to the temperature of the coldest simulation.")(
+        "NSteps,N", po::value<size_t>()->default_value(NStepsPerStep),
+        "Number of iterations to take between printing the current "
+        "error")(
+        "n-threads",
+        po::value<unsigned int>()->default_value(
+            std::thread::hardware_concurrency()),
+        "Number of threads used to load the histograms and evaluate the "
+        "reweighting sums")(
+        "tolerance", po::value<long double>()->default_value(minErr, "1e-14"),
+        "Convergence criteria for the largest gradient of the objective "
+        "function with respect to the logZ's")(
+        "max-iterations", po::value<size_t>()->default_value(maxIterations),
+        "Maximum number of Newton iterations")(
+        "no-cache",
+        "Do not read or write the binary histogram caches "
+        "(<data-file>.histcache)")(
+        "Tmin", po::value<double>(),
+        "Set the coldest temperature to output calculated data "
+        "for (Cv.out, Energy.out) etc. If unset this defaults "
+        "to the temperature of the coldest simulation.")(
         "Tmax", po::value<double>(),
         "Set the hottest temperature to output calculated data for (Cv.out, "
         "Energy.out) etc. If unset this defaults to the temperature of the "
@@ -563,12 +796,27 @@ int main(int argc, char *argv[]) {
                 << systemopts << "\n";
     }
 
-    alpha = vm["alpha"].as<long double>();
-    NStepsPerStep = vm["NSteps"].as<size_t>();
+    minErr = vm["tolerance"].as<long double>();
+    maxIterations = vm["max-iterations"].as<size_t>();
+    NStepsPerStep = std::max<size_t>(vm["NSteps"].as<size_t>(), 1);
+    threads.setThreadCount(vm["n-threads"].as<unsigned int>());
 
     // Data load
-    for (std::string fileName : vm["data-file"].as<std::vector<std::string>>())
-      SimulationDataData.push_back(SimulationData(fileName));
+    const std::vector<std::string> fileNames =
+        vm["data-file"].as<std::vector<std::string>>();
+    SimulationDataData.resize(fileNames.size());
+    for (size_t i(0); i < fileNames.size(); ++i)
+      threads.queueTask([i, &fileNames]() {
+        SimulationDataData[i].load(fileNames[i], !vm.count("no-cache"));
+      });
+    threads.wait();
+
+    for (const SimulationData &dat : SimulationDataData) {
+      std::cout << "W for file " << dat.fileName;
+      for (const auto &W : dat._W)
+        std::cout << "\nE = " << W.first * dat.binWidth << ", W = " << W.second;
+      std::cout << std::endl;
+    }
 
     for (const SimulationData &dat : SimulationDataData)
       if (dat.binWidth != SimulationDataData.front().binWidth) {
@@ -600,7 +848,7 @@ int main(int argc, char *argv[]) {
       std::cout << dat.fileName << " NData = " << dat.data.size()
                 << " gamma[0] = " << dat.gamma[0] << "\n";
 
-    solveWeightsPiecemeal();
+    solveWeights();
 
     std::cout << "##################################################\n";
     for (const SimulationData &dat : SimulationDataData)
@@ -15,6 +15,7 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <boost/lexical_cast.hpp>
 #include <boost/program_options.hpp>
 #include <boost/tokenizer.hpp>
@@ -55,6 +56,9 @@ int main(int argc, char *argv[]) {
         "Configuration output file.")(
         "random-seed,s", po::value<unsigned int>(),
         "Seed value for the random number generator.")(
+        "n-threads,N", po::value<unsigned int>(),
+        "Number of threads to use when generating configurations (only "
+        "utilised by certain packer modes).")(
         "rescale-T,r", po::value<double>(),
         "Rescales the kinetic temperature of the input/generated config to "
         "this value.")(
@@ -77,7 +81,10 @@ int main(int argc, char *argv[]) {
         "unwrapped", "Don't apply the boundary conditions of the system when "
                      "writing out the particle positions.")(
         "check", "Runs tests on the configuration to ensure the system is not "
-                 "in an invalid state.");
+                 "in an invalid state.")(
+        "check-all-pairs",
+        "As --check, but tests every pair of particles and not only those "
+        "within the longest interaction range (slow for large systems).");
 
     loadopts.add_options()("config-file", po::value<string>(),
                            "Config file to initialise from (Non packer mode).");
@@ -88,37 +95,7 @@ int main(int argc, char *argv[]) {
     allopts.add(loadopts);
     allopts.add(dynamo::IPPacker::getOptions());
 
-    hiddenopts.add_options()("b1", "boolean option one.")(
-        "b2", "boolean option two.")("i1", po::value<size_t>(),
-                                     "integer option one.")(
-        "i2", po::value<size_t>(), "integer option two.")(
-        "i3", po::value<size_t>(), "integer option three.")(
-        "i4", po::value<size_t>(), "integer option four.")(
-        "s1", po::value<std::string>(), "string option one.")(
-        "s2", po::value<std::string>(),
-        "string option two.")("f1", po::value<double>(), "double option one.")(
-        "f2", po::value<double>(), "double option two.")(
-        "f3", po::value<double>(), "double option three.")(
-        "f4", po::value<double>(), "double option four.")(
-        "f5", po::value<double>(),
-        "double option five.")("f6", po::value<double>(), "double option six.")(
-        "f7", po::value<double>(), "double option seven.")(
-        "f8", po::value<double>(), "double option eight.")(
-        "f9", po::value<double>(), "double option nine.")(
-        "f10", po::value<double>(), "double option ten.")(
-        "NCells,C", po::value<unsigned long>()->default_value(7),
-        "Default number of unit cells per dimension, used for crystal packing "
-        "of particles.")("xcell,x", po::value<unsigned long>(),
-                         "Number of unit cells in the x dimension.")(
-        "ycell,y", po::value<unsigned long>(),
-        "Number of unit cells in the y dimension.")(
-        "zcell,z", po::value<unsigned long>(),
-        "Number of unit cells in the z dimension.")(
-        "rectangular-box",
-        "Force the simulation box to be deformed so "
-        "that the x,y,z cells also specify the box aspect ratio.")(
-        "density,d", po::value<double>()->default_value(0.5),
-        "System number density.");
+    hiddenopts.add(dynamo::IPPacker::getHiddenOptions());
 
     allopts.add(hiddenopts);
 
@@ -136,6 +113,9 @@ int main(int argc, char *argv[]) {
     if (vm.count("random-seed"))
       sim.ranGenerator.seed(vm["random-seed"].as<unsigned int>());
 
+    if (vm.count("n-threads"))
+      sim.threadCount = std::max(1u, vm["n-threads"].as<unsigned int>());
+
     if (!vm.count("pack-mode") &&
         (vm.count("help") || !vm.count("config-file"))) {
       cout << "Usage : dynamod <OPTIONS>...[CONFIG FILE]\n"
@@ -209,8 +189,8 @@ int main(int argc, char *argv[]) {
     if (vm.count("zero-momentum"))
       dynamo::InputPlugin(&sim, "MomentumZeroer").zeroMomentum();
 
-    if (vm.count("check"))
-      sim.checkSystem();
+    if (vm.count("check") || vm.count("check-all-pairs"))
+      sim.checkSystem(vm.count("check-all-pairs"));
 
     if (vm.count("zero-com"))
       dynamo::InputPlugin(&sim, "CentreOfMassZeroer").zeroCentreOfMass();
@@ -0,0 +1,639 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*! \file _dynamo.cpp
+  \brief The pydynamo._dynamo extension module.
+
+  This exposes a dynamo::Simulation to python so that small
+  simulations can be built, run and analysed in-process, without
+  spawning dynamod/dynarun or round-tripping through XML files. It
+  is written against the plain CPython API so that it has no build
+  dependencies beyond the python headers. Particle data is exported
+  through the buffer protocol, so numpy.asarray(sim.positions()) is
+  a zero-copy (N,3) view of the particle positions.
+
+  Each Simulation has its own lock, as run() releases the GIL. Every
+  call which touches the simulation takes the lock, so a call from
+  another thread waits for the run to finish.
+*/
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/inputplugins/include.hpp>
+#include <dynamo/outputplugins/misc.hpp>
+#include <dynamo/schedulers/scheduler.hpp>
+#include <dynamo/simulation.hpp>
+#include <dynamo/systems/tHalt.hpp>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+namespace po = boost::program_options;
+
+//! The name of the SystHalt used to implement run(time=...).
+const char *haltName = "PythonHalt";
+
+struct SimulationObject {
+  PyObject_HEAD
+  dynamo::Simulation *sim;
+  //! Serialises the calls on sim, see SimulationLock.
+  std::recursive_mutex *mutex;
+  //! The number of live buffers exported from the particle data.
+  Py_ssize_t exports;
+};
+
+/*! \brief Holds the lock of a Simulation for the current scope.
+
+  The lock is only ever waited for with the GIL released, so a
+  thread waiting for the lock never blocks the thread holding it
+  (e.g., run() reacquiring the GIL between its chunks of events).
+  The lock is recursive, as the particle arrays take it again while
+  their views are created.
+*/
+class SimulationLock {
+public:
+  SimulationLock(SimulationObject *self)
+      : _lock(*self->mutex, std::defer_lock) {
+    if (!_lock.try_lock()) {
+      Py_BEGIN_ALLOW_THREADS;
+      _lock.lock();
+      Py_END_ALLOW_THREADS;
+    }
+  }
+
+private:
+  std::unique_lock<std::recursive_mutex> _lock;
+};
+
+/*! \brief Converts the C++ exception currently being handled into a
+    python RuntimeError.
+ */
+PyObject *setError() {
+  try {
+    throw;
+  } catch (std::exception &e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+  } catch (...) {
+    PyErr_SetString(PyExc_RuntimeError, "Unknown C++ exception");
+  }
+  return nullptr;
+}
+
+bool checkNoExports(SimulationObject *self) {
+  if (self->exports) {
+    PyErr_SetString(PyExc_BufferError,
+                    "Cannot replace the particles while particle arrays are "
+                    "still in use");
+    return false;
+  }
+  return true;
+}
+
+bool checkInitialised(SimulationObject *self) {
+  if (self->sim->status < dynamo::INITIALISED) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "The simulation must be initialised first");
+    return false;
+  }
+  return true;
+}
+
+/////////////////// Particle arrays
+
+/*! \brief A (N,3) strided view of a Vector member of the particles.
+
+  This holds a reference to the owning Simulation, which refuses to
+  replace its particles while any view is exported. The view is of
+  the live particle data. It is brought up to date when it is
+  created and at the end of each run(). Reading it while another
+  thread is in run() gives partially updated values.
+*/
+struct ParticleArrayObject {
+  PyObject_HEAD
+  SimulationObject *owner;
+  //! Selects the velocities rather than the positions
+  bool velocity;
+  Py_ssize_t shape[2];
+  Py_ssize_t strides[2];
+};
+
+void ParticleArray_dealloc(ParticleArrayObject *self) {
+  Py_XDECREF(self->owner);
+  Py_TYPE(self)->tp_free(reinterpret_cast<PyObject *>(self));
+}
+
+int ParticleArray_getbuffer(ParticleArrayObject *self, Py_buffer *view,
+                            int flags) {
+  if (flags & PyBUF_WRITABLE) {
+    PyErr_SetString(PyExc_BufferError, "Particle arrays are read-only");
+    view->obj = nullptr;
+    return -1;
+  }
+
+  SimulationLock lock(self->owner);
+  std::vector<dynamo::Particle> &particles = self->owner->sim->particles;
+  double *base = nullptr;
+  if (!particles.empty())
+    base = self->velocity ? &particles[0].getVelocity()[0]
+                          : &particles[0].getPosition()[0];
+
+  self->shape[0] = particles.size();
+  self->shape[1] = NDIM;
+  self->strides[0] = sizeof(dynamo::Particle);
+  self->strides[1] = sizeof(double);
+
+  view->buf = base;
+  view->obj = reinterpret_cast<PyObject *>(self);
+  Py_INCREF(self);
+  view->len = particles.size() * NDIM * sizeof(double);
+  view->readonly = 1;
+  view->itemsize = sizeof(double);
+  view->format = (flags & PyBUF_FORMAT) ? const_cast<char *>("d") : nullptr;
+  view->ndim = 2;
+  view->shape = self->shape;
+  view->strides = self->strides;
+  view->suboffsets = nullptr;
+  view->internal = nullptr;
+  ++self->owner->exports;
+  return 0;
+}
+
+void ParticleArray_releasebuffer(ParticleArrayObject *self, Py_buffer *) {
+  --self->owner->exports;
+}
+
+PyBufferProcs ParticleArray_as_buffer = {
+    reinterpret_cast<getbufferproc>(ParticleArray_getbuffer),
+    reinterpret_cast<releasebufferproc>(ParticleArray_releasebuffer)};
+
+PyTypeObject ParticleArrayType = {PyVarObject_HEAD_INIT(nullptr, 0)};
+
+/*! \brief Returns a memoryview of a Vector member of the particles.
+ */
+PyObject *particleArray(SimulationObject *self, bool velocity) {
+  SimulationLock lock(self);
+  try {
+    // Bring the particles up to date before they are read
+    if (self->sim->status >= dynamo::INITIALISED)
+      self->sim->dynamics->updateAllParticles();
+  } catch (...) {
+    return setError();
+  }
+
+  ParticleArrayObject *array =
+      PyObject_New(ParticleArrayObject, &ParticleArrayType);
+  if (!array)
+    return nullptr;
+  Py_INCREF(self);
+  array->owner = self;
+  array->velocity = velocity;
+
+  PyObject *view = PyMemoryView_FromObject(reinterpret_cast<PyObject *>(array));
+  Py_DECREF(array);
+  return view;
+}
+
+/////////////////// Simulation
+
+PyObject *Simulation_new(PyTypeObject *type, PyObject *, PyObject *) {
+  SimulationObject *self =
+      reinterpret_cast<SimulationObject *>(type->tp_alloc(type, 0));
+  if (!self)
+    return nullptr;
+
+  try {
+    self->sim = new dynamo::Simulation;
+    self->mutex = new std::recursive_mutex;
+  } catch (...) {
+    Py_DECREF(self);
+    return setError();
+  }
+  self->exports = 0;
+  return reinterpret_cast<PyObject *>(self);
+}
+
+int Simulation_init(SimulationObject *self, PyObject *args, PyObject *kwds) {
+  static const char *kwlist[] = {"seed", "threads", nullptr};
+  PyObject *seed = Py_None;
+  Py_ssize_t threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|On",
+                                   const_cast<char **>(kwlist), &seed,
+                                   &threads))
+    return -1;
+
+  SimulationLock lock(self);
+  if (seed != Py_None) {
+    const unsigned long value = PyLong_AsUnsignedLong(seed);
+    if (PyErr_Occurred())
+      return -1;
+    self->sim->ranGenerator.seed(value);
+  }
+
+  self->sim->threadCount = std::max<Py_ssize_t>(1, threads);
+  return 0;
+}
+
+void Simulation_dealloc(SimulationObject *self) {
+  delete self->sim;
+  delete self->mutex;
+  Py_TYPE(self)->tp_free(reinterpret_cast<PyObject *>(self));
+}
+
+PyObject *Simulation_load(SimulationObject *self, PyObject *args) {
+  const char *filename;
+  if (!PyArg_ParseTuple(args, "s", &filename))
+    return nullptr;
+
+  SimulationLock lock(self);
+  if (!checkNoExports(self))
+    return nullptr;
+
+  try {
+    self->sim->loadXMLfile(filename);
+  } catch (...) {
+    return setError();
+  }
+  Py_RETURN_NONE;
+}
+
+PyObject *Simulation_pack(SimulationObject *self, PyObject *args) {
+  PyObject *list;
+  if (!PyArg_ParseTuple(args, "O", &list))
+    return nullptr;
+
+  PyObject *seq = PySequence_Fast(list, "pack() expects a list of dynamod "
+                                        "command line options");
+  if (!seq)
+    return nullptr;
+
+  std::vector<std::string> options;
+  for (Py_ssize_t i(0); i < PySequence_Fast_GET_SIZE(seq); ++i) {
+    PyObject *item = PyObject_Str(PySequence_Fast_GET_ITEM(seq, i));
+    if (!item) {
+      Py_DECREF(seq);
+      return nullptr;
+    }
+    options.push_back(PyUnicode_AsUTF8(item));
+    Py_DECREF(item);
+  }
+  Py_DECREF(seq);
+
+  SimulationLock lock(self);
+  if (!checkNoExports(self))
+    return nullptr;
+
+  try {
+    po::options_description opts;
+    opts.add(dynamo::IPPacker::getOptions());
+    opts.add(dynamo::IPPacker::getHiddenOptions());
+
+    po::variables_map vm;
+    po::store(po::command_line_parser(options).options(opts).run(), vm);
+    po::notify(vm);
+
+    if (!vm.count("pack-mode"))
+      M_throw() << "No packing mode (-m) was given";
+
+    dynamo::IPPacker plug(vm, self->sim);
+    plug.initialise();
+
+    // As in dynamod, certain packer modes set their own velocities
+    const size_t mode = vm["pack-mode"].as<size_t>();
+    if ((mode != 23) && (mode != 25) && (mode != 28)) {
+      dynamo::InputPlugin(self->sim, "Rescaler").zeroMomentum();
+      dynamo::InputPlugin(self->sim, "Rescaler").rescaleVels(1.0);
+    }
+  } catch (...) {
+    return setError();
+  }
+  Py_RETURN_NONE;
+}
+
+PyObject *Simulation_add_output_plugin(SimulationObject *self,
+                                       PyObject *args) {
+  const char *descriptor;
+  if (!PyArg_ParseTuple(args, "s", &descriptor))
+    return nullptr;
+
+  SimulationLock lock(self);
+  try {
+    self->sim->addOutputPlugin(descriptor);
+  } catch (...) {
+    return setError();
+  }
+  Py_RETURN_NONE;
+}
+
+PyObject *Simulation_initialise(SimulationObject *self, PyObject *) {
+  SimulationLock lock(self);
+  try {
+    dynamo::Simulation &sim = *self->sim;
+    // A zero event limit would skip the scheduler initialisation, the
+    // limit is set by each run()
+    sim.endEventCount = std::numeric_limits<size_t>::max();
+
+    if (!sim.getOutputPlugin<dynamo::OPMisc>())
+      sim.addOutputPlugin("Misc");
+
+    if (sim.systems.find(haltName) == sim.systems.end())
+      sim.systems.push_back(
+          dynamo::shared_ptr<dynamo::System>(new dynamo::SystHalt(
+              &sim, std::numeric_limits<double>::infinity(), haltName)));
+
+    sim.initialise();
+  } catch (...) {
+    return setError();
+  }
+  Py_RETURN_NONE;
+}
+
+/*! \brief Runs the simulation until a number of events or a period
+    of time has passed.
+
+  The GIL is released while the events are run, it is reacquired
+  periodically to allow KeyboardInterrupt to stop the run. The lock
+  of the Simulation is held throughout. Any exported particle arrays
+  are brought up to date before returning.
+*/
+PyObject *Simulation_run(SimulationObject *self, PyObject *args,
+                         PyObject *kwds) {
+  static const char *kwlist[] = {"events", "time", nullptr};
+  PyObject *events = Py_None, *time = Py_None;
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|OO",
+                                   const_cast<char **>(kwlist), &events,
+                                   &time))
+    return nullptr;
+
+  SimulationLock lock(self);
+  if (!checkInitialised(self))
+    return nullptr;
+
+  if ((events == Py_None) && (time == Py_None)) {
+    PyErr_SetString(PyExc_ValueError, "run() needs a number of events or a "
+                                      "time to run for");
+    return nullptr;
+  }
+
+  dynamo::Simulation &sim = *self->sim;
+  const size_t startCount = sim.eventCount;
+  try {
+    sim.endEventCount = std::numeric_limits<size_t>::max();
+    if (events != Py_None) {
+      const size_t count = PyLong_AsSize_t(events);
+      if (PyErr_Occurred())
+        return nullptr;
+      sim.endEventCount = startCount + count;
+    }
+
+    double dt = std::numeric_limits<double>::infinity();
+    if (time != Py_None) {
+      dt = PyFloat_AsDouble(time);
+      if (PyErr_Occurred())
+        return nullptr;
+    }
+
+    auto halt =
+        std::dynamic_pointer_cast<dynamo::SystHalt>(sim.systems[haltName]);
+    halt->setdt(dt);
+    sim.scheduler->rebuildSystemEvents();
+  } catch (...) {
+    return setError();
+  }
+
+  const size_t chunk = 10000;
+  bool running = sim.eventCount < sim.endEventCount;
+  std::string error;
+  while (running) {
+    Py_BEGIN_ALLOW_THREADS;
+    try {
+      for (size_t i(0); running && (i < chunk); ++i)
+        running = sim.runSimulationStep(true);
+    } catch (std::exception &e) {
+      error = e.what();
+      running = false;
+    }
+    Py_END_ALLOW_THREADS;
+
+    if (!error.empty()) {
+      PyErr_SetString(PyExc_RuntimeError, error.c_str());
+      return nullptr;
+    }
+
+    if (running && PyErr_CheckSignals())
+      break;
+  }
+
+  try {
+    if (self->exports)
+      sim.dynamics->updateAllParticles();
+  } catch (...) {
+    return setError();
+  }
+
+  if (PyErr_Occurred())
+    return nullptr;
+
+  return PyLong_FromSize_t(sim.eventCount - startCount);
+}
+
+PyObject *Simulation_positions(SimulationObject *self, PyObject *) {
+  return particleArray(self, false);
+}
+
+PyObject *Simulation_velocities(SimulationObject *self, PyObject *) {
+  return particleArray(self, true);
+}
+
+/*! \brief Returns a dictionary of the observables of the OPMisc
+    plugin, in simulation units.
+ */
+PyObject *Simulation_misc(SimulationObject *self, PyObject *) {
+  SimulationLock lock(self);
+  if (!checkInitialised(self))
+    return nullptr;
+
+  const dynamo::Simulation &sim = *self->sim;
+  auto misc = sim.getOutputPlugin<dynamo::OPMisc>();
+  if (!misc) {
+    PyErr_SetString(PyExc_RuntimeError, "The Misc plugin is not loaded");
+    return nullptr;
+  }
+
+  double MFT, pressure;
+  try {
+    MFT = misc->getMFT() / sim.units.unitTime();
+    pressure = misc->getPressureTensor().tr() /
+               (3.0 * sim.units.unitPressure());
+  } catch (...) {
+    return setError();
+  }
+
+  const double unitEnergy = sim.units.unitEnergy();
+  return Py_BuildValue(
+      "{s:d,s:d,s:d,s:d,s:d,s:d,s:d,s:d,s:n,s:d}", "MFT", MFT, "kT",
+      misc->getCurrentkT() / unitEnergy, "mean_kT",
+      misc->getMeankT() / unitEnergy, "U",
+      misc->getConfigurationalU() / unitEnergy, "mean_U",
+      misc->getMeanUConfigurational() / unitEnergy, "total_energy",
+      misc->getTotalEnergy() / unitEnergy, "pressure", pressure,
+      "events_per_second", misc->getEventsPerSecond(), "event_count",
+      Py_ssize_t(sim.eventCount), "time",
+      double(sim.systemTime / sim.units.unitTime()));
+}
+
+PyObject *Simulation_write_config(SimulationObject *self, PyObject *args) {
+  const char *filename;
+  if (!PyArg_ParseTuple(args, "s", &filename))
+    return nullptr;
+
+  SimulationLock lock(self);
+  try {
+    self->sim->writeXMLfile(filename);
+  } catch (...) {
+    return setError();
+  }
+  Py_RETURN_NONE;
+}
+
+PyObject *Simulation_write_output(SimulationObject *self, PyObject *args) {
+  const char *filename;
+  if (!PyArg_ParseTuple(args, "s", &filename))
+    return nullptr;
+
+  SimulationLock lock(self);
+  if (!checkInitialised(self))
+    return nullptr;
+
+  try {
+    self->sim->outputData(filename);
+  } catch (...) {
+    return setError();
+  }
+  Py_RETURN_NONE;
+}
+
+PyObject *Simulation_get_N(SimulationObject *self, void *) {
+  SimulationLock lock(self);
+  return PyLong_FromSize_t(self->sim->N());
+}
+
+PyObject *Simulation_get_event_count(SimulationObject *self, void *) {
+  SimulationLock lock(self);
+  return PyLong_FromSize_t(self->sim->eventCount);
+}
+
+PyObject *Simulation_get_time(SimulationObject *self, void *) {
+  SimulationLock lock(self);
+  return PyFloat_FromDouble(self->sim->systemTime /
+                            self->sim->units.unitTime());
+}
+
+PyMethodDef Simulation_methods[] = {
+    {"load", reinterpret_cast<PyCFunction>(Simulation_load), METH_VARARGS,
+     "load(filename)\n\nLoad a configuration file."},
+    {"pack", reinterpret_cast<PyCFunction>(Simulation_pack), METH_VARARGS,
+     "pack(options)\n\nBuild a configuration from a list of dynamod "
+     "command line options, e.g. ['-m', '0', '-C', '7']."},
+    {"add_output_plugin",
+     reinterpret_cast<PyCFunction>(Simulation_add_output_plugin), METH_VARARGS,
+     "add_output_plugin(descriptor)\n\nAdd an output plugin, as with the "
+     "dynarun -L option."},
+    {"initialise", reinterpret_cast<PyCFunction>(Simulation_initialise),
+     METH_NOARGS,
+     "initialise()\n\nInitialise the simulation (the Misc plugin is added "
+     "if it is missing)."},
+    {"run", reinterpret_cast<PyCFunction>(Simulation_run),
+     METH_VARARGS | METH_KEYWORDS,
+     "run(events=None, time=None)\n\nRun for a number of events and/or a "
+     "period of simulation time, returning the number of events run. The "
+     "GIL is released while running."},
+    {"positions", reinterpret_cast<PyCFunction>(Simulation_positions),
+     METH_NOARGS,
+     "positions()\n\nA read-only (N,3) zero-copy view of the particle "
+     "positions. The view is updated at the end of each run()."},
+    {"velocities", reinterpret_cast<PyCFunction>(Simulation_velocities),
+     METH_NOARGS,
+     "velocities()\n\nA read-only (N,3) zero-copy view of the particle "
+     "velocities. The view is updated at the end of each run()."},
+    {"misc", reinterpret_cast<PyCFunction>(Simulation_misc), METH_NOARGS,
+     "misc()\n\nA dictionary of the observables of the Misc plugin."},
+    {"write_config", reinterpret_cast<PyCFunction>(Simulation_write_config),
+     METH_VARARGS, "write_config(filename)\n\nWrite the configuration file."},
+    {"write_output", reinterpret_cast<PyCFunction>(Simulation_write_output),
+     METH_VARARGS,
+     "write_output(filename)\n\nWrite the output file of the plugins."},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyGetSetDef Simulation_getset[] = {
+    {"N", reinterpret_cast<getter>(Simulation_get_N), nullptr,
+     "The number of particles.", nullptr},
+    {"event_count", reinterpret_cast<getter>(Simulation_get_event_count),
+     nullptr, "The number of events run.", nullptr},
+    {"time", reinterpret_cast<getter>(Simulation_get_time), nullptr,
+     "The simulation time.", nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}};
+
+PyTypeObject SimulationType = {PyVarObject_HEAD_INIT(nullptr, 0)};
+
+PyModuleDef dynamoModule = {PyModuleDef_HEAD_INIT, "_dynamo",
+                            "Native bindings for DynamO simulations.", -1,
+                            nullptr};
+} // namespace
+
+PyMODINIT_FUNC PyInit__dynamo() {
+  ParticleArrayType.tp_name = "pydynamo._dynamo.ParticleArray";
+  ParticleArrayType.tp_basicsize = sizeof(ParticleArrayObject);
+  ParticleArrayType.tp_dealloc =
+      reinterpret_cast<destructor>(ParticleArray_dealloc);
+  ParticleArrayType.tp_as_buffer = &ParticleArray_as_buffer;
+  ParticleArrayType.tp_flags = Py_TPFLAGS_DEFAULT;
+  ParticleArrayType.tp_doc = "A view of a per-particle vector.";
+
+  SimulationType.tp_name = "pydynamo._dynamo.Simulation";
+  SimulationType.tp_basicsize = sizeof(SimulationObject);
+  SimulationType.tp_new = Simulation_new;
+  SimulationType.tp_init = reinterpret_cast<initproc>(Simulation_init);
+  SimulationType.tp_dealloc = reinterpret_cast<destructor>(Simulation_dealloc);
+  SimulationType.tp_methods = Simulation_methods;
+  SimulationType.tp_getset = Simulation_getset;
+  SimulationType.tp_flags = Py_TPFLAGS_DEFAULT;
+  SimulationType.tp_doc =
+      "Simulation(seed=None, threads=1)\n\nAn in-process DynamO simulation.";
+
+  if ((PyType_Ready(&ParticleArrayType) < 0) ||
+      (PyType_Ready(&SimulationType) < 0))
+    return nullptr;
+
+  PyObject *module = PyModule_Create(&dynamoModule);
+  if (!module)
+    return nullptr;
+
+  Py_INCREF(&SimulationType);
+  if (PyModule_AddObject(module, "Simulation",
+                         reinterpret_cast<PyObject *>(&SimulationType)) < 0) {
+    Py_DECREF(&SimulationType);
+    Py_DECREF(module);
+    return nullptr;
+  }
+
+  return module;
+}
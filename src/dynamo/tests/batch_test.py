@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+#   dynamo:- Event driven molecular dynamics simulator 
+#   http://www.dynamomd.org
+#   Copyright (C) 2009  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+#
+#   This program is free software: you can redistribute it and/or
+#   modify it under the terms of the GNU General Public License
+#   version 3 as published by the Free Software Foundation.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import os
+import sys
+import getopt
+import subprocess
+import xml.etree.ElementTree as ET
+
+events=10000
+configs=["b"+str(i)+".xml" for i in range(6)]
+
+shortargs=""
+longargs=["dynarun=", "dynamod="]
+try:
+    options, args = getopt.gnu_getopt(sys.argv[1:], shortargs, longargs)
+except getopt.GetoptError as err:
+    print(str(err))
+    sys.exit(2)
+
+dynarun_cmd="NOT SET"
+dynamod_cmd="NOT SET"
+
+for o,a in options:
+    if o == "--dynarun":
+        dynarun_cmd = a
+    if o == "--dynamod":
+        dynamod_cmd = a
+
+for name,exe in [("dynamod", dynamod_cmd), ("dynarun", dynarun_cmd)]:
+    if not(os.path.isfile(exe) and os.access(exe, os.X_OK)):
+        raise RuntimeError("Failed to find "+name+" executabe at "+exe)
+
+###### INITIALISATION
+for i,config in enumerate(configs):
+    cmd=[dynamod_cmd, "-m0", "-C"+str(4+i), "-d0.5", "-o"+config]
+    print(" ".join(cmd))
+    subprocess.check_call(cmd)
+
+# Half the configurations are given on the command line, the rest in
+# a batch list
+with open("batch.list", "w") as f:
+    f.write("# The second half of the batch\n")
+    for config in configs[3:]:
+        f.write(config+"\n")
+
+###### BATCH RUN
+for f in ["bo"+str(i)+".xml" for i in range(len(configs))] + ["bc"+str(i)+".xml" for i in range(len(configs))]:
+    if os.path.exists(f):
+        os.remove(f)
+
+cmd=[dynarun_cmd, "--engine=4", "-N2", "-obc%ID.xml", "--out-data-file=bo%ID.xml", "-c"+str(events), "--batch-list=batch.list"]+configs[:3]
+print(" ".join(cmd))
+subprocess.check_call(cmd)
+
+###### OUTPUT VALIDATION
+error_count = 0
+for i,config in enumerate(configs):
+    N = len(ET.parse(config).getroot().findall(".//Pt"))
+    outN = len(ET.parse("bc"+str(i)+".xml").getroot().findall(".//Pt"))
+    if N != outN:
+        error_count += 1
+        print("Config "+str(i)+" has "+str(outN)+" particles, expected "+str(N))
+
+    measured_events=int(ET.parse("bo"+str(i)+".xml").getroot().find(".//Duration").attrib["Events"])
+    if measured_events != events:
+        error_count += 1
+        print("Config "+str(i)+" ran "+str(measured_events)+" events, expected "+str(events))
+
+print("Total errors:", error_count)
+sys.exit(error_count > 0)
@@ -0,0 +1,106 @@
+#define BOOST_TEST_MODULE Cells_autotune_test
+#include <boost/test/included/unit_test.hpp>
+#include <dynamo/BC/BC.hpp>
+#include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/globals/cells.hpp>
+#include <dynamo/inputplugins/cells/include.hpp>
+#include <dynamo/inputplugins/include.hpp>
+#include <dynamo/interactions/hardsphere.hpp>
+#include <dynamo/ranges/IDPairRangeAll.hpp>
+#include <dynamo/ranges/IDRangeAll.hpp>
+#include <dynamo/outputplugins/misc.hpp>
+#include <dynamo/simulation.hpp>
+#include <dynamo/species/point.hpp>
+
+#include <magnet/xmlreader.hpp>
+#include <random>
+
+std::mt19937 RNG;
+
+dynamo::Vector getRandVelVec() {
+  std::normal_distribution<> normal_dist(0.0, (1.0 / sqrt(double(NDIM))));
+
+  dynamo::Vector tmpVec;
+  for (size_t iDim = 0; iDim < NDIM; iDim++)
+    tmpVec[iDim] = normal_dist(RNG);
+
+  return tmpVec;
+}
+
+void init(dynamo::Simulation &Sim, const double density) {
+  RNG.seed(12345);
+  Sim.ranGenerator.seed(54321);
+
+  std::unique_ptr<dynamo::UCell> packptr(
+      new dynamo::CUFCC(std::array<long, 3>{{5, 5, 5}}, dynamo::Vector{1, 1, 1},
+                        new dynamo::UParticle()));
+  packptr->initialise();
+  std::vector<dynamo::Vector> latticeSites(
+      packptr->placeObjects(dynamo::Vector{0, 0, 0}));
+  Sim.primaryCellSize = dynamo::Vector{1, 1, 1};
+
+  double particleDiam = std::cbrt(density / latticeSites.size());
+  Sim.interactions.push_back(dynamo::shared_ptr<dynamo::Interaction>(
+      new dynamo::IHardSphere(&Sim, particleDiam, 1.0,
+                              new dynamo::IDPairRangeAll(), "Bulk")));
+  Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(
+      new dynamo::SpPoint(&Sim, new dynamo::IDRangeAll(&Sim), 1.0, "Bulk", 0)));
+  Sim.units.setUnitLength(particleDiam);
+
+  unsigned long nParticles = 0;
+  for (const dynamo::Vector &position : latticeSites)
+    Sim.particles.push_back(dynamo::Particle(
+        position, getRandVelVec() * Sim.units.unitVelocity(), nParticles++));
+
+  Sim.ensemble = dynamo::Ensemble::loadEnsemble(Sim);
+
+  dynamo::InputPlugin(&Sim, "Rescaler").zeroMomentum();
+  dynamo::InputPlugin(&Sim, "Rescaler").rescaleVels(1.0);
+}
+
+// Autotuning regrids the cells during the run, which must not
+// disturb the dynamics, and reports every trial.
+BOOST_AUTO_TEST_CASE(Cells_AutoTune) {
+  {
+    dynamo::Simulation Sim;
+    init(Sim, 0.5);
+    Sim.writeXMLfile("autotune_start.xml");
+  }
+
+  dynamo::Simulation Sim;
+  Sim.loadXMLfile("autotune_start.xml");
+  auto cells = dynamo::shared_ptr<dynamo::GCells>(
+      new dynamo::GCells(&Sim, "SchedulerNBList"));
+  cells->setAutoTune(500);
+  Sim.globals.push_back(cells);
+  Sim.endEventCount = 8000;
+  Sim.addOutputPlugin("Misc");
+  Sim.initialise();
+  const double initialkT =
+      Sim.getOutputPlugin<dynamo::OPMisc>()->getCurrentkT();
+  while (Sim.runSimulationStep(true)) {
+  }
+  Sim.dynamics->updateAllParticles();
+
+  // Energy is conserved and no particles overlap
+  BOOST_CHECK_CLOSE(Sim.getOutputPlugin<dynamo::OPMisc>()->getCurrentkT(),
+                    initialkT, 1e-6);
+  const double diameter = Sim.getLongestInteraction();
+  for (size_t i(0); i < Sim.N(); ++i)
+    for (size_t j(i + 1); j < Sim.N(); ++j) {
+      dynamo::Vector rij =
+          Sim.particles[i].getPosition() - Sim.particles[j].getPosition();
+      Sim.BCs->applyBC(rij);
+      BOOST_CHECK(rij.nrm() > diameter * (1 - 1e-10));
+    }
+
+  Sim.outputData("autotune_output.xml");
+  magnet::xml::Document doc("autotune_output.xml");
+  magnet::xml::Node tune =
+      doc.getNode("OutputData").getNode("CellAutoTune");
+  size_t trials(0);
+  for (magnet::xml::Node trial = tune.findNode("Trial"); trial.valid();
+       ++trial, ++trials)
+    BOOST_CHECK(trial.hasAttribute("CostPerEvent"));
+  BOOST_CHECK(trials > 1);
+}
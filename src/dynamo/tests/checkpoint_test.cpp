@@ -0,0 +1,99 @@
+#define BOOST_TEST_MODULE Checkpoint_test
+#include <boost/test/included/unit_test.hpp>
+#include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/inputplugins/cells/include.hpp>
+#include <dynamo/inputplugins/include.hpp>
+#include <dynamo/interactions/hardsphere.hpp>
+#include <dynamo/ranges/IDPairRangeAll.hpp>
+#include <dynamo/ranges/IDRangeAll.hpp>
+#include <dynamo/simulation.hpp>
+#include <dynamo/species/point.hpp>
+
+#include <random>
+
+std::mt19937 RNG;
+
+dynamo::Vector getRandVelVec() {
+  std::normal_distribution<> normal_dist(0.0, (1.0 / sqrt(double(NDIM))));
+
+  dynamo::Vector tmpVec;
+  for (size_t iDim = 0; iDim < NDIM; iDim++)
+    tmpVec[iDim] = normal_dist(RNG);
+
+  return tmpVec;
+}
+
+void init(dynamo::Simulation &Sim, const double density) {
+  RNG.seed(12345);
+  Sim.ranGenerator.seed(54321);
+
+  std::unique_ptr<dynamo::UCell> packptr(
+      new dynamo::CUFCC(std::array<long, 3>{{5, 5, 5}}, dynamo::Vector{1, 1, 1},
+                        new dynamo::UParticle()));
+  packptr->initialise();
+  std::vector<dynamo::Vector> latticeSites(
+      packptr->placeObjects(dynamo::Vector{0, 0, 0}));
+  Sim.primaryCellSize = dynamo::Vector{1, 1, 1};
+
+  double particleDiam = std::cbrt(density / latticeSites.size());
+  Sim.interactions.push_back(dynamo::shared_ptr<dynamo::Interaction>(
+      new dynamo::IHardSphere(&Sim, particleDiam, 1.0,
+                              new dynamo::IDPairRangeAll(), "Bulk")));
+  Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(
+      new dynamo::SpPoint(&Sim, new dynamo::IDRangeAll(&Sim), 1.0, "Bulk", 0)));
+  Sim.units.setUnitLength(particleDiam);
+
+  unsigned long nParticles = 0;
+  for (const dynamo::Vector &position : latticeSites)
+    Sim.particles.push_back(dynamo::Particle(
+        position, getRandVelVec() * Sim.units.unitVelocity(), nParticles++));
+
+  Sim.ensemble = dynamo::Ensemble::loadEnsemble(Sim);
+
+  dynamo::InputPlugin(&Sim, "Rescaler").zeroMomentum();
+  dynamo::InputPlugin(&Sim, "Rescaler").rescaleVels(1.0);
+}
+
+// A run restored from a checkpoint must follow the original run exactly
+BOOST_AUTO_TEST_CASE(Checkpoint_Restart) {
+  {
+    dynamo::Simulation Sim;
+    init(Sim, 0.5);
+    Sim.writeXMLfile("checkpoint_start.xml");
+  }
+
+  dynamo::Simulation original;
+  original.loadXMLfile("checkpoint_start.xml");
+  original.endEventCount = 20000;
+  original.addOutputPlugin("Misc");
+  original.initialise();
+  while (original.runSimulationStep(true)) {
+  }
+
+  original.writeCheckpoint("checkpoint.dat");
+
+  original.endEventCount = 40000;
+  while (original.runSimulationStep(true)) {
+  }
+  original.dynamics->updateAllParticles();
+
+  dynamo::Simulation restored;
+  restored.loadXMLfile("checkpoint.dat");
+  BOOST_CHECK_EQUAL(restored.eventCount, 20000);
+  restored.endEventCount = 40000;
+  restored.addOutputPlugin("Misc");
+  restored.initialise();
+  while (restored.runSimulationStep(true)) {
+  }
+  restored.dynamics->updateAllParticles();
+
+  BOOST_CHECK_EQUAL(restored.eventCount, original.eventCount);
+  BOOST_CHECK(restored.systemTime == original.systemTime);
+  BOOST_REQUIRE_EQUAL(restored.N(), original.N());
+  for (size_t i(0); i < original.N(); ++i) {
+    BOOST_CHECK(restored.particles[i].getPosition() ==
+                original.particles[i].getPosition());
+    BOOST_CHECK(restored.particles[i].getVelocity() ==
+                original.particles[i].getVelocity());
+  }
+}
@@ -0,0 +1,102 @@
+#define BOOST_TEST_MODULE DSMCCells_test
+#include <boost/program_options.hpp>
+#include <boost/test/included/unit_test.hpp>
+#include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/inputplugins/include.hpp>
+#include <dynamo/inputplugins/packer.hpp>
+#include <dynamo/ranges/IDRangeAll.hpp>
+#include <dynamo/simulation.hpp>
+#include <dynamo/species/species.hpp>
+#include <dynamo/systems/DSMCspheres.hpp>
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace po = boost::program_options;
+
+const double density = 0.5;
+const double elasticity = 0.9;
+
+/*! Packs DSMC hard spheres (dynamod -m10) and replaces the packer's
+    elastic DSMC system with an inelastic one, so the system cools.
+    The particles are scattered uniformly, as the NTC cells only match
+    the global rate if the cell occupancies are Poisson distributed
+    (the packed lattice is too even).
+    The DSMC cells are a fraction of the box wide, or disabled if the
+    fraction is zero.
+ */
+void init(dynamo::Simulation &Sim, const double cellFraction,
+          const size_t threads) {
+  po::options_description opts;
+  opts.add(dynamo::IPPacker::getOptions());
+  opts.add(dynamo::IPPacker::getHiddenOptions());
+
+  const char *argv[] = {"dynamod", "-m10", "-C", "7", "-d", "0.5"};
+  po::variables_map vm;
+  po::store(po::parse_command_line(sizeof(argv) / sizeof(argv[0]), argv, opts),
+            vm);
+  po::notify(vm);
+
+  Sim.ranGenerator.seed(123);
+  Sim.threadCount = threads;
+  dynamo::IPPacker(vm, &Sim).initialise();
+  std::uniform_real_distribution<> uniform(-0.5, 0.5);
+  for (dynamo::Particle &p : Sim.particles)
+    for (size_t iDim = 0; iDim < NDIM; ++iDim)
+      p.getPosition()[iDim] =
+          uniform(Sim.ranGenerator) * Sim.primaryCellSize[iDim];
+  dynamo::InputPlugin(&Sim, "Rescaler").zeroMomentum();
+  dynamo::InputPlugin(&Sim, "Rescaler").rescaleVels(1.0);
+
+  // The same parameters as the packer
+  const double packfrac = density * M_PI / 6.0;
+  const double chi = (1.0 - 0.5 * packfrac) / std::pow(1.0 - packfrac, 3);
+  const double tij = 1.0 / (4.0 * std::sqrt(M_PI) * density * chi);
+  Sim.systems.clear();
+  Sim.systems.push_back(dynamo::shared_ptr<dynamo::System>(
+      new dynamo::SysDSMCSpheres(
+          &Sim, Sim.units.unitLength(), 2.0 * tij / Sim.N(), chi, elasticity,
+          "Thermostat", new dynamo::IDRangeAll(&Sim),
+          new dynamo::IDRangeAll(&Sim),
+          cellFraction * Sim.primaryCellSize[0])));
+  Sim.endEventCount = std::numeric_limits<size_t>::max();
+  Sim.initialise();
+}
+
+double temperature(dynamo::Simulation &Sim) {
+  Sim.dynamics->updateAllParticles();
+  double sum = 0;
+  for (const dynamo::Particle &p : Sim.particles)
+    sum += Sim.species[p]->getMass(p.getID()) * p.getVelocity().nrm2();
+  return sum / (NDIM * Sim.N() * Sim.units.unitEnergy());
+}
+
+// The NTC cells of a homogeneous system must give the same collision
+// rate and cooling as drawing the pairs from the whole system, for
+// any number of threads. The run stops before the cooling system
+// clusters, which the cells (correctly) see as a raised collision
+// rate.
+BOOST_AUTO_TEST_CASE(DSMCCells_MatchGlobal) {
+  dynamo::Simulation global;
+  init(global, 0, 1);
+  while (global.eventCount < 15000)
+    global.runSimulationStep(true);
+  const double runTime = global.systemTime;
+  const double globalT = temperature(global);
+  // The system must have cooled significantly for the comparison to
+  // mean anything
+  BOOST_CHECK(globalT < 0.5);
+
+  for (const size_t threads : {size_t(1), size_t(3)}) {
+    dynamo::Simulation cells;
+    init(cells, 0.25, threads);
+    while (cells.systemTime < runTime)
+      cells.runSimulationStep(true);
+
+    BOOST_CHECK_CLOSE(double(cells.eventCount), double(global.eventCount), 3);
+    // The temperature of this small system fluctuates by a few
+    // percent between random number streams
+    BOOST_CHECK_CLOSE(temperature(cells), globalT, 6);
+  }
+}
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+#   dynamo:- Event driven molecular dynamics simulator
+#   http://www.dynamomd.org
+#   Copyright (C) 2009  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+#
+#   This program is free software: you can redistribute it and/or
+#   modify it under the terms of the GNU General Public License
+#   version 3 as published by the Free Software Foundation.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Checks the logZ's of dynahist_rw against two synthetic, overlapping
+# histograms with known partition functions, both when the histograms
+# are parsed from the XML and when they are read back from the
+# .histcache files.
+import os
+import sys
+import math
+import getopt
+import subprocess
+
+shortargs=""
+longargs=["dynahist_rw="]
+try:
+    options, args = getopt.gnu_getopt(sys.argv[1:], shortargs, longargs)
+except getopt.GetoptError as err:
+    print(str(err))
+    sys.exit(2)
+
+dynahist_rw_cmd="NOT SET"
+
+for o,a in options:
+    if o == "--dynahist_rw":
+        dynahist_rw_cmd = a
+
+if not(os.path.isfile(dynahist_rw_cmd) and os.access(dynahist_rw_cmd, os.X_OK)):
+    raise RuntimeError("Failed to find dynahist_rw executabe at "+dynahist_rw_cmd)
+
+# A density of states g(E) = (1+E)^3 on unit bins, sampled at two
+# temperatures. The exact histograms are P_k(E) = g(E) e^{-E/T_k} / Z_k.
+binWidth = 1.0
+energies = [float(E) for E in range(80)]
+def logg(E):
+    return 3 * math.log(1 + E)
+
+Temperatures = [2.0, 1.0]
+
+def write_histograms(prefix, Emax):
+    """Writes the histograms, only sampling the energies below Emax
+    for the coldest temperature, and returns the file names and
+    histograms."""
+    fileNames = []
+    histograms = []
+    for i, T in enumerate(Temperatures):
+        Es = [E for E in energies if T != min(Temperatures) or E < Emax]
+        weights = [math.exp(logg(E) - E / T) for E in Es]
+        Z = sum(weights)
+        histograms.append((T, dict((E, w / Z) for E, w in zip(Es, weights))))
+        fileName = prefix + str(i) + ".xml"
+        fileNames.append(fileName)
+        with open(fileName, "w") as f:
+            f.write('<?xml version="1.0"?>\n<OutputData>\n')
+            f.write('<EnergyHist BinWidth="%r" T="%r">\n' % (binWidth, T))
+            f.write('<HistogramWeighted>\n')
+            for E, P in sorted(histograms[-1][1].items()):
+                # The histograms are written as a probability density
+                f.write("%r %r\n" % (E, P / binWidth))
+            f.write('</HistogramWeighted>\n</EnergyHist>\n</OutputData>\n')
+        if os.path.exists(fileName + ".histcache"):
+            os.remove(fileName + ".histcache")
+    return fileNames, histograms
+
+def reference_logZ(histograms):
+    """The self-consistent multiple histogram solution, by direct
+    iteration, relative to the coldest temperature."""
+    histograms = sorted(histograms)
+    N = {}
+    for T, hist in histograms:
+        for E, P in hist.items():
+            N[E] = N.get(E, 0) + P
+    logZ = [0.0] * len(histograms)
+    for iteration in range(100000):
+        g = dict((E, n / sum(math.exp(-E / T - lZ) for (T, h), lZ
+                                    in zip(histograms, logZ)))
+                 for E, n in N.items())
+        new = [math.log(sum(gE * math.exp(-E / T) for E, gE in g.items()))
+               for T, h in histograms]
+        new = [val - new[0] for val in new]
+        if max(abs(a - b) for a, b in zip(new, logZ)) < 1e-15:
+            break
+        logZ = new
+    return new
+
+def run(extra_args, fileNames):
+    cmd = [dynahist_rw_cmd, "-N1", "--n-threads=2"] + extra_args + fileNames
+    print(" ".join(cmd))
+    if subprocess.call(cmd) != 0:
+        raise RuntimeError("dynahist_rw failed")
+    return [float(line.split()[1]) for line in open("logZ.out")]
+
+def check(name, logZ, expected):
+    if len(logZ) != len(expected):
+        print(name, "gave", len(logZ), "logZ's, expected", len(expected))
+        return 1
+    errors = 0
+    for val, ref in zip(logZ, expected):
+        if abs(val - ref) > 1e-9 * max(1, abs(ref)):
+            errors += 1
+            print(name, "logZ is incorrect:", val, "!=", ref)
+    return errors
+
+error_count = 0
+
+# With complete histograms the logZ's are the exact partition
+# functions, and the parsed and cached histograms must agree.
+fileNames, histograms = write_histograms("dynahist_o", energies[-1] + 1)
+expected = [math.log(sum(math.exp(logg(E) - E / T) for E in energies))
+            for T in sorted(Temperatures)]
+expected = [val - expected[0] for val in expected]
+results = {}
+results["xml"] = run([], fileNames)
+for fileName in fileNames:
+    if not os.path.exists(fileName + ".histcache"):
+        error_count += 1
+        print("No histogram cache was written for", fileName)
+results["cache"] = run([], fileNames)
+results["no-cache"] = run(["--no-cache"], fileNames)
+
+for name, logZ in results.items():
+    error_count += check(name, logZ, expected)
+
+if results["xml"] != results["cache"]:
+    error_count += 1
+    print("The cached histograms gave different logZ's",
+          results["xml"], results["cache"])
+
+# A truncated cold histogram makes the initial guess inexact, so the
+# Newton iterations must find the self-consistent solution.
+fileNames, histograms = write_histograms("dynahist_t", 6)
+error_count += check("truncated", run(["--no-cache"], fileNames),
+                     reference_logZ(histograms))
+
+print("Total errors:", error_count)
+sys.exit(error_count > 0)
@@ -78,6 +78,24 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(PEL_standard, T, PEL_types) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(CompactEvent_expand) {
+  // Unset IDs and data must survive the 32 bit storage
+  const dynamo::Event blank;
+  BOOST_CHECK(dynamo::CompactEvent(blank).expand() == blank);
+  BOOST_CHECK_EQUAL(dynamo::CompactEvent(blank).expand()._additionalData2,
+                    blank._additionalData2);
+
+  const dynamo::Event wall(12, 0.5, dynamo::LOCAL, dynamo::WALL, 3,
+                           8 * 1001 + 2, 7);
+  const dynamo::Event expanded = dynamo::CompactEvent(wall).expand();
+  BOOST_CHECK(expanded == wall);
+  BOOST_CHECK_EQUAL(expanded._additionalData2, wall._additionalData2);
+
+  const dynamo::Event recalc(5, -std::numeric_limits<float>::infinity(),
+                             dynamo::SCHEDULER, dynamo::RECALCULATE, 0);
+  BOOST_CHECK(dynamo::CompactEvent(recalc).expand() == recalc);
+}
+
 #include <dynamo/schedulers/sorters/CBTFEL.hpp>
 #include <dynamo/schedulers/sorters/boundedPQFEL.hpp>
 #include <dynamo/schedulers/sorters/referenceFEL.hpp>
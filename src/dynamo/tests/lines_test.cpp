@@ -33,7 +33,7 @@ void init(dynamo::Simulation &Sim, const double density) {
   const size_t N = 1000;
 
   dynamo::CURandom packroutine(N, dynamo::Vector{1, 1, 1},
-                               new dynamo::UParticle());
+                               new dynamo::UParticle(), Sim.ranGenerator());
   packroutine.initialise();
   std::vector<dynamo::Vector> latticeSites(
       packroutine.placeObjects(dynamo::Vector{0, 0, 0}));
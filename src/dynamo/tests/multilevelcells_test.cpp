@@ -0,0 +1,147 @@
+#define BOOST_TEST_MODULE MultiLevelCells_test
+#include <boost/test/included/unit_test.hpp>
+#include <dynamo/BC/BC.hpp>
+#include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/globals/cells.hpp>
+#include <dynamo/globals/multiLevelCells.hpp>
+#include <dynamo/inputplugins/cells/include.hpp>
+#include <dynamo/inputplugins/include.hpp>
+#include <dynamo/interactions/hardsphere.hpp>
+#include <dynamo/property.hpp>
+#include <dynamo/ranges/IDPairRangeAll.hpp>
+#include <dynamo/ranges/IDRangeAll.hpp>
+#include <dynamo/simulation.hpp>
+#include <dynamo/species/point.hpp>
+
+#include <algorithm>
+#include <random>
+
+std::mt19937 RNG;
+
+dynamo::Vector getRandVelVec() {
+  std::normal_distribution<> normal_dist(0.0, (1.0 / sqrt(double(NDIM))));
+
+  dynamo::Vector tmpVec;
+  for (size_t iDim = 0; iDim < NDIM; iDim++)
+    tmpVec[iDim] = normal_dist(RNG);
+
+  return tmpVec;
+}
+
+const double smallDiam = 0.03;
+const double largeDiam = 0.095;
+
+// A mixture of large and small spheres, the large spheres sit on every
+// 20th site of an FCC lattice.
+void init(dynamo::Simulation &Sim) {
+  RNG.seed(12345);
+  Sim.ranGenerator.seed(54321);
+
+  std::unique_ptr<dynamo::UCell> packptr(
+      new dynamo::CUFCC(std::array<long, 3>{{7, 7, 7}}, dynamo::Vector{1, 1, 1},
+                        new dynamo::UParticle()));
+  packptr->initialise();
+  std::vector<dynamo::Vector> latticeSites(
+      packptr->placeObjects(dynamo::Vector{0, 0, 0}));
+  Sim.primaryCellSize = dynamo::Vector{1, 1, 1};
+
+  dynamo::shared_ptr<dynamo::ParticleProperty> D(new dynamo::ParticleProperty(
+      latticeSites.size(), dynamo::Property::Units::Length(), "D", smallDiam));
+  for (size_t i(0); i < latticeSites.size(); i += 20)
+    D->getProperty(i) = largeDiam;
+  Sim._properties.push(D);
+
+  Sim.interactions.push_back(dynamo::shared_ptr<dynamo::Interaction>(
+      new dynamo::IHardSphere(&Sim, "D", 1.0, new dynamo::IDPairRangeAll(),
+                              "Bulk")));
+  Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(
+      new dynamo::SpPoint(&Sim, new dynamo::IDRangeAll(&Sim), 1.0, "Bulk", 0)));
+  Sim.units.setUnitLength(smallDiam);
+
+  unsigned long nParticles = 0;
+  for (const dynamo::Vector &position : latticeSites)
+    Sim.particles.push_back(dynamo::Particle(
+        position, getRandVelVec() * Sim.units.unitVelocity(), nParticles++));
+
+  Sim.ensemble = dynamo::Ensemble::loadEnsemble(Sim);
+
+  dynamo::InputPlugin(&Sim, "Rescaler").zeroMomentum();
+  dynamo::InputPlugin(&Sim, "Rescaler").rescaleVels(1.0);
+}
+
+// The multi-level cells must give the same trajectory as the regular
+// cells, while testing fewer particles for events.
+BOOST_AUTO_TEST_CASE(MultiLevelCells_Trajectory) {
+  {
+    dynamo::Simulation Sim;
+    init(Sim);
+    Sim.writeXMLfile("multilevel_start.xml");
+  }
+
+  dynamo::Simulation cells;
+  cells.loadXMLfile("multilevel_start.xml");
+  cells.endEventCount = 3000;
+  cells.initialise();
+  while (cells.runSimulationStep(true)) {
+  }
+  cells.dynamics->updateAllParticles();
+
+  dynamo::Simulation multi;
+  multi.loadXMLfile("multilevel_start.xml");
+  multi.globals.push_back(dynamo::shared_ptr<dynamo::Global>(
+      new dynamo::GMultiLevelCells(&multi, "SchedulerNBList")));
+  multi.endEventCount = 3000;
+  multi.initialise();
+  while (multi.runSimulationStep(true)) {
+  }
+  multi.dynamics->updateAllParticles();
+
+  auto list = std::dynamic_pointer_cast<dynamo::GMultiLevelCells>(
+      multi.globals["SchedulerNBList"]);
+  BOOST_REQUIRE(list);
+
+  // The large and small spheres are on different levels
+  BOOST_CHECK(list->getLevelCount() > 1);
+  BOOST_CHECK(list->getParticleLevel(0) < list->getParticleLevel(1));
+
+  BOOST_CHECK_EQUAL(multi.eventCount, cells.eventCount);
+  BOOST_CHECK_CLOSE(multi.systemTime, cells.systemTime, 1e-8);
+  BOOST_REQUIRE_EQUAL(multi.N(), cells.N());
+  // The lists stream particles at different times, so the round-off
+  // differs and is amplified by each collision.
+  for (size_t i(0); i < cells.N(); ++i) {
+    dynamo::Vector dr =
+        multi.particles[i].getPosition() - cells.particles[i].getPosition();
+    cells.BCs->applyBC(dr);
+    BOOST_CHECK_SMALL(dr.nrm() / cells.units.unitLength(), 1e-5);
+  }
+
+  // Every pair within its interaction range is found, and fewer
+  // neighbours are tested than with the regular cells.
+  auto cellList = std::dynamic_pointer_cast<dynamo::GNeighbourList>(
+      cells.globals["SchedulerNBList"]);
+  BOOST_REQUIRE(cellList);
+  size_t multiTotal(0), cellTotal(0);
+  for (size_t i(0); i < multi.N(); ++i) {
+    std::vector<size_t> neighbours, cellNeighbours;
+    list->getParticleNeighbours(multi.particles[i], neighbours);
+    cellList->getParticleNeighbours(cells.particles[i], cellNeighbours);
+    multiTotal += neighbours.size();
+    cellTotal += cellNeighbours.size();
+    std::sort(neighbours.begin(), neighbours.end());
+
+    for (size_t j(0); j < multi.N(); ++j) {
+      if (i == j)
+        continue;
+      dynamo::Vector rij =
+          multi.particles[i].getPosition() - multi.particles[j].getPosition();
+      multi.BCs->applyBC(rij);
+      const dynamo::Interaction &interaction = *multi.interactions[0];
+      if (rij.nrm() <= interaction.getInteractionRadius(i) +
+                           interaction.getInteractionRadius(j))
+        BOOST_CHECK(
+            std::binary_search(neighbours.begin(), neighbours.end(), j));
+    }
+  }
+  BOOST_CHECK(multiTotal < cellTotal);
+}
@@ -0,0 +1,112 @@
+#define BOOST_TEST_MODULE PairSearch_test
+#include <boost/test/included/unit_test.hpp>
+#include <dynamo/BC/LEBC.hpp>
+#include <dynamo/BC/None.hpp>
+#include <dynamo/BC/PBC.hpp>
+#include <dynamo/pairsearch.hpp>
+#include <dynamo/simulation.hpp>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+typedef std::vector<std::pair<size_t, size_t>> PairList;
+
+std::mt19937 RNG;
+
+// Scatters particles over (and slightly beyond) the primary image,
+// so the search must apply the boundary conditions itself.
+void init(dynamo::Simulation &Sim, const size_t N) {
+  RNG.seed(12345);
+  Sim.primaryCellSize = dynamo::Vector{1.0, 0.8, 1.2};
+  std::uniform_real_distribution<> uniform(-0.6, 0.6);
+  for (size_t i(0); i < N; ++i) {
+    dynamo::Vector pos;
+    for (size_t iDim = 0; iDim < NDIM; ++iDim)
+      pos[iDim] = uniform(RNG) * Sim.primaryCellSize[iDim];
+    Sim.particles.push_back(
+        dynamo::Particle(pos, dynamo::Vector{0, 0, 0}, i));
+  }
+}
+
+PairList bruteForce(const dynamo::Simulation &Sim, const double cutoff) {
+  PairList pairs;
+  for (size_t i(0); i < Sim.N(); ++i)
+    for (size_t j(i + 1); j < Sim.N(); ++j) {
+      dynamo::Vector pi = Sim.particles[i].getPosition(),
+                     pj = Sim.particles[j].getPosition();
+      Sim.BCs->applyBC(pi);
+      Sim.BCs->applyBC(pj);
+      dynamo::Vector rij = pi - pj;
+      Sim.BCs->applyBC(rij);
+      if (rij.nrm() <= cutoff)
+        pairs.push_back(std::make_pair(i, j));
+    }
+  return pairs;
+}
+
+// The pairs found by forEachPair and forEachNeighbour must match a
+// brute force search, for any number of threads.
+void checkSearch(const dynamo::Simulation &Sim, const double cutoff) {
+  const PairList expected = bruteForce(Sim, cutoff);
+  BOOST_REQUIRE(!expected.empty());
+
+  const dynamo::PairSearch search(&Sim, cutoff);
+  for (const size_t nthreads : {size_t(1), size_t(3)}) {
+    std::vector<PairList> found(nthreads);
+    const size_t blocks = search.forEachPair(
+        nthreads, [&](size_t block, const dynamo::Particle &p1,
+                      const dynamo::Particle &p2) {
+          BOOST_CHECK(p1.getID() < p2.getID());
+          found[block].push_back(std::make_pair(p1.getID(), p2.getID()));
+        });
+    BOOST_CHECK(blocks <= nthreads);
+
+    PairList pairs;
+    for (const PairList &list : found)
+      pairs.insert(pairs.end(), list.begin(), list.end());
+    std::sort(pairs.begin(), pairs.end());
+    BOOST_CHECK(pairs == expected);
+  }
+
+  PairList neighbours;
+  for (const dynamo::Particle &p1 : Sim.particles)
+    search.forEachNeighbour(p1, [&](const dynamo::Particle &p2) {
+      BOOST_CHECK(p1.getID() != p2.getID());
+      if (p1.getID() < p2.getID())
+        neighbours.push_back(std::make_pair(p1.getID(), p2.getID()));
+    });
+  std::sort(neighbours.begin(), neighbours.end());
+  BOOST_CHECK(neighbours == expected);
+}
+
+BOOST_AUTO_TEST_CASE(PairSearch_Periodic) {
+  dynamo::Simulation Sim;
+  Sim.BCs = dynamo::shared_ptr<dynamo::BoundaryCondition>(
+      new dynamo::BCPeriodic(&Sim));
+  init(Sim, 2000);
+  checkSearch(Sim, 0.07);
+  // Fewer than three cells in each direction
+  checkSearch(Sim, 0.35);
+}
+
+BOOST_AUTO_TEST_CASE(PairSearch_NonPeriodic) {
+  dynamo::Simulation Sim;
+  Sim.BCs =
+      dynamo::shared_ptr<dynamo::BoundaryCondition>(new dynamo::BCNone(&Sim));
+  init(Sim, 2000);
+  checkSearch(Sim, 0.07);
+  checkSearch(Sim, 0.35);
+}
+
+BOOST_AUTO_TEST_CASE(PairSearch_LeesEdwards) {
+  dynamo::Simulation Sim;
+  auto LEBC = dynamo::shared_ptr<dynamo::BCLeesEdwards>(
+      new dynamo::BCLeesEdwards(&Sim));
+  Sim.BCs = LEBC;
+  init(Sim, 2000);
+  // Slide the boundary part of a cell width
+  LEBC->update(0.37);
+  checkSearch(Sim, 0.07);
+}
@@ -0,0 +1,98 @@
+#define BOOST_TEST_MODULE Potential_test
+#include <boost/test/included/unit_test.hpp>
+#include <dynamo/interactions/potentials/lennard_jones.hpp>
+#include <dynamo/interactions/potentials/potential.hpp>
+#include <magnet/thread/parallel_for.hpp>
+#include <random>
+
+// The original linear search over the steps of a potential
+size_t linearStepID(const dynamo::Potential &pot, const double r) {
+  size_t retval(0);
+  if (pot.direction())
+    for (; (retval < pot.steps()) && (r > pot[retval].first); ++retval) {
+    }
+  else
+    for (; (retval < pot.steps()) && (r < pot[retval].first); ++retval) {
+    }
+  return retval;
+}
+
+void checkLookup(const dynamo::Potential &pot, const double rmin,
+                 const double rmax) {
+  std::mt19937 RNG(12345);
+  std::uniform_real_distribution<> dist(rmin, rmax);
+  for (size_t i(0); i < 10000; ++i) {
+    const double r = dist(RNG);
+    BOOST_CHECK_EQUAL(pot.calculateStepID(r), linearStepID(pot, r));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Stepped_Lookup) {
+  typedef std::pair<double, double> Step;
+  std::vector<Step> steps;
+  for (size_t i(1); i <= 10; ++i)
+    steps.push_back(Step{0.1 * i, 0.1 * (11 - i)});
+
+  dynamo::PotentialStepped inward(steps, false);
+  checkLookup(inward, 0, 1.5);
+  BOOST_CHECK_EQUAL(inward.calculateStepID(2.0), 0u);
+  BOOST_CHECK_EQUAL(inward.calculateStepID(0.05), 10u);
+
+  dynamo::PotentialStepped outward(steps, true);
+  checkLookup(outward, 0, 1.5);
+  BOOST_CHECK_EQUAL(outward.calculateStepID(0.05), 0u);
+  BOOST_CHECK_EQUAL(outward.calculateStepID(2.0), 10u);
+}
+
+BOOST_AUTO_TEST_CASE(LennardJones_Lookup) {
+  // Energy stepping has an unbounded number of steps, which are
+  // calculated lazily
+  dynamo::PotentialLennardJones deltaU(1, 1, 3,
+                                       dynamo::PotentialLennardJones::VOLUME,
+                                       dynamo::PotentialLennardJones::DELTAU,
+                                       10);
+  checkLookup(deltaU, 0.8, 3.5);
+
+  dynamo::PotentialLennardJones deltaR(1, 1, 3,
+                                       dynamo::PotentialLennardJones::MIDPOINT,
+                                       dynamo::PotentialLennardJones::DELTAR,
+                                       10);
+  checkLookup(deltaR, 0.01, 3.5);
+}
+
+// Many threads extending the cache of one shared potential must see
+// the same steps as a serial lookup.
+BOOST_AUTO_TEST_CASE(LennardJones_Shared) {
+  const size_t N = 20000;
+  std::vector<double> radii(N);
+  std::mt19937 RNG(54321);
+  std::uniform_real_distribution<> dist(0.75, 3.5);
+  for (double &r : radii)
+    r = dist(RNG);
+
+  dynamo::PotentialLennardJones serial(
+      1, 1, 3, dynamo::PotentialLennardJones::VOLUME,
+      dynamo::PotentialLennardJones::DELTAU, 10);
+  std::vector<size_t> expected(N);
+  for (size_t i(0); i < N; ++i)
+    expected[i] = serial.calculateStepID(radii[i]);
+
+  dynamo::PotentialLennardJones shared(
+      1, 1, 3, dynamo::PotentialLennardJones::VOLUME,
+      dynamo::PotentialLennardJones::DELTAU, 10);
+  std::vector<size_t> found(N);
+  std::vector<double> energies(N);
+  magnet::thread::parallel_for(
+      0, N, 4, [&](size_t, size_t begin, size_t end) {
+        for (size_t i(begin); i < end; ++i) {
+          found[i] = shared.calculateStepID(radii[i]);
+          energies[i] = found[i] ? shared[found[i] - 1].second : 0;
+        }
+      });
+
+  for (size_t i(0); i < N; ++i) {
+    BOOST_CHECK_EQUAL(found[i], expected[i]);
+    BOOST_CHECK_EQUAL(energies[i],
+                      expected[i] ? serial[expected[i] - 1].second : 0);
+  }
+}
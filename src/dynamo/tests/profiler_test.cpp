@@ -0,0 +1,109 @@
+#define BOOST_TEST_MODULE Profiler_test
+#include <boost/test/included/unit_test.hpp>
+#include <dynamo/inputplugins/cells/include.hpp>
+#include <dynamo/inputplugins/include.hpp>
+#include <dynamo/interactions/hardsphere.hpp>
+#include <dynamo/profiler.hpp>
+#include <dynamo/ranges/IDPairRangeAll.hpp>
+#include <dynamo/ranges/IDRangeAll.hpp>
+#include <dynamo/simulation.hpp>
+#include <dynamo/species/point.hpp>
+
+#include <random>
+
+// Stages are attributed to the current event, and clear() resets
+// every counter.
+BOOST_AUTO_TEST_CASE(Profiler_Counters) {
+  dynamo::Profiler profiler;
+  profiler.clear();
+
+  profiler.setCurrentEvent(
+      dynamo::Event(0, 1.0, dynamo::INTERACTION, dynamo::CORE, 0, 1));
+  profiler.record(dynamo::Profiler::SORTER_PUSH, 10);
+  profiler.record(dynamo::Profiler::SORTER_PUSH, 5);
+  { dynamo::Profiler::Scope scope(profiler, dynamo::Profiler::SORTER_POP); }
+
+  profiler.setCurrentEvent(
+      dynamo::Event(0, 1.0, dynamo::GLOBAL, dynamo::CELL, 0));
+  profiler.record(dynamo::Profiler::SORTER_PUSH, 7);
+
+  const auto &core = profiler.getCounter(dynamo::Profiler::SORTER_PUSH,
+                                         dynamo::INTERACTION, dynamo::CORE);
+  BOOST_CHECK_EQUAL(core.calls, 2);
+  BOOST_CHECK_EQUAL(core.cycles, 15);
+  BOOST_CHECK_EQUAL(profiler
+                        .getCounter(dynamo::Profiler::SORTER_POP,
+                                    dynamo::INTERACTION, dynamo::CORE)
+                        .calls,
+                    1);
+  const auto &cell = profiler.getCounter(dynamo::Profiler::SORTER_PUSH,
+                                         dynamo::GLOBAL, dynamo::CELL);
+  BOOST_CHECK_EQUAL(cell.calls, 1);
+  BOOST_CHECK_EQUAL(cell.cycles, 7);
+
+  profiler.clear();
+  BOOST_CHECK_EQUAL(core.calls, 0);
+  BOOST_CHECK_EQUAL(cell.calls, 0);
+}
+
+#ifdef DYNAMO_PROFILER
+std::mt19937 RNG;
+
+dynamo::Vector getRandVelVec() {
+  std::normal_distribution<> normal_dist(0.0, (1.0 / sqrt(double(NDIM))));
+
+  dynamo::Vector tmpVec;
+  for (size_t iDim = 0; iDim < NDIM; iDim++)
+    tmpVec[iDim] = normal_dist(RNG);
+
+  return tmpVec;
+}
+
+void init(dynamo::Simulation &Sim, const double density) {
+  RNG.seed(12345);
+  Sim.ranGenerator.seed(54321);
+
+  std::unique_ptr<dynamo::UCell> packptr(
+      new dynamo::CUFCC(std::array<long, 3>{{5, 5, 5}}, dynamo::Vector{1, 1, 1},
+                        new dynamo::UParticle()));
+  packptr->initialise();
+  std::vector<dynamo::Vector> latticeSites(
+      packptr->placeObjects(dynamo::Vector{0, 0, 0}));
+  Sim.primaryCellSize = dynamo::Vector{1, 1, 1};
+
+  double particleDiam = std::cbrt(density / latticeSites.size());
+  Sim.interactions.push_back(dynamo::shared_ptr<dynamo::Interaction>(
+      new dynamo::IHardSphere(&Sim, particleDiam, 1.0,
+                              new dynamo::IDPairRangeAll(), "Bulk")));
+  Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(
+      new dynamo::SpPoint(&Sim, new dynamo::IDRangeAll(&Sim), 1.0, "Bulk", 0)));
+  Sim.units.setUnitLength(particleDiam);
+
+  unsigned long nParticles = 0;
+  for (const dynamo::Vector &position : latticeSites)
+    Sim.particles.push_back(dynamo::Particle(
+        position, getRandVelVec() * Sim.units.unitVelocity(), nParticles++));
+
+  Sim.ensemble = dynamo::Ensemble::loadEnsemble(Sim);
+
+  dynamo::InputPlugin(&Sim, "Rescaler").zeroMomentum();
+  dynamo::InputPlugin(&Sim, "Rescaler").rescaleVels(1.0);
+}
+
+// The executed collisions of a hard sphere run are attributed to
+// the core events.
+BOOST_AUTO_TEST_CASE(Profiler_Simulation) {
+  dynamo::Simulation Sim;
+  init(Sim, 0.5);
+  Sim.endEventCount = 5000;
+  Sim.initialise();
+  while (Sim.runSimulationStep()) {
+  }
+
+  const auto &runs = Sim.profiler.getCounter(
+      dynamo::Profiler::EVENT_EXECUTION, dynamo::INTERACTION, dynamo::CORE);
+  BOOST_CHECK(runs.calls > 0);
+  BOOST_CHECK(runs.calls <= Sim.eventCount);
+  BOOST_CHECK(runs.cycles > 0);
+}
+#endif
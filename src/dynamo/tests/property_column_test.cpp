@@ -0,0 +1,60 @@
+#define BOOST_TEST_MODULE PropertyColumn_test
+#include <boost/test/included/unit_test.hpp>
+#include <dynamo/property.hpp>
+
+#include <vector>
+
+// A Property without contiguous storage, whose values can change
+class FunctionProperty : public dynamo::Property {
+public:
+  FunctionProperty() : Property(Units::Dimensionless()) {}
+
+  virtual const double getProperty(size_t ID) const { return offset + ID; }
+
+  virtual std::string getName() const { return "Function"; }
+
+  virtual void outputXML(magnet::xml::XmlStream &) const {}
+
+  double offset = 1;
+};
+
+BOOST_AUTO_TEST_CASE(PropertyColumn_Views) {
+  dynamo::NumericProperty numeric(2.5, dynamo::Property::Units::Length());
+  const dynamo::PropertyColumn uniform = numeric.getColumn(10);
+  BOOST_CHECK(uniform.valid());
+  BOOST_CHECK(uniform.isUniform());
+  BOOST_CHECK_EQUAL(uniform[7], 2.5);
+  // Unit rescaling is seen through the column
+  numeric.rescaleUnit(dynamo::Property::Units::L, 2.0);
+  BOOST_CHECK_EQUAL(uniform[7], 5.0);
+
+  dynamo::ParticleProperty particle(4, dynamo::Property::Units::Length(),
+                                    "D", 1.0);
+  particle.getProperty(2) = 3.0;
+  const dynamo::PropertyColumn column = particle.getColumn(4);
+  BOOST_CHECK(!column.isUniform());
+  BOOST_CHECK_EQUAL(column[2], 3.0);
+  BOOST_CHECK_EQUAL(column(1, 2), 2.0);
+  BOOST_CHECK_THROW(particle.getColumn(5), std::exception);
+
+  // Only the particles passed decide if the column can be folded
+  BOOST_CHECK(column.foldUniform(std::vector<size_t>{0, 1, 3}).isUniform());
+  BOOST_CHECK(!column.foldUniform(std::vector<size_t>{0, 2}).isUniform());
+  BOOST_CHECK_EQUAL(column.foldUniform(std::vector<size_t>{0, 3})[2], 1.0);
+
+  BOOST_CHECK(!dynamo::PropertyColumn().valid());
+}
+
+// Other Property types are read through the Property, not a copy
+BOOST_AUTO_TEST_CASE(PropertyColumn_Fallback) {
+  FunctionProperty function;
+  const dynamo::PropertyColumn column = function.getColumn(10);
+  BOOST_CHECK(column.valid());
+  BOOST_CHECK(!column.isUniform());
+  BOOST_CHECK_EQUAL(column[3], 4.0);
+  BOOST_CHECK_EQUAL(column(3, 5), 5.0);
+  BOOST_CHECK(!column.foldUniform(std::vector<size_t>{1, 2}).isUniform());
+
+  function.offset = 10;
+  BOOST_CHECK_EQUAL(column[3], 13.0);
+}
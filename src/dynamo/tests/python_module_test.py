@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+#   dynamo:- Event driven molecular dynamics simulator 
+#   http://www.dynamomd.org
+#   Copyright (C) 2009  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+#
+#   This program is free software: you can redistribute it and/or
+#   modify it under the terms of the GNU General Public License
+#   version 3 as published by the Free Software Foundation.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Smoke test of the in-process simulation module (pydynamo._dynamo).
+import getopt
+import sys
+import threading
+
+options, args = getopt.gnu_getopt(sys.argv[1:], "", ["module-dir="])
+for o, a in options:
+    if o == "--module-dir":
+        sys.path.insert(0, a)
+
+import _dynamo
+
+sim = _dynamo.Simulation(seed=42)
+sim.pack(["-m", "0", "-C", "5", "-d", "0.5"])
+sim.initialise()
+N = sim.N
+if N != 4 * 5 ** 3:
+    raise RuntimeError("Unexpected particle count " + str(N))
+
+# Run by event count, then by time
+if sim.run(events=5000) != 5000:
+    raise RuntimeError("Did not run the requested number of events")
+
+start = sim.time
+sim.run(time=1.0)
+if abs(sim.time - start - 1.0) > 1e-8:
+    raise RuntimeError("Did not run for the requested time, ran "
+                       + str(sim.time - start))
+
+misc = sim.misc()
+if abs(misc["kT"] - 1.0) > 1e-8:
+    raise RuntimeError("Temperature drifted to " + str(misc["kT"]))
+
+# The particle arrays are zero-copy views of the particle data
+pos = sim.positions()
+if pos.shape != (N, 3) or not pos.readonly:
+    raise RuntimeError("Bad position array " + str(pos.shape))
+vel = sim.velocities()
+p = [sum(vel[i, d] for i in range(N)) for d in range(3)]
+if max(abs(x) for x in p) > 1e-8:
+    raise RuntimeError("Non-zero momentum " + str(p))
+
+# The particles cannot be replaced while they are being viewed
+try:
+    sim.pack(["-m", "0"])
+    raise RuntimeError("pack() succeeded while the particles were exported")
+except BufferError:
+    pass
+pos.release()
+vel.release()
+
+# The views are of the live particle data, and run() brings them up
+# to date before returning
+pos = sim.positions()
+before = [pos[i, 0] for i in range(N)]
+sim.run(time=0.5)
+after = [pos[i, 0] for i in range(N)]
+if after == before:
+    raise RuntimeError("The position view did not change during run()")
+fresh = sim.positions()
+if after != [fresh[i, 0] for i in range(N)]:
+    raise RuntimeError("The position view was stale after run()")
+fresh.release()
+pos.release()
+
+# Calls from other threads wait for a run to finish
+start = sim.event_count
+counts = []
+thread = threading.Thread(target=sim.run, kwargs={"events": 20000})
+thread.start()
+while thread.is_alive():
+    counts.append(sim.event_count)
+thread.join()
+if any(count not in (start, start + 20000) for count in counts):
+    raise RuntimeError("Read the event count during a run " + str(counts))
+if sim.event_count != start + 20000:
+    raise RuntimeError("The threaded run did not complete")
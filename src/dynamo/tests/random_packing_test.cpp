@@ -0,0 +1,69 @@
+#define BOOST_TEST_MODULE RandomPacking_test
+#include <boost/program_options.hpp>
+#include <boost/test/included/unit_test.hpp>
+#include <dynamo/BC/BC.hpp>
+#include <dynamo/inputplugins/packer.hpp>
+#include <dynamo/simulation.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace po = boost::program_options;
+
+// Packs monocomponent hard spheres by random sequential addition
+// (dynamod -m0 --i1 4) and returns the positions.
+std::vector<dynamo::Vector> pack(const unsigned int seed,
+                                 const size_t threads) {
+  po::options_description opts;
+  opts.add(dynamo::IPPacker::getOptions());
+  opts.add(dynamo::IPPacker::getHiddenOptions());
+
+  const char *argv[] = {"dynamod", "-m0",  "--i1", "4",
+                        "-C",      "12",   "-d",   "0.3"};
+  po::variables_map vm;
+  po::store(po::parse_command_line(sizeof(argv) / sizeof(argv[0]), argv, opts),
+            vm);
+  po::notify(vm);
+
+  dynamo::Simulation Sim;
+  Sim.ranGenerator.seed(seed);
+  Sim.threadCount = threads;
+  dynamo::IPPacker(vm, &Sim).initialise();
+
+  std::vector<dynamo::Vector> positions;
+  for (const dynamo::Particle &p : Sim.particles)
+    positions.push_back(p.getPosition());
+
+  // The packing must be free of overlaps, including across the
+  // periodic boundary
+  BOOST_REQUIRE_EQUAL(positions.size(), 12 * 12 * 12);
+  const double diameter = std::cbrt(0.3 / positions.size());
+  double minDist = HUGE_VAL;
+  for (size_t i(0); i < positions.size(); ++i)
+    for (size_t j(i + 1); j < positions.size(); ++j) {
+      dynamo::Vector rij = positions[i] - positions[j];
+      Sim.BCs->applyBC(rij);
+      minDist = std::min(minDist, rij.nrm());
+    }
+  BOOST_CHECK_GE(minDist, diameter * (1 - 1e-12));
+
+  return positions;
+}
+
+BOOST_AUTO_TEST_CASE(RandomPacking_Reproducible) {
+  for (const size_t threads : {size_t(1), size_t(3)}) {
+    const std::vector<dynamo::Vector> first = pack(123, threads);
+    const std::vector<dynamo::Vector> second = pack(123, threads);
+    const std::vector<dynamo::Vector> other = pack(456, threads);
+
+    bool same = true, differs = false;
+    for (size_t i(0); i < first.size(); ++i) {
+      same = same && (first[i] == second[i]);
+      differs = differs || (first[i] != other[i]);
+    }
+    BOOST_CHECK_MESSAGE(same, "The same seed gave a different packing with "
+                                  << threads << " threads");
+    BOOST_CHECK_MESSAGE(differs, "A different seed gave the same packing with "
+                                     << threads << " threads");
+  }
+}
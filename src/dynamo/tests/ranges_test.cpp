@@ -0,0 +1,135 @@
+#define BOOST_TEST_MODULE Ranges_test
+#include <boost/test/included/unit_test.hpp>
+#include <dynamo/ranges/include.hpp>
+#include <dynamo/simulation.hpp>
+#include <iterator>
+#include <vector>
+
+const size_t N = 100;
+
+void addParticles(dynamo::Simulation &Sim) {
+  for (size_t i(0); i < N; ++i)
+    Sim.particles.push_back(dynamo::Particle(
+        dynamo::Vector{0, 0, 0}, dynamo::Vector{0, 0, 0}, Sim.particles.size()));
+}
+
+// Checks that compiling a range does not change its contents or order
+void checkCompiledRange(dynamo::Simulation &Sim, dynamo::IDRange &range) {
+  std::vector<size_t> ids(range.begin(), range.end());
+  std::vector<bool> members;
+  for (const dynamo::Particle &p : Sim.particles)
+    members.push_back(range.isInRange(p));
+
+  range.compile(Sim.particles);
+
+  std::vector<size_t> compiled_ids(range.begin(), range.end());
+  BOOST_CHECK(ids == compiled_ids);
+  for (const dynamo::Particle &p : Sim.particles)
+    BOOST_CHECK_EQUAL(range.isInRange(p), members[p.getID()]);
+}
+
+void checkCompiledPairRange(dynamo::Simulation &Sim,
+                            dynamo::IDPairRange &range) {
+  std::vector<bool> members, pairs;
+  for (const dynamo::Particle &p1 : Sim.particles) {
+    members.push_back(range.isInRange(p1));
+    for (const dynamo::Particle &p2 : Sim.particles)
+      pairs.push_back(range.isInRange(p1, p2));
+  }
+
+  range.compile(Sim.particles);
+
+  for (const dynamo::Particle &p1 : Sim.particles) {
+    BOOST_CHECK_EQUAL(range.isInRange(p1), members[p1.getID()]);
+    for (const dynamo::Particle &p2 : Sim.particles)
+      BOOST_CHECK_EQUAL(range.isInRange(p1, p2),
+                        pairs[p1.getID() * N + p2.getID()]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(IDRange_compile) {
+  dynamo::Simulation Sim;
+  addParticles(Sim);
+
+  dynamo::IDRangeAll all(&Sim);
+  checkCompiledRange(Sim, all);
+
+  dynamo::IDRangeNone none;
+  checkCompiledRange(Sim, none);
+
+  dynamo::IDRangeRange ranged(10, 19);
+  checkCompiledRange(Sim, ranged);
+
+  dynamo::IDRangeList list(std::vector<size_t>{5, 3, 99, 3, 42});
+  checkCompiledRange(Sim, list);
+
+  // A union of two adjacent ranges compiles to an interval
+  dynamo::IDRangeUnion adjacent;
+  adjacent.addRange(new dynamo::IDRangeRange(0, 9));
+  adjacent.addRange(new dynamo::IDRangeRange(10, 14));
+  checkCompiledRange(Sim, adjacent);
+
+  dynamo::IDRangeUnion disjoint;
+  disjoint.addRange(new dynamo::IDRangeRange(50, 59));
+  disjoint.addRange(new dynamo::IDRangeList(std::vector<size_t>{7, 1}));
+  checkCompiledRange(Sim, disjoint);
+
+  // Changing a compiled range discards its compiled form
+  list.getContainer().push_back(77);
+  BOOST_CHECK(list.isInRange(Sim.particles[77]));
+  BOOST_CHECK_EQUAL(std::distance(list.begin(), list.end()), 6);
+  checkCompiledRange(Sim, list);
+
+  disjoint.addRange(new dynamo::IDRangeRange(90, 94));
+  BOOST_CHECK(disjoint.isInRange(Sim.particles[92]));
+  BOOST_CHECK_EQUAL(std::distance(disjoint.begin(), disjoint.end()), 17);
+  checkCompiledRange(Sim, disjoint);
+}
+
+BOOST_AUTO_TEST_CASE(IDPairRange_compile) {
+  dynamo::Simulation Sim;
+  addParticles(Sim);
+
+  dynamo::IDPairRangeAll all;
+  checkCompiledPairRange(Sim, all);
+
+  dynamo::IDPairRangeNone none;
+  checkCompiledPairRange(Sim, none);
+
+  dynamo::IDPairRangeSelf self(new dynamo::IDRangeRange(20, 29));
+  checkCompiledPairRange(Sim, self);
+
+  dynamo::IDPairRangeSingle single(new dynamo::IDRangeRange(0, 49));
+  checkCompiledPairRange(Sim, single);
+
+  dynamo::IDPairRangePair pair(
+      new dynamo::IDRangeRange(0, 9),
+      new dynamo::IDRangeList(std::vector<size_t>{50, 60, 70}));
+  checkCompiledPairRange(Sim, pair);
+
+  dynamo::IDPairRangeChains chains(0, 59, 10);
+  checkCompiledPairRange(Sim, chains);
+
+  dynamo::IDPairRangeUnion pairUnion(&Sim);
+  pairUnion.addRange(new dynamo::IDPairRangeChainEnds(60, 79, 5));
+  pairUnion.addRange(new dynamo::IDPairRangeRings(80, 99, 4));
+  pairUnion.addRange(new dynamo::IDPairRangeIntraChains(0, 29, 10));
+  checkCompiledPairRange(Sim, pairUnion);
+
+  dynamo::IDPairRangeList list;
+  list.addPair(3, 7);
+  list.addPair(42, 5);
+  list.addPair(7, 99);
+  checkCompiledPairRange(Sim, list);
+
+  // Pairs added after compilation are still found
+  list.addPair(11, 12);
+  BOOST_CHECK(list.isInRange(Sim.particles[12], Sim.particles[11]));
+  BOOST_CHECK(list.isInRange(Sim.particles[11]));
+  checkCompiledPairRange(Sim, list);
+
+  pairUnion.addRange(new dynamo::IDPairRangeSingle(
+      new dynamo::IDRangeList(std::vector<size_t>{95, 2})));
+  BOOST_CHECK(pairUnion.isInRange(Sim.particles[95], Sim.particles[2]));
+  checkCompiledPairRange(Sim, pairUnion);
+}
@@ -0,0 +1,131 @@
+#define BOOST_TEST_MODULE ShearingCells_test
+#include <boost/test/included/unit_test.hpp>
+#include <dynamo/BC/LEBC.hpp>
+#include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/globals/cellsShearing.hpp>
+#include <dynamo/inputplugins/cells/include.hpp>
+#include <dynamo/inputplugins/include.hpp>
+#include <dynamo/interactions/hardsphere.hpp>
+#include <dynamo/ranges/IDPairRangeAll.hpp>
+#include <dynamo/ranges/IDRangeAll.hpp>
+#include <dynamo/simulation.hpp>
+#include <dynamo/species/point.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <random>
+
+std::mt19937 RNG;
+
+dynamo::Vector getRandVelVec() {
+  std::normal_distribution<> normal_dist(0.0, (1.0 / sqrt(double(NDIM))));
+
+  dynamo::Vector tmpVec;
+  for (size_t iDim = 0; iDim < NDIM; iDim++)
+    tmpVec[iDim] = normal_dist(RNG);
+
+  return tmpVec;
+}
+
+// A box which is long in the flow (x) direction, so the window of
+// the opposite boundary layer is a small part of each row of cells.
+void init(dynamo::Simulation &Sim, const double density) {
+  RNG.seed(12345);
+  Sim.ranGenerator.seed(54321);
+
+  Sim.BCs = dynamo::shared_ptr<dynamo::BoundaryCondition>(
+      new dynamo::BCLeesEdwards(&Sim));
+
+  std::unique_ptr<dynamo::UCell> packptr(new dynamo::CUFCC(
+      std::array<long, 3>{{20, 5, 5}}, dynamo::Vector{4, 1, 1},
+      new dynamo::UParticle()));
+  packptr->initialise();
+  std::vector<dynamo::Vector> latticeSites(
+      packptr->placeObjects(dynamo::Vector{0, 0, 0}));
+  Sim.primaryCellSize = dynamo::Vector{4, 1, 1};
+
+  double particleDiam = std::cbrt(4 * density / latticeSites.size());
+  Sim.interactions.push_back(dynamo::shared_ptr<dynamo::Interaction>(
+      new dynamo::IHardSphere(&Sim, particleDiam, 0.9,
+                              new dynamo::IDPairRangeAll(), "Bulk")));
+  Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(
+      new dynamo::SpPoint(&Sim, new dynamo::IDRangeAll(&Sim), 1.0, "Bulk", 0)));
+  Sim.units.setUnitLength(particleDiam);
+
+  unsigned long nParticles = 0;
+  for (const dynamo::Vector &position : latticeSites)
+    Sim.particles.push_back(dynamo::Particle(
+        position, getRandVelVec() * Sim.units.unitVelocity(), nParticles++));
+
+  Sim.ensemble = dynamo::Ensemble::loadEnsemble(Sim);
+
+  dynamo::InputPlugin(&Sim, "Rescaler").zeroMomentum();
+  dynamo::InputPlugin(&Sim, "Rescaler").rescaleVels(1.0);
+}
+
+// Every pair within the interaction range must be in the
+// neighbourhood as the boundary slides, and the shear flow
+// throughput is reported.
+BOOST_AUTO_TEST_CASE(ShearingCells_Neighbours) {
+  dynamo::Simulation Sim;
+  init(Sim, 0.5);
+  BOOST_CHECK_EQUAL(Sim.N(), 2000);
+
+  // A zero event limit would skip the scheduler initialisation
+  Sim.endEventCount = std::numeric_limits<size_t>::max();
+  Sim.initialise();
+
+  auto cells = std::dynamic_pointer_cast<dynamo::GCellsShearing>(
+      Sim.globals["SchedulerNBList"]);
+  BOOST_REQUIRE(cells);
+  const dynamo::GNeighbourList &list = *cells;
+
+  const double rc = Sim.getLongestInteraction();
+  double runTime = 0;
+  size_t listed = 0;
+  for (size_t block(0); block < 5; ++block) {
+    const size_t endCount = Sim.eventCount + 4000;
+    const auto start = std::chrono::steady_clock::now();
+    while (Sim.eventCount < endCount)
+      Sim.runSimulationStep(true);
+    runTime += std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+
+    Sim.dynamics->updateAllParticles();
+    for (size_t i(0); i < Sim.N(); ++i) {
+      std::vector<size_t> neighbours;
+      list.getParticleNeighbours(Sim.particles[i], neighbours);
+      std::sort(neighbours.begin(), neighbours.end());
+      listed += neighbours.size();
+
+      for (size_t j(0); j < Sim.N(); ++j) {
+        if (i == j)
+          continue;
+        dynamo::Vector rij =
+            Sim.particles[i].getPosition() - Sim.particles[j].getPosition();
+        Sim.BCs->applyBC(rij);
+        if (rij.nrm() <= rc)
+          BOOST_CHECK_MESSAGE(
+              std::binary_search(neighbours.begin(), neighbours.end(), j),
+              "Particle " << j << " is in range of " << i
+                          << " but not a neighbour");
+      }
+    }
+  }
+
+  // The boundary must have slid past several cells for the shift
+  // events to have been tested
+  const auto LEBC =
+      std::dynamic_pointer_cast<dynamo::BCLeesEdwards>(Sim.BCs);
+  BOOST_CHECK(Sim.systemTime * LEBC->getShearRate() *
+                  Sim.primaryCellSize[1] >
+              3 * cells->getCellDimensions()[0]);
+  BOOST_CHECK_EQUAL(Sim.checkSystem(), 0);
+
+  BOOST_TEST_MESSAGE("Shear flow: " << Sim.eventCount / runTime
+                                    << " events/s, "
+                                    << double(listed) / (5 * Sim.N())
+                                    << " neighbours per particle");
+}
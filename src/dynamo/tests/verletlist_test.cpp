@@ -0,0 +1,138 @@
+#define BOOST_TEST_MODULE VerletList_test
+#include <boost/test/included/unit_test.hpp>
+#include <dynamo/BC/BC.hpp>
+#include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/globals/cells.hpp>
+#include <dynamo/globals/verletList.hpp>
+#include <dynamo/inputplugins/cells/include.hpp>
+#include <dynamo/inputplugins/include.hpp>
+#include <dynamo/interactions/hardsphere.hpp>
+#include <dynamo/ranges/IDPairRangeAll.hpp>
+#include <dynamo/ranges/IDRangeAll.hpp>
+#include <dynamo/simulation.hpp>
+#include <dynamo/species/point.hpp>
+
+#include <algorithm>
+#include <random>
+
+std::mt19937 RNG;
+
+dynamo::Vector getRandVelVec() {
+  std::normal_distribution<> normal_dist(0.0, (1.0 / sqrt(double(NDIM))));
+
+  dynamo::Vector tmpVec;
+  for (size_t iDim = 0; iDim < NDIM; iDim++)
+    tmpVec[iDim] = normal_dist(RNG);
+
+  return tmpVec;
+}
+
+void init(dynamo::Simulation &Sim, const double density) {
+  RNG.seed(12345);
+  Sim.ranGenerator.seed(54321);
+
+  std::unique_ptr<dynamo::UCell> packptr(
+      new dynamo::CUFCC(std::array<long, 3>{{5, 5, 5}}, dynamo::Vector{1, 1, 1},
+                        new dynamo::UParticle()));
+  packptr->initialise();
+  std::vector<dynamo::Vector> latticeSites(
+      packptr->placeObjects(dynamo::Vector{0, 0, 0}));
+  Sim.primaryCellSize = dynamo::Vector{1, 1, 1};
+
+  double particleDiam = std::cbrt(density / latticeSites.size());
+  Sim.interactions.push_back(dynamo::shared_ptr<dynamo::Interaction>(
+      new dynamo::IHardSphere(&Sim, particleDiam, 1.0,
+                              new dynamo::IDPairRangeAll(), "Bulk")));
+  Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(
+      new dynamo::SpPoint(&Sim, new dynamo::IDRangeAll(&Sim), 1.0, "Bulk", 0)));
+  Sim.units.setUnitLength(particleDiam);
+
+  unsigned long nParticles = 0;
+  for (const dynamo::Vector &position : latticeSites)
+    Sim.particles.push_back(dynamo::Particle(
+        position, getRandVelVec() * Sim.units.unitVelocity(), nParticles++));
+
+  Sim.ensemble = dynamo::Ensemble::loadEnsemble(Sim);
+
+  dynamo::InputPlugin(&Sim, "Rescaler").zeroMomentum();
+  dynamo::InputPlugin(&Sim, "Rescaler").rescaleVels(1.0);
+}
+
+// The Verlet list must give the same trajectory as the cell list,
+// while testing fewer particles for events.
+BOOST_AUTO_TEST_CASE(VerletList_Trajectory) {
+  {
+    dynamo::Simulation Sim;
+    init(Sim, 0.5);
+    Sim.writeXMLfile("verlet_start.xml");
+  }
+
+  dynamo::Simulation cells;
+  cells.loadXMLfile("verlet_start.xml");
+  cells.endEventCount = 2000;
+  cells.initialise();
+  while (cells.runSimulationStep(true)) {
+  }
+  cells.dynamics->updateAllParticles();
+
+  dynamo::Simulation verlet;
+  verlet.loadXMLfile("verlet_start.xml");
+  verlet.globals.push_back(
+      dynamo::shared_ptr<dynamo::Global>(new dynamo::GVerletList(
+          &verlet, "SchedulerNBList", 0.3 * verlet.units.unitLength())));
+  verlet.endEventCount = 2000;
+  verlet.initialise();
+  while (verlet.runSimulationStep(true)) {
+  }
+  verlet.dynamics->updateAllParticles();
+
+  auto list = std::dynamic_pointer_cast<dynamo::GVerletList>(
+      verlet.globals["SchedulerNBList"]);
+  BOOST_REQUIRE(list);
+  BOOST_CHECK(list->getRebuildCount() > 0);
+
+  BOOST_CHECK_EQUAL(verlet.eventCount, cells.eventCount);
+  BOOST_CHECK_CLOSE(verlet.systemTime, cells.systemTime, 1e-8);
+  BOOST_REQUIRE_EQUAL(verlet.N(), cells.N());
+  for (size_t i(0); i < cells.N(); ++i) {
+    dynamo::Vector dr = verlet.particles[i].getPosition() -
+                        cells.particles[i].getPosition();
+    cells.BCs->applyBC(dr);
+    BOOST_CHECK_SMALL(dr.nrm() / cells.units.unitLength(), 1e-8);
+  }
+
+  // Every pair within the interaction range is in both lists, and
+  // the lists are shorter than the cell neighbourhoods.
+  const double rc = verlet.getLongestInteraction();
+  auto cellList = std::dynamic_pointer_cast<dynamo::GNeighbourList>(
+      cells.globals["SchedulerNBList"]);
+  BOOST_REQUIRE(cellList);
+  size_t verletTotal(0), cellTotal(0);
+  for (size_t i(0); i < verlet.N(); ++i) {
+    std::vector<size_t> neighbours, cellNeighbours;
+    list->getParticleNeighbours(verlet.particles[i], neighbours);
+    cellList->getParticleNeighbours(cells.particles[i], cellNeighbours);
+    verletTotal += neighbours.size();
+    cellTotal += cellNeighbours.size();
+    BOOST_CHECK(std::is_sorted(neighbours.begin(), neighbours.end()));
+
+    for (size_t j(0); j < verlet.N(); ++j) {
+      if (i == j)
+        continue;
+      dynamo::Vector rij = verlet.particles[i].getPosition() -
+                           verlet.particles[j].getPosition();
+      verlet.BCs->applyBC(rij);
+      const bool listed =
+          std::binary_search(neighbours.begin(), neighbours.end(), j);
+      if (rij.nrm() <= rc)
+        BOOST_CHECK(listed);
+
+      // The lists are symmetric
+      std::vector<size_t> other;
+      list->getParticleNeighbours(verlet.particles[j], other);
+      BOOST_CHECK_EQUAL(listed,
+                        std::binary_search(other.begin(), other.end(), i));
+    }
+  }
+  BOOST_CHECK(verletTotal < cellTotal);
+}
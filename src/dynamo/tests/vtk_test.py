@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+#   dynamo:- Event driven molecular dynamics simulator 
+#   http://www.dynamomd.org
+#   Copyright (C) 2009  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+#
+#   This program is free software: you can redistribute it and/or
+#   modify it under the terms of the GNU General Public License
+#   version 3 as published by the Free Software Foundation.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import os
+import sys
+import getopt
+import struct
+import shutil
+import subprocess
+import zlib
+import xml.etree.ElementTree as ET
+
+shortargs=""
+longargs=["dynarun=", "dynamod="]
+try:
+    options, args = getopt.gnu_getopt(sys.argv[1:], shortargs, longargs)
+except getopt.GetoptError as err:
+    print(str(err))
+    sys.exit(2)
+
+dynarun_cmd="NOT SET"
+dynamod_cmd="NOT SET"
+
+for o,a in options:
+    if o == "--dynarun":
+        dynarun_cmd = a
+    if o == "--dynamod":
+        dynamod_cmd = a
+
+for name,exe in [("dynamod", dynamod_cmd), ("dynarun", dynarun_cmd)]:
+    if not(os.path.isfile(exe) and os.access(exe, os.X_OK)):
+        raise RuntimeError("Failed to find "+name+" executabe at "+exe)
+
+def read_arrays(filename):
+    """Returns the Float32 DataArrays of a VTK XML file by name."""
+    with open(filename, "rb") as f:
+        data = f.read()
+    appended = None
+    start = data.find(b"<AppendedData")
+    if start >= 0:
+        appended = data.index(b"_", data.index(b">", start)) + 1
+        # Parse the XML without the binary payload
+        data = data[:start] + b"</VTKFile>\n"
+    root = ET.fromstring(data)
+    compressed = "compressor" in root.attrib
+    arrays = {}
+    for node in root.iter("DataArray"):
+        if node.attrib["type"] != "Float32":
+            continue
+        if node.attrib["format"] == "ascii":
+            values = [float(x) for x in node.text.split()]
+        else:
+            with open(filename, "rb") as f:
+                raw = f.read()
+            pos = appended + int(node.attrib["offset"])
+            if compressed:
+                nblocks, = struct.unpack_from("<Q", raw, pos)
+                sizes = struct.unpack_from("<"+str(nblocks)+"Q", raw, pos + 24)
+                pos += 24 + 8 * nblocks
+                payload = b""
+                for size in sizes:
+                    payload += zlib.decompress(raw[pos:pos+size])
+                    pos += size
+            else:
+                size, = struct.unpack_from("<Q", raw, pos)
+                payload = raw[pos+8:pos+8+size]
+            values = list(struct.unpack("<"+str(len(payload)//4)+"f", payload))
+        arrays[node.attrib.get("Name", "")] = values
+    return arrays
+
+###### INITIALISATION
+subprocess.check_call([dynamod_cmd, "-m0", "-C5", "-d0.5", "-ovtk.xml"])
+
+###### RUNS
+results = {}
+for name, opts in [("ascii", "Format=ascii"), ("binary", ""), ("compressed", "Compress")]:
+    if os.path.isdir(name):
+        shutil.rmtree(name)
+    os.mkdir(name)
+    cmd=[dynarun_cmd, "../vtk.xml", "-c1000", "--random-seed=1", "-LVTK" + (":"+opts if opts else "")]
+    print(" ".join(cmd))
+    proc = subprocess.run(cmd, cwd=name, capture_output=True, text=True)
+    if proc.returncode != 0:
+        if name == "compressed" and "zlib support was not built in" in proc.stderr:
+            print("Skipping compressed output, no zlib support")
+            continue
+        print(proc.stdout, proc.stderr)
+        sys.exit(1)
+    results[name] = (read_arrays(os.path.join(name, "particles_00000.vtu")),
+                     read_arrays(os.path.join(name, "fields_00000.vti")))
+
+###### OUTPUT VALIDATION
+error_count = 0
+N = len(ET.parse("vtk.xml").getroot().findall(".//Pt"))
+reference = results["ascii"]
+for name, (particles, fields) in results.items():
+    if len(particles["Position"]) != 3 * N:
+        error_count += 1
+        print(name, "has", len(particles["Position"]) // 3, "points, expected", N)
+    for ref, arrays in [(reference[0], particles), (reference[1], fields)]:
+        for key, values in ref.items():
+            if len(arrays[key]) != len(values) or any(abs(a - b) > 1e-5 * max(1, abs(b)) for a, b in zip(arrays[key], values)):
+                error_count += 1
+                print(name, "array", key, "does not match the ascii output")
+
+print("Total errors:", error_count)
+sys.exit(error_count > 0)
@@ -136,5 +136,56 @@ private:
   const double _t_min, _t_max;
 };
 } // namespace detail
+
+/*! \brief Calculates a window of time outside of which two
+  offcentre spheres cannot overlap.
+
+  The offsets of the spheres only rotate (and scale with the growth
+  factor), so each sphere remains inside a bounding sphere about its
+  centre of rotation. The window is found by a cheap ray-sphere test
+  on the centres of rotation, and may be used to prune or narrow the
+  search window of detail::OffcentreSpheresOverlapFunction. The
+  bounding spheres are slightly enlarged so that the spheres are
+  guaranteed to be separated at the start of a window which begins
+  after t_min.
+
+  The arguments match those of
+  detail::OffcentreSpheresOverlapFunction.
+
+  \return The window [t_in, t_out] within [t_min, t_max], where
+  t_in > t_out if the spheres cannot overlap.
+*/
+inline std::pair<double, double>
+offcentre_spheres_window(const math::Vector &rij, const math::Vector &vij,
+                         const math::Vector &nu1, const math::Vector &nu2,
+                         const double diameter1, const double diameter2,
+                         const double t, const double invgamma,
+                         const double t_min, const double t_max) {
+  const double Gmax = std::max(1 + t * invgamma, 1 + (t + t_max) * invgamma);
+  const double reach = (1 + 1e-6) * Gmax *
+                       (0.5 * (diameter1 + diameter2) + nu1.nrm() + nu2.nrm());
+
+  const double a = vij.nrm2();
+  const double b = 2 * (rij | vij);
+  const double c = rij.nrm2() - reach * reach;
+
+  if (a == 0) {
+    if (c > 0)
+      return std::pair<double, double>(HUGE_VAL, -HUGE_VAL);
+    return std::pair<double, double>(t_min, t_max);
+  }
+
+  const double discriminant = b * b - 4 * a * c;
+  if (discriminant < 0)
+    return std::pair<double, double>(HUGE_VAL, -HUGE_VAL);
+
+  // The numerically stable form of the quadratic roots
+  const double q = -0.5 * (b + std::copysign(std::sqrt(discriminant), b));
+  double t1 = q / a, t2 = (q != 0) ? c / q : t1;
+  if (t1 > t2)
+    std::swap(t1, t2);
+
+  return std::pair<double, double>(std::max(t_min, t1), std::min(t_max, t2));
+}
 } // namespace intersection
 } // namespace magnet
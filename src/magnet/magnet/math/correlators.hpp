@@ -17,6 +17,7 @@
 
 #pragma once
 #include <boost/circular_buffer.hpp>
+#include <cmath>
 #include <magnet/exception.hpp>
 #include <magnet/math/vector.hpp>
 #include <tuple>
@@ -277,46 +278,88 @@ protected:
   double _current_time;
 };
 
-/*! \brief An extension of the TimeCorrelator class allowing full
-    resolution of the correlation functions during a simulation.
+/*! \brief A multiple-tau correlator, resolving the correlation
+    functions over all time scales during a simulation.
 
 The main problem of collecting Correlators is that you need to
-pick a fixed sample_time and correlator length. You can't
-allow your correlator length to be too large as it would
-consume memory and make performing a correlation pass() too
-slow. You also cannot use large/small sample_times as you want
-to capture all relaxation times to ensure you are reaching the
-hydrodynamic limit.
-
-This class dynamically adds more correlators at exponentially
-growing sample_times to ensure that all time scales are
-monitored without a great computational or memory overhead.
+pick a fixed sample_time and correlator length. You can't allow
+your correlator length to be too large as it would consume memory
+and make performing a correlation pass() too slow. You also cannot
+use large/small sample_times as you want to capture all relaxation
+times to ensure you are reaching the hydrodynamic limit.
+
+This class keeps a hierarchy of Correlator levels, where the
+sample time of each level is scaling times longer than the level
+below it. Only the finest level integrates the free streaming and
+impulsive contributions; each completed sample is pushed to its
+level and summed into the pending sample of the next level, which
+is pushed once scaling samples have been collected. As the \f$W\f$
+values are integrals, the coarse samples are exact and every level
+sees the whole history of the run.
+
+The per-event cost is therefore independent of the number of
+levels: impulses and free streaming values are added to a single
+pair of running integrals, and the correlators are only updated at
+sample boundaries.
  */
-template <class T> class LogarithmicTimeCorrelator {
-  typedef TimeCorrelator<T> Correlator;
-  typedef std::vector<Correlator> Container;
+template <class T> class MultiTauTimeCorrelator {
+  //! \brief The integrated contributions of one sample.
+  struct Sample {
+    NVector<T, 2> continuous;
+    NVector<T, 2> impulse;
+
+    Sample &operator+=(const Sample &o) {
+      continuous += o.continuous;
+      impulse += o.impulse;
+      return *this;
+    }
+  };
+
+  //! \brief A level of the hierarchy of correlators.
+  struct Level {
+    Level(size_t length, bool removeAverage)
+        : cc(length, removeAverage), ci(length, removeAverage),
+          ic(length, removeAverage), ii(length, removeAverage),
+          pending(), pendingCount(0) {}
+
+    Correlator<T> cc;
+    Correlator<T> ci;
+    Correlator<T> ic;
+    Correlator<T> ii;
+    //! \brief The sum of the samples of the level below.
+    Sample pending;
+    size_t pendingCount;
+  };
 
 public:
+  MultiTauTimeCorrelator()
+      : _removeAverage(false), _sample_time(1), _length(1), _scaling(2) {
+    clear();
+  }
+
   bool _removeAverage;
 
-  double getSampleTime() const { return _sample_time; }
+  //! \brief The sample time of the finest level being integrated.
+  double getSampleTime() const {
+    return _sample_time * std::pow(double(_scaling), double(_lowest));
+  }
 
-  /*! \brief Resets the TimeCorrelator before data collection.
+  /*! \brief Resets the correlator before data collection.
 
-\param sample_time See \ref TimeCorrelator for this parameter.
+\param sample_time The sample time of the finest level.
 
-\param length See \ref Correlator for this parameter.
+\param length The number of samples each level correlates over.
 
-\param scaling This parameter controls how exponentially fast
-the correlators grow. By default, the correlators double in
-sample_time whenever a new one is added.
+\param scaling The ratio of the sample times of successive levels.
    */
   void resize(double sample_time, size_t length, size_t scaling = 2,
               bool removeAverage = false) {
-    if ((sample_time <= 0) || (length == 0))
-      M_throw() << "LogarithmicTimeCorrelator requires a positive, non-zero "
-                   "sample time and a non-zero length, sample_time="
-                << sample_time << ", length=" << length;
+    if ((sample_time <= 0) || (length == 0) || (scaling < 2))
+      M_throw() << "MultiTauTimeCorrelator requires a positive, non-zero "
+                   "sample time, a non-zero length, and a scaling of at "
+                   "least 2, sample_time="
+                << sample_time << ", length=" << length
+                << ", scaling=" << scaling;
 
     _removeAverage = removeAverage;
     _sample_time = sample_time;
@@ -327,11 +370,11 @@ sample_time whenever a new one is added.
 
   void clear() {
     _current_time = 0;
-    _freestream_values = _freestream_sum = _impulse_sum = std::pair<T, T>();
+    _freestream_values = NVector<T, 2>({T(), T()});
+    _current = Sample();
     _impulse_sq_sum = T();
-    _impulse_counter = 0;
-    _sample_time /= (1 << _correlators.size());
-    _correlators.clear();
+    _lowest = 0;
+    _levels.clear();
   }
 
   /*! \brief See \ref TimeCorrelator::addImpulse(). */
@@ -339,75 +382,44 @@ sample_time whenever a new one is added.
 
   /*! \brief See \ref TimeCorrelator::addImpulse(). */
   void addImpulse(const T &val1, const T &val2) {
-    _impulse_sum.first += val1;
-    _impulse_sum.second += val2;
-
-    for (Correlator &correlator : _correlators)
-      correlator.addImpulse(val1, val2);
-
+    _current.impulse += NVector<T, 2>({val1, val2});
     _impulse_sq_sum += elementwiseMultiply(val1, val2);
-    _impulse_counter++;
   }
 
-  const T &getFreeStreamValue() const { return _freestream_values.first; }
-
-  const std::pair<T, T> &getFreeStreamValues() const {
-    return _freestream_values;
-  }
+  const T &getFreeStreamValue() const { return _freestream_values[0]; }
 
   /*! \brief See \ref TimeCorrelator::setFreeStreamValue(). */
   void setFreeStreamValue(const T &val) { setFreeStreamValue(val, val); }
 
   /*! \brief See \ref TimeCorrelator::setFreeStreamValue(). */
   void setFreeStreamValue(const T &val1, const T &val2) {
-    _freestream_values = std::pair<T, T>(val1, val2);
-
-    for (Correlator &correlator : _correlators)
-      correlator.setFreeStreamValue(val1, val2);
+    _freestream_values = NVector<T, 2>({val1, val2});
   }
 
-  /*! \brief See \ref TimeCorrelator::freeStream(). */
-  void freeStream(const double dt) {
-    // Check if we need to add a new correlators as we've accessed
-    // longer time scales
-    while ((_current_time + dt) >= _sample_time) {
-      // Add a new correlator
-      _correlators.push_back(Correlator(_sample_time, _length, _removeAverage));
-      _sample_time *= _scaling;
-
-      // Pretend the correlator has actually been here all along, gathering
-      // impulse data
-      Correlator &new_correlator = _correlators.back();
-      new_correlator.addImpulse(_impulse_sum.first, _impulse_sum.second);
-
-      // Also fake a freestream integration, it is fine to fake
-      // this as the correlators cant resolve smaller than a
-      //_sample_time.
-      new_correlator.setFreeStreamValue(_freestream_sum.first / _current_time,
-                                        _freestream_sum.second / _current_time);
-      new_correlator.freeStream(_current_time);
-
-      // Set the correct free streaming value
-      new_correlator.setFreeStreamValue(_freestream_values.first,
-                                        _freestream_values.second);
-    }
+  /*! \brief See \ref TimeCorrelator::freeStream().
 
-    // Free stream the correlators
-    for (auto correlator_ptr = _correlators.begin();
-         correlator_ptr != _correlators.end(); ++correlator_ptr) {
-      const size_t loopcount = correlator_ptr->freeStream(dt);
-
-      // Check that no correlator is doing too much work per
-      // freestream and needs to be discarded (e.g. the system
-      // mean free time is increasing, causing the correlators to
-      // bottleneck the calculations).
-      if (loopcount > 5)
-        correlator_ptr = _correlators.erase(correlator_ptr);
+    If a single call completes many samples of the finest level
+    (e.g., the mean free time is increasing), that level is no
+    longer resolved and integration moves to the next level up.
+   */
+  void freeStream(double dt) {
+    size_t loops(0);
+    double sample_time = getSampleTime();
+    while ((_current_time + dt) >= sample_time) {
+      const double deltat = sample_time - _current_time;
+      _current.continuous += _freestream_values * deltat;
+      push(_lowest, _current);
+      _current = Sample();
+      _current_time = 0;
+      dt -= deltat;
+      ++loops;
     }
 
-    _freestream_sum.first += _freestream_values.first * dt;
-    _freestream_sum.second += _freestream_values.second * dt;
+    _current.continuous += _freestream_values * dt;
     _current_time += dt;
+
+    if (loops > 5)
+      coarsen();
   }
 
   /*! \brief The returned data type for the
@@ -421,36 +433,22 @@ sample_time whenever a new one is added.
     T value;
   };
 
-  /*! \brief A method to calculate and combine the average
-      correlators from all of the contained generated Correlator
-      classes.
+  /*! \brief Combines the correlators of all levels.
 
-      The first correlator (one with the smallest _sample_time) is
-      outputted in its entirety, followed by the non-overlapping
-      parts of every other correlator.
+      The first level is outputted in its entirety, followed by the
+      parts of every other level which are not resolved by the
+      level below.
    */
   std::vector<Data> getAveragedCorrelator(bool i1, bool i2) {
     std::vector<Data> avg_correlator;
-
-    if (!_correlators.empty()) {
-      {
-        std::vector<T> result =
-            _correlators.front().getAveragedCorrelator(i1, i2);
-
-        for (size_t i(0); i < result.size(); ++i)
-          avg_correlator.push_back(
-              Data(_correlators.front().getSampleTime() * (i + 1),
-                   _correlators.front().getSampleCount(i), result[i]));
-      }
-
-      // Now copy the rest of the correlators
-      for (size_t i(1); i < _correlators.size(); ++i) {
-        std::vector<T> result = _correlators[i].getAveragedCorrelator(i1, i2);
-        for (size_t j(_length / _scaling); j < result.size(); ++j)
-          avg_correlator.push_back(
-              Data(_correlators[i].getSampleTime() * (j + 1),
-                   _correlators[i].getSampleCount(j), result[j]));
-      }
+    double level_time = _sample_time;
+    for (size_t l(0); l < _levels.size(); ++l, level_time *= _scaling) {
+      Correlator<T> &corr = i1 ? (i2 ? _levels[l].ii : _levels[l].ic)
+                               : (i2 ? _levels[l].ci : _levels[l].cc);
+      std::vector<T> result = corr.getAveragedCorrelator();
+      for (size_t j(l ? _length / _scaling : 0); j < result.size(); ++j)
+        avg_correlator.push_back(
+            Data(level_time * (j + 1), corr.getSampleCount(j), result[j]));
     }
     return avg_correlator;
   }
@@ -458,16 +456,56 @@ sample_time whenever a new one is added.
   T getAvgImpulseSqSum() const { return _impulse_sq_sum; }
 
 protected:
+  //! \brief Adds a completed sample to a level.
+  void push(size_t level, const Sample &sample) {
+    if (level == _levels.size())
+      _levels.push_back(Level(_length, _removeAverage));
+
+    Level &l = _levels[level];
+    l.cc.push(sample.continuous[0], sample.continuous[1]);
+    l.ci.push(sample.continuous[0], sample.impulse[1]);
+    l.ic.push(sample.impulse[0], sample.continuous[1]);
+    l.ii.push(sample.impulse[0], sample.impulse[1]);
+
+    // Levels beyond the end of the correlator of this level are only
+    // created when they are needed
+    if (level + 1 == _levels.size())
+      _levels.push_back(Level(_length, _removeAverage));
+
+    Level &next = _levels[level + 1];
+    next.pending += sample;
+    if (++next.pendingCount == _scaling) {
+      const Sample coarse = next.pending;
+      next.pending = Sample();
+      next.pendingCount = 0;
+      push(level + 1, coarse);
+    }
+  }
+
+  /*! \brief Moves the integration to the next level up, folding the
+      partial sample into that level's pending sample.
+   */
+  void coarsen() {
+    if (_lowest + 1 >= _levels.size())
+      return;
+    Level &next = _levels[_lowest + 1];
+    _current += next.pending;
+    _current_time += next.pendingCount * getSampleTime();
+    next.pending = Sample();
+    next.pendingCount = 0;
+    ++_lowest;
+  }
+
   double _sample_time;
   double _current_time;
   size_t _length;
   size_t _scaling;
-  std::pair<T, T> _freestream_values;
-  std::pair<T, T> _impulse_sum;
-  std::pair<T, T> _freestream_sum;
+  //! \brief The finest level which is still being integrated.
+  size_t _lowest;
+  NVector<T, 2> _freestream_values;
+  Sample _current;
   T _impulse_sq_sum;
-  size_t _impulse_counter;
-  Container _correlators;
+  std::vector<Level> _levels;
 };
 } // namespace math
 } // namespace magnet
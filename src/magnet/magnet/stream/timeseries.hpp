@@ -0,0 +1,244 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <magnet/exception.hpp>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace magnet {
+namespace stream {
+/*! \brief The identifier at the start of every time-series file. */
+static const char timeSeriesMagic[8] = {'M', 'A', 'G', 'T',
+                                        'S', 'E', 'R', '1'};
+
+/*! \brief An append-only, binary, columnar time-series file
+    written by a background thread.
+
+  The file starts with the 8 byte timeSeriesMagic, a uint32_t count
+  of the columns, and then the name of each column as a uint32_t
+  length followed by its characters. The rest of the file is the
+  rows, each stored as one native double per column. The row count
+  is not stored, so a file may be read while it is still being
+  written, and a run which is killed leaves a valid file (a partial
+  final row must be ignored by a reader).
+
+  Rows are collected into a buffer which is handed to a background
+  thread for writing once full, so the caller does not wait on the
+  disk unless the writer falls a whole buffer behind.
+ */
+class TimeSeriesWriter {
+public:
+  /*! \brief Open (and truncate) a time-series file.
+
+    \param filename The file to write.
+    \param columns The names of the columns of each row.
+    \param bufferRows The number of rows buffered before they are
+    handed to the writer thread.
+   */
+  TimeSeriesWriter(const std::string &filename,
+                   const std::vector<std::string> &columns,
+                   const size_t bufferRows = 4096)
+      : _file(filename, std::ios::binary | std::ios::trunc), _columns(columns),
+        _bufferSize(std::max<size_t>(1, bufferRows) * columns.size()),
+        _rows(0), _pending(false), _stop(false) {
+    if (!_file)
+      M_throw() << "Could not open \"" << filename
+                << "\" to write a time series";
+
+    if (columns.empty())
+      M_throw() << "A time series needs at least one column";
+
+    _file.write(timeSeriesMagic, sizeof(timeSeriesMagic));
+    writeU32(columns.size());
+    for (const std::string &name : columns) {
+      writeU32(name.size());
+      _file.write(name.data(), name.size());
+    }
+    _file.flush();
+
+    _buffer.reserve(_bufferSize);
+    _writeBuffer.reserve(_bufferSize);
+    _thread = std::thread(&TimeSeriesWriter::writerLoop, this);
+  }
+
+  /*! \brief Writes any buffered rows and closes the file. */
+  ~TimeSeriesWriter() {
+    try {
+      flush();
+    } catch (...) {
+    }
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _condition.notify_all();
+    _thread.join();
+  }
+
+  TimeSeriesWriter(const TimeSeriesWriter &) = delete;
+  TimeSeriesWriter &operator=(const TimeSeriesWriter &) = delete;
+
+  /*! \brief Append a row, which must have one value per column. */
+  void append(const std::vector<double> &row) {
+    if (row.size() != _columns.size())
+      M_throw() << "Time series row has " << row.size()
+                << " values, but there are " << _columns.size()
+                << " columns";
+    _buffer.insert(_buffer.end(), row.begin(), row.end());
+    ++_rows;
+    if (_buffer.size() >= _bufferSize)
+      handOver();
+  }
+
+  /*! \brief Write all rows appended so far to the file, waiting for
+      the writer thread to finish.
+   */
+  void flush() {
+    if (!_buffer.empty())
+      handOver();
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this] { return !_pending; });
+    if (!_error.empty())
+      M_throw() << _error;
+  }
+
+  //! \brief The names of the columns.
+  const std::vector<std::string> &columns() const { return _columns; }
+
+  //! \brief The number of rows appended so far.
+  size_t rows() const { return _rows; }
+
+private:
+  void writeU32(const size_t val) {
+    const uint32_t v = val;
+    _file.write(reinterpret_cast<const char *>(&v), sizeof(v));
+  }
+
+  //! \brief Pass the filled buffer to the writer thread.
+  void handOver() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this] { return !_pending; });
+    if (!_error.empty())
+      M_throw() << _error;
+    _writeBuffer.swap(_buffer);
+    _buffer.clear();
+    _pending = true;
+    lock.unlock();
+    _condition.notify_all();
+  }
+
+  void writerLoop() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+      _condition.wait(lock, [this] { return _pending || _stop; });
+      if (!_pending)
+        return;
+
+      // The buffer is owned by this thread until _pending is cleared
+      lock.unlock();
+      _file.write(reinterpret_cast<const char *>(_writeBuffer.data()),
+                  _writeBuffer.size() * sizeof(double));
+      _file.flush();
+      lock.lock();
+
+      if (!_file)
+        _error = "Failed while writing a time series";
+      _pending = false;
+      _condition.notify_all();
+    }
+  }
+
+  std::ofstream _file;
+  std::vector<std::string> _columns;
+  const size_t _bufferSize;
+  size_t _rows;
+
+  //! \brief The rows being filled by append().
+  std::vector<double> _buffer;
+  //! \brief The rows being written by the writer thread.
+  std::vector<double> _writeBuffer;
+
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  bool _pending;
+  bool _stop;
+  std::string _error;
+  std::thread _thread;
+};
+
+/*! \brief Reads a file written by a TimeSeriesWriter.
+
+  Any partial row at the end of the file (e.g., from a run which is
+  still writing) is ignored.
+ */
+class TimeSeriesReader {
+public:
+  TimeSeriesReader(const std::string &filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+      M_throw() << "Could not open the time series \"" << filename << "\"";
+
+    char magic[sizeof(timeSeriesMagic)];
+    file.read(magic, sizeof(magic));
+    if (!file || std::memcmp(magic, timeSeriesMagic, sizeof(magic)))
+      M_throw() << "\"" << filename << "\" is not a time series file";
+
+    const uint32_t ncolumns = readU32(file);
+    for (uint32_t i(0); i < ncolumns; ++i) {
+      std::string name(readU32(file), ' ');
+      file.read(&name[0], name.size());
+      _columns.push_back(name);
+    }
+    if (!file)
+      M_throw() << "Truncated header in the time series \"" << filename
+                << "\"";
+
+    std::vector<char> data((std::istreambuf_iterator<char>(file)),
+                           std::istreambuf_iterator<char>());
+    const size_t rowBytes = ncolumns * sizeof(double);
+    _data.resize((data.size() / rowBytes) * ncolumns);
+    std::memcpy(_data.data(), data.data(), _data.size() * sizeof(double));
+  }
+
+  const std::vector<std::string> &columns() const { return _columns; }
+
+  size_t rows() const { return _data.size() / _columns.size(); }
+
+  //! \brief Return a value by its row and column index.
+  double operator()(const size_t row, const size_t column) const {
+    return _data[row * _columns.size() + column];
+  }
+
+private:
+  static uint32_t readU32(std::istream &is) {
+    uint32_t val(0);
+    is.read(reinterpret_cast<char *>(&val), sizeof(val));
+    return val;
+  }
+
+  std::vector<std::string> _columns;
+  std::vector<double> _data;
+};
+} // namespace stream
+} // namespace magnet
@@ -0,0 +1,105 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <cstdint>
+#include <magnet/exception.hpp>
+#include <string>
+#include <vector>
+
+namespace magnet {
+namespace string {
+/*! \brief Encodes a block of binary data as a base64 string
+    (RFC 4648, with padding).
+
+  This allows binary data to be embedded in the character data of
+  XML files.
+ */
+inline std::string base64_encode(const void *data, const size_t size) {
+  static const char table[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  const uint8_t *in = static_cast<const uint8_t *>(data);
+
+  std::string retval;
+  retval.reserve(((size + 2) / 3) * 4);
+
+  size_t i = 0;
+  for (; i + 2 < size; i += 3) {
+    const uint32_t v = (uint32_t(in[i]) << 16) | (uint32_t(in[i + 1]) << 8) |
+                       uint32_t(in[i + 2]);
+    retval.push_back(table[(v >> 18) & 0x3F]);
+    retval.push_back(table[(v >> 12) & 0x3F]);
+    retval.push_back(table[(v >> 6) & 0x3F]);
+    retval.push_back(table[v & 0x3F]);
+  }
+
+  if (i < size) {
+    uint32_t v = uint32_t(in[i]) << 16;
+    if (i + 1 < size)
+      v |= uint32_t(in[i + 1]) << 8;
+    retval.push_back(table[(v >> 18) & 0x3F]);
+    retval.push_back(table[(v >> 12) & 0x3F]);
+    retval.push_back((i + 1 < size) ? table[(v >> 6) & 0x3F] : '=');
+    retval.push_back('=');
+  }
+
+  return retval;
+}
+
+/*! \brief Decodes a base64 string into binary data.
+
+  Whitespace (e.g., line breaks inserted by XML formatting) is
+  ignored, any other character outside of the base64 alphabet
+  causes an exception.
+ */
+inline std::vector<uint8_t> base64_decode(const std::string &str) {
+  std::vector<uint8_t> retval;
+  retval.reserve((str.size() / 4) * 3);
+
+  uint32_t accum = 0;
+  size_t bits = 0;
+  for (const char c : str) {
+    uint32_t val;
+    if (c >= 'A' && c <= 'Z')
+      val = c - 'A';
+    else if (c >= 'a' && c <= 'z')
+      val = c - 'a' + 26;
+    else if (c >= '0' && c <= '9')
+      val = c - '0' + 52;
+    else if (c == '+')
+      val = 62;
+    else if (c == '/')
+      val = 63;
+    else if (c == '=')
+      break;
+    else if ((c == ' ') || (c == '\n') || (c == '\r') || (c == '\t'))
+      continue;
+    else
+      M_throw() << "Invalid character '" << c << "' in base64 data";
+
+    accum = (accum << 6) | val;
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      retval.push_back(uint8_t((accum >> bits) & 0xFF));
+    }
+  }
+
+  return retval;
+}
+} // namespace string
+} // namespace magnet
@@ -0,0 +1,82 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <algorithm>
+#include <exception>
+#include <magnet/thread/threadgroup.hpp>
+#include <mutex>
+
+namespace magnet {
+namespace thread {
+/*! \brief Splits the index range [begin, end) into contiguous
+    blocks and processes each block on its own thread.
+
+  The passed function is called as \c func(block, blockBegin,
+  blockEnd), where \c block is the index of the block in
+  [0,nblocks). This allows callers to keep per-block scratch
+  storage which they then reduce serially once this function
+  returns. The blocks are ordered, so a reduction over the block
+  index in ascending order visits the range in its original order.
+
+  If one thread (or fewer) is requested, or the range is too small
+  to be worth splitting, the function is called once inline on the
+  calling thread. The first exception thrown by any block is
+  rethrown on the calling thread once all blocks have finished.
+
+  \param nthreads The maximum number of blocks to create.
+  \return The number of blocks actually used.
+*/
+template <class Function>
+inline size_t parallel_for(size_t begin, size_t end, size_t nthreads,
+                           Function func) {
+  const size_t N = (end > begin) ? end - begin : 0;
+  const size_t nblocks = std::max<size_t>(1, std::min(nthreads, N));
+
+  if (nblocks == 1) {
+    func(size_t(0), begin, end);
+    return 1;
+  }
+
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  {
+    ThreadGroup threads;
+    for (size_t block = 0; block < nblocks; ++block) {
+      const size_t blockBegin = begin + (N * block) / nblocks;
+      const size_t blockEnd = begin + (N * (block + 1)) / nblocks;
+      threads.create_thread([&, block, blockBegin, blockEnd]() {
+        try {
+          func(block, blockBegin, blockEnd);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (!error)
+            error = std::current_exception();
+        }
+      });
+    }
+    threads.join_all();
+  }
+
+  if (error)
+    std::rethrow_exception(error);
+
+  return nblocks;
+}
+} // namespace thread
+} // namespace magnet
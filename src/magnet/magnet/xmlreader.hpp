@@ -17,14 +17,17 @@
 
 #pragma once
 
+#include <algorithm>
 #include <boost/lexical_cast.hpp>
 #include <magnet/exception.hpp>
 #include <rapidXML/rapidxml.hpp>
 #ifdef DYNAMO_bzip2_support
 #include <bzlib.h>
 #endif
+#include <charconv>
 #include <fstream>
 #include <iostream>
+#include <type_traits>
 #include <vector>
 
 namespace magnet {
@@ -70,6 +73,28 @@ inline std::string getPath(rapidxml::xml_node<> *_node) {
   }
   return os.str();
 }
+
+/*! \brief Types which Attribute::as() parses with std::from_chars
+    instead of boost::lexical_cast.
+ */
+template <class T>
+struct is_from_chars_type
+    : std::integral_constant<bool, (std::is_integral<T>::value &&
+                                    !std::is_same<T, bool>::value) ||
+                                       std::is_floating_point<T>::value> {};
+
+/*! \brief Parses a number from the whole of [begin, end) without
+    allocating, returning false if the text is not a plain number.
+
+  Anything std::from_chars does not accept (e.g., a leading '+' or
+  surrounding whitespace) returns false, so the caller can fall back
+  to the slower but more lenient boost::lexical_cast.
+ */
+template <class T>
+inline bool fromChars(const char *begin, const char *end, T &val) {
+  const std::from_chars_result res = std::from_chars(begin, end, val);
+  return (res.ec == std::errc()) && (res.ptr == end);
+}
 } // namespace detail
 
 /*! \brief Represents an Attribute of an XML Document.
@@ -78,6 +103,14 @@ class Attribute {
 public:
   //! \brief Converts the attributes value to a type.
   template <class T> inline T as() const {
+    if constexpr (detail::is_from_chars_type<T>::value) {
+      T val;
+      if (valid() && detail::fromChars(_attr->value(),
+                                       _attr->value() + _attr->value_size(),
+                                       val))
+        return val;
+    }
+
     try {
       return boost::lexical_cast<T>(getValue());
     } catch (boost::bad_lexical_cast &) {
@@ -335,6 +368,13 @@ public:
       if (!f) {
         M_throw() << "Failed to open " << filename << " for reading.";
       }
+      // Reserve a guess of the decompressed size, as configurations
+      // typically compress by a factor of four or more
+      const size_t blockSize = 1 << 20;
+      fseek(f, 0, SEEK_END);
+      _data.reserve(4 * size_t(std::max(0L, ftell(f))) + blockSize);
+      fseek(f, 0, SEEK_SET);
+
       int bzerror;
       BZFILE *b = BZ2_bzReadOpen(&bzerror, f, 0, 0, NULL, 0);
       if (bzerror != BZ_OK) {
@@ -343,13 +383,17 @@ public:
         M_throw() << "Failed beginning decompression of " << filename
                   << " for reading.";
       }
-      char buf[1024 * 10];
+      // Decompress straight into the document in large blocks
+      size_t used = 0;
       bzerror = BZ_OK;
       while (bzerror == BZ_OK) {
-        size_t nBuf = BZ2_bzRead(&bzerror, b, buf, sizeof(buf));
+        if (_data.size() < used + blockSize)
+          _data.resize(std::max(used + blockSize, 2 * _data.size()));
+        int nBuf = BZ2_bzRead(&bzerror, b, &_data[used], blockSize);
         if ((bzerror == BZ_OK) || (bzerror == BZ_STREAM_END))
-          _data.append(buf, nBuf);
+          used += nBuf;
       }
+      _data.resize(used);
 
       if (bzerror != BZ_STREAM_END) {
         BZ2_bzReadClose(&bzerror, b);
@@ -377,6 +421,16 @@ public:
     parseData();
   }
 
+  /*! \brief Parse XML text which is already held in memory.
+
+    \param data The XML text, which is copied into the Document.
+    \param size The length of the XML text.
+   */
+  Document(const char *data, size_t size) {
+    _data.assign(data, size);
+    parseData();
+  }
+
   /*! \brief Return the first root node with a certain name in the
     Document.
 
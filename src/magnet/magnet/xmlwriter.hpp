@@ -18,20 +18,157 @@
 */
 
 #pragma once
+#include <algorithm>
+#include <charconv>
 #include <fstream>
+#include <limits>
 #include <magnet/exception.hpp>
 #include <memory>
 #include <sstream>
 #include <stack>
+#include <streambuf>
 #include <string>
+#include <vector>
 #ifdef DYNAMO_bzip2_support
 #include <bzlib.h>
-#include <vector>
 #endif
 
 namespace magnet {
 namespace xml {
+namespace detail {
+/*! \brief A destination for the output of a streaming XmlStream.
+
+  Errors are recorded rather than thrown, as they occur inside the
+  std::streambuf machinery, and are reported by XmlStream::close().
+ */
+class XmlSink {
+public:
+  virtual ~XmlSink() {}
+  virtual bool write(const char *data, size_t len) = 0;
+  virtual bool close() = 0;
+};
+
+//! \brief An XmlSink writing to an uncompressed file.
+class XmlFileSink : public XmlSink {
+public:
+  XmlFileSink(const std::string &filename)
+      : _of(filename, std::ios::binary) {
+    if (!_of)
+      M_throw() << "Failed to open " << filename << " for writing.";
+  }
+
+  bool write(const char *data, size_t len) {
+    _of.write(data, len);
+    return bool(_of);
+  }
+
+  bool close() {
+    _of.close();
+    return bool(_of);
+  }
+
+private:
+  std::ofstream _of;
+};
+
+#ifdef DYNAMO_bzip2_support
+//! \brief An XmlSink feeding the output straight into a bzip2 file.
+class XmlBZ2Sink : public XmlSink {
+public:
+  XmlBZ2Sink(const std::string &filename)
+      : _f(BZ2_bzopen(filename.c_str(), "w")) {
+    if (!_f)
+      M_throw() << "Failed to open compressed file " << filename
+                << " for writing.";
+  }
+
+  ~XmlBZ2Sink() { close(); }
+
+  bool write(const char *data, size_t len) {
+    return _f && (BZ2_bzwrite(_f, const_cast<char *>(data), len) == int(len));
+  }
+
+  bool close() {
+    if (_f)
+      BZ2_bzclose(_f);
+    _f = nullptr;
+    return true;
+  }
+
+private:
+  BZFILE *_f;
+};
+#endif
+
+/*! \brief Opens the XmlSink for a filename, compressing the output
+  if the filename ends in ".bz2".
+ */
+inline std::unique_ptr<XmlSink> openXmlSink(const std::string &filename) {
+  if ((filename.size() >= 4) &&
+      (std::string(filename.end() - 4, filename.end()) == ".bz2")) {
+#ifdef DYNAMO_bzip2_support
+    return std::unique_ptr<XmlSink>(new XmlBZ2Sink(filename));
+#else
+    M_throw() << "bz2 compressed file support was not built in! (only "
+                 "available on linux)";
+#endif
+  }
+  return std::unique_ptr<XmlSink>(new XmlFileSink(filename));
+}
+
+/*! \brief A std::streambuf which hands its contents to an XmlSink
+  in fixed size chunks.
+ */
+class XmlSinkBuffer : public std::streambuf {
+public:
+  XmlSinkBuffer(std::unique_ptr<XmlSink> sink, size_t chunkSize)
+      : _sink(std::move(sink)), _buffer(std::max<size_t>(chunkSize, 1)),
+        _failed(false) {
+    setp(_buffer.data(), _buffer.data() + _buffer.size());
+  }
+
+  //! \brief Flushes the remaining output and closes the sink.
+  bool close() {
+    flushChunk();
+    return _sink->close() && !_failed;
+  }
+
+protected:
+  int_type overflow(int_type ch) {
+    flushChunk();
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+    }
+    return traits_type::not_eof(ch);
+  }
+
+  int sync() {
+    flushChunk();
+    return _failed ? -1 : 0;
+  }
+
+private:
+  void flushChunk() {
+    const size_t len = pptr() - pbase();
+    if (len && !_failed)
+      _failed = !_sink->write(pbase(), len);
+    setp(_buffer.data(), _buffer.data() + _buffer.size());
+  }
+
+  std::unique_ptr<XmlSink> _sink;
+  std::vector<char> _buffer;
+  bool _failed;
+};
+} // namespace detail
+
 /*! \brief A class which behaves like an output stream for XML output.
+
+  By default the XML is collected in memory, and may be retrieved
+  using str() or written using write_file(). If a filename is passed
+  to the constructor, the XML is instead streamed to the file (bzip2
+  compressed if the name ends in ".bz2") in chunks of a fixed size,
+  so the memory used is independent of the size of the document.
  */
 class XmlStream {
 public:
@@ -47,44 +184,76 @@ public:
   };
 
   inline XmlStream()
-      : state(stateNone), prologWritten(false), FormatXML(false) {}
+      : state(stateNone), s(_memory.rdbuf()), prologWritten(false),
+        FormatXML(false) {}
+
+  /*! \brief Constructs an XmlStream which streams its output
+    straight to a file.
+
+    \param filename The file to write, compressed with bzip2 if the
+    name ends in ".bz2".
+    \param chunkSize The number of bytes buffered before being handed
+    to the file/compressor.
+   */
+  inline XmlStream(const std::string &filename, size_t chunkSize = 1 << 20)
+      : state(stateNone),
+        _sinkBuffer(new detail::XmlSinkBuffer(detail::openXmlSink(filename),
+                                              chunkSize)),
+        s(_sinkBuffer.get()), prologWritten(false), FormatXML(false),
+        _filename(filename) {}
 
   inline ~XmlStream() {
+    try {
+      while (tags.size())
+        endTag(tags.top());
+      if (_sinkBuffer)
+        _sinkBuffer->close();
+    } catch (...) {
+    }
+  }
+
+  /*! \brief Closes any open tags and, for a streaming XmlStream,
+    flushes the output and closes the file.
+
+    Throws if any part of the output could not be written.
+   */
+  inline void close() {
     while (tags.size())
       endTag(tags.top());
+    if (!_sinkBuffer)
+      return;
+    s.flush();
+    const bool ok = _sinkBuffer->close() && s;
+    _sinkBuffer.reset();
+    s.rdbuf(nullptr);
+    if (!ok)
+      M_throw() << "Failed during writing of contents of " << _filename
+                << ".";
   }
 
   inline void write_file(std::string filename) {
-    if (std::string(filename.end() - 4, filename.end()) == ".bz2") {
-#ifdef DYNAMO_bzip2_support
-      BZFILE *f = BZ2_bzopen(filename.c_str(), "w");
-      if (!f)
-        M_throw() << "Failed to open compressed file " << filename
-                  << " for writing.";
-
-      std::vector<char> buf((std::istreambuf_iterator<char>(s)),
-                            std::istreambuf_iterator<char>());
-
-      int nWritten = BZ2_bzwrite(f, buf.data(), buf.size());
-      if (nWritten <= 0)
-        M_throw() << "Failed to while writing contents of compressed file "
-                  << filename << ".";
-      BZ2_bzclose(f);
-#else
-      M_throw() << "bz2 compressed file support was not built in! (only "
-                   "available on linux)";
-#endif
-    } else {
-      std::ofstream of(filename);
-      if (!of)
-        M_throw() << "Failed to open " << filename << " for writing.";
-      of << s.rdbuf();
-      if (!of)
-        M_throw() << "Failed during writing of contents of " << filename << ".";
-    }
+    if (_sinkBuffer)
+      M_throw() << "Cannot write_file a streaming XmlStream (it is already "
+                   "writing to "
+                << _filename << ")";
+    std::unique_ptr<detail::XmlSink> sink = detail::openXmlSink(filename);
+    const std::string &data = _memory.str();
+    if (!sink->write(data.data(), data.size()) || !sink->close())
+      M_throw() << "Failed during writing of contents of " << filename << ".";
   }
 
-  void clear() { s.str(""); }
+  void clear() {
+    if (_sinkBuffer)
+      M_throw() << "Cannot clear a streaming XmlStream";
+    _memory.str("");
+  }
+
+  //! \brief Returns the XML written so far.
+  std::string str() const {
+    if (_sinkBuffer)
+      M_throw() << "The XML of a streaming XmlStream is not kept";
+    return _memory.str();
+  }
 
   /*! \brief Main insertion operator which changes the state of
     the XmlStream.
@@ -135,6 +304,19 @@ public:
     return XML;
   }
 
+  /*! \brief Formats doubles using std::to_chars, which is several
+    times faster than the iostream formatting.
+
+    If the stream precision is enough to round-trip a double, the
+    shortest representation which reads back exactly is written.
+    Otherwise the output matches the iostream's default formatting at
+    the current precision.
+   */
+  friend XmlStream &operator<<(XmlStream &XML, const double value) {
+    XML.writeDouble(value);
+    return XML;
+  }
+
   /*! \brief Specialisation for pointers. */
   template <class T>
   friend XmlStream &operator<<(XmlStream &XML,
@@ -164,10 +346,35 @@ private:
 
   tag_stack_type tags;
   state_type state;
-  std::stringstream s;
+  //! \brief The buffer of an in-memory XmlStream.
+  std::stringstream _memory;
+  //! \brief The buffer of a streaming XmlStream.
+  std::unique_ptr<detail::XmlSinkBuffer> _sinkBuffer;
+  std::ostream s;
   bool prologWritten;
   std::ostringstream tagName;
   bool FormatXML;
+  std::string _filename;
+
+  inline void writeDouble(const double value) {
+    const std::ios_base::fmtflags flags = s.flags();
+    if ((flags & (std::ios_base::floatfield | std::ios_base::showpos |
+                  std::ios_base::showpoint | std::ios_base::uppercase)) ||
+        s.width()) {
+      s << value;
+      return;
+    }
+
+    char buf[64];
+    const std::streamsize prec = s.precision();
+    std::to_chars_result res;
+    if (prec >= std::numeric_limits<double>::max_digits10)
+      res = std::to_chars(buf, buf + sizeof(buf), value);
+    else
+      res = std::to_chars(buf, buf + sizeof(buf), value,
+                          std::chars_format::general, prec ? int(prec) : 1);
+    s.write(buf, res.ptr - buf);
+  }
 
   //! \brief Closes the current tag.
   inline void closeTagStart(bool self_closed = false) {
@@ -0,0 +1,36 @@
+#define BOOST_TEST_MODULE Base64_test
+#include <boost/test/included/unit_test.hpp>
+#include <magnet/string/base64.hpp>
+#include <random>
+
+using namespace magnet::string;
+
+BOOST_AUTO_TEST_CASE(base64_known_values) {
+  // RFC 4648 test vectors
+  const std::string input = "foobar";
+  const char *expected[] = {"",         "Zg==",     "Zm8=",    "Zm9v",
+                            "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy"};
+  for (size_t i(0); i <= input.size(); ++i)
+    BOOST_CHECK_EQUAL(base64_encode(input.data(), i), expected[i]);
+}
+
+BOOST_AUTO_TEST_CASE(base64_roundtrip) {
+  std::mt19937 RNG;
+  std::uniform_int_distribution<int> byte_dist(0, 255);
+
+  for (size_t size(0); size < 100; ++size) {
+    std::vector<uint8_t> data(size);
+    for (auto &byte : data)
+      byte = byte_dist(RNG);
+
+    const std::vector<uint8_t> decoded =
+        base64_decode(base64_encode(data.data(), data.size()));
+    BOOST_CHECK(decoded == data);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(base64_whitespace) {
+  const std::vector<uint8_t> decoded = base64_decode("\n  Zm9v\n  YmFy\n");
+  BOOST_CHECK(std::string(decoded.begin(), decoded.end()) == "foobar");
+  BOOST_CHECK_THROW(base64_decode("Zm9v*"), magnet::exception);
+}
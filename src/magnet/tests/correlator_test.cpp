@@ -0,0 +1,83 @@
+#define BOOST_TEST_MODULE Correlator_test
+#include <boost/test/included/unit_test.hpp>
+#include <cmath>
+#include <magnet/math/correlators.hpp>
+#include <random>
+
+using namespace magnet::math;
+
+// Each level of the multiple-tau correlator must match a
+// TimeCorrelator sampling the same data at that level's sample time.
+BOOST_AUTO_TEST_CASE(multitau_matches_time_correlators) {
+  const double sample_time = 0.1;
+  const size_t length = 8, scaling = 2, levels = 4;
+
+  MultiTauTimeCorrelator<double> multitau;
+  multitau.resize(sample_time, length, scaling, false);
+
+  std::vector<TimeCorrelator<double>> reference;
+  for (size_t l(0); l < levels; ++l)
+    reference.push_back(TimeCorrelator<double>(
+        sample_time * std::pow(double(scaling), double(l)), length, false));
+
+  std::mt19937 RNG(12345);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  std::exponential_distribution<double> dtdist(1 / (0.3 * sample_time));
+
+  for (size_t event(0); event < 20000; ++event) {
+    const double dt = dtdist(RNG);
+    multitau.freeStream(dt);
+    for (auto &corr : reference)
+      corr.freeStream(dt);
+
+    const double imp1 = dist(RNG), imp2 = dist(RNG);
+    multitau.addImpulse(imp1, imp2);
+    for (auto &corr : reference)
+      corr.addImpulse(imp1, imp2);
+
+    const double fs1 = dist(RNG), fs2 = dist(RNG);
+    multitau.setFreeStreamValue(fs1, fs2);
+    for (auto &corr : reference)
+      corr.setFreeStreamValue(fs1, fs2);
+  }
+
+  // The sampling is fine enough that no level is dropped
+  BOOST_CHECK_CLOSE(multitau.getSampleTime(), sample_time, 1e-12);
+
+  for (bool i1 : {false, true})
+    for (bool i2 : {false, true}) {
+      const auto data = multitau.getAveragedCorrelator(i1, i2);
+      // The levels are output in order, each after the times resolved
+      // by the level below
+      size_t checked(0);
+      for (size_t l(0); l < levels; ++l) {
+        const double level_time =
+            sample_time * std::pow(double(scaling), double(l));
+        const std::vector<double> expected =
+            reference[l].getAveragedCorrelator(i1, i2);
+        BOOST_REQUIRE_EQUAL(expected.size(), length);
+        for (size_t j(l ? length / scaling : 0); j < length; ++j) {
+          BOOST_REQUIRE(checked < data.size());
+          const auto &point = data[checked++];
+          BOOST_CHECK_CLOSE(point.time, level_time * (j + 1), 1e-9);
+          BOOST_CHECK_CLOSE(point.value, expected[j], 1e-6);
+          BOOST_CHECK_EQUAL(point.sample_count,
+                            reference[l].getSampleCount(j));
+        }
+      }
+    }
+}
+
+// If the mean free time is much longer than the sample time, the
+// finest level is dropped rather than looping through empty samples
+BOOST_AUTO_TEST_CASE(multitau_coarsens) {
+  MultiTauTimeCorrelator<double> multitau;
+  multitau.resize(0.01, 8, 2, false);
+  for (size_t i(0); i < 1000; ++i) {
+    multitau.freeStream(1.0);
+    multitau.addImpulse(1.0);
+    multitau.setFreeStreamValue(0.5);
+  }
+  BOOST_CHECK(multitau.getSampleTime() > 0.1);
+  BOOST_CHECK(!multitau.getAveragedCorrelator(false, false).empty());
+}
@@ -109,3 +109,48 @@ BOOST_AUTO_TEST_CASE(OffCentreSphereGrowing_Test) {
   std::cout << "f = " << f1.eval(result1.second).front()
             << "Result1.second = " << result1.second << std::endl;
 }
+
+BOOST_AUTO_TEST_CASE(OffCentreSphereWindow_Test) {
+  RNG.seed(5489u);
+  const double diameteri = 1, diameterj = 0.5, maxdist = 3, t_max = 2;
+
+  // Searching only within the bounding window must find the same
+  // event as searching the whole interval
+  size_t pruned = 0;
+  for (size_t i(0); i < 10000; ++i) {
+    const Vector rij = random_unit_vec() * maxdist * dist01(RNG);
+    const Vector vij = random_vec();
+    const Vector angvi = random_vec(), angvj = random_vec();
+    const Vector ui = random_unit_vec() * 0.5 * dist01(RNG);
+    const Vector uj = random_unit_vec() * 0.5 * dist01(RNG);
+
+    magnet::intersection::detail::OffcentreSpheresOverlapFunction full(
+        rij, vij, angvi, angvj, ui, uj, diameteri, diameterj, maxdist, 0, 0, 0,
+        t_max);
+    // Skip initially overlapping configurations
+    if (full.eval(0).front() <= 0)
+      continue;
+    const auto expected = full.nextEvent();
+
+    const auto window = offcentre_spheres_window(rij, vij, ui, uj, diameteri,
+                                                 diameterj, 0, 0, 0, t_max);
+    if (window.first > window.second) {
+      ++pruned;
+      BOOST_CHECK(expected.second == HUGE_VAL);
+      continue;
+    }
+
+    magnet::intersection::detail::OffcentreSpheresOverlapFunction windowed(
+        rij, vij, angvi, angvj, ui, uj, diameteri, diameterj, maxdist, 0, 0,
+        window.first, window.second);
+    const auto result = windowed.nextEvent();
+    BOOST_CHECK_EQUAL(result.first, expected.first);
+    if (expected.second == HUGE_VAL)
+      BOOST_CHECK(result.second == HUGE_VAL);
+    else
+      BOOST_CHECK_CLOSE(result.second, expected.second, 1e-6);
+  }
+
+  // The random configurations should include misses
+  BOOST_CHECK(pruned > 0);
+}
@@ -0,0 +1,48 @@
+#define BOOST_TEST_MODULE TimeSeries_test
+#include <boost/test/included/unit_test.hpp>
+#include <fstream>
+#include <magnet/stream/timeseries.hpp>
+
+using namespace magnet::stream;
+
+BOOST_AUTO_TEST_CASE(timeseries_roundtrip) {
+  const std::vector<std::string> columns = {"time", "value"};
+  const size_t N = 10007;
+  {
+    // A small buffer forces many hand overs to the writer thread
+    TimeSeriesWriter writer("timeseries_test.dat", columns, 100);
+    for (size_t i(0); i < N; ++i)
+      writer.append({0.5 * i, double(i * i)});
+    BOOST_CHECK_EQUAL(writer.rows(), N);
+  }
+
+  TimeSeriesReader reader("timeseries_test.dat");
+  BOOST_REQUIRE(reader.columns() == columns);
+  BOOST_REQUIRE_EQUAL(reader.rows(), N);
+  for (size_t i(0); i < N; ++i) {
+    BOOST_CHECK_EQUAL(reader(i, 0), 0.5 * i);
+    BOOST_CHECK_EQUAL(reader(i, 1), double(i * i));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(timeseries_flush_and_partial_row) {
+  TimeSeriesWriter writer("timeseries_partial.dat", {"a", "b", "c"});
+  writer.append({1, 2, 3});
+  writer.append({4, 5, 6});
+  // A flushed file can be read while the writer is still open
+  writer.flush();
+  BOOST_CHECK_EQUAL(TimeSeriesReader("timeseries_partial.dat").rows(), 2u);
+
+  // A run killed mid-write leaves a partial row, which is ignored
+  {
+    std::ofstream file("timeseries_partial.dat",
+                       std::ios::binary | std::ios::app);
+    const double half = 7;
+    file.write(reinterpret_cast<const char *>(&half), sizeof(half));
+  }
+  TimeSeriesReader reader("timeseries_partial.dat");
+  BOOST_CHECK_EQUAL(reader.rows(), 2u);
+  BOOST_CHECK_EQUAL(reader(1, 2), 6);
+
+  BOOST_CHECK_THROW(writer.append({1, 2}), magnet::exception);
+}
@@ -0,0 +1,53 @@
+#define BOOST_TEST_MODULE XmlReader_test
+#include <boost/test/included/unit_test.hpp>
+#include <limits>
+#include <magnet/xmlreader.hpp>
+#include <string>
+
+using namespace magnet::xml;
+
+namespace {
+const std::string doc = "<Doc>"
+                        "<A v=\"0.1\"/>"
+                        "<A v=\"-1.5e-300\"/>"
+                        "<A v=\"+2.5\"/>"
+                        "<A v=\"123456789\"/>"
+                        "<A v=\"1.0x\"/>"
+                        "<A v=\"\"/>"
+                        "</Doc>";
+}
+
+BOOST_AUTO_TEST_CASE(attribute_parsing) {
+  Document XML(doc.data(), doc.size());
+  Node node = XML.getNode("Doc").findNode("A");
+  BOOST_CHECK_EQUAL(node.getAttribute("v").as<double>(), 0.1);
+  ++node;
+  BOOST_CHECK_EQUAL(node.getAttribute("v").as<double>(), -1.5e-300);
+  ++node;
+  // Not accepted by from_chars, but still parsed by the fallback
+  BOOST_CHECK_EQUAL(node.getAttribute("v").as<double>(), 2.5);
+  ++node;
+  BOOST_CHECK_EQUAL(node.getAttribute("v").as<size_t>(), 123456789u);
+  BOOST_CHECK_EQUAL(node.getAttribute("v").as<int>(), 123456789);
+  BOOST_CHECK_EQUAL(node.getAttribute("v").as<double>(), 123456789.0);
+  BOOST_CHECK_EQUAL(node.getAttribute("v").as<std::string>(), "123456789");
+  ++node;
+  BOOST_CHECK_THROW(node.getAttribute("v").as<double>(), std::exception);
+  BOOST_CHECK_THROW(node.getAttribute("v").as<int>(), std::exception);
+  ++node;
+  BOOST_CHECK_THROW(node.getAttribute("v").as<double>(), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(attribute_round_trip) {
+  const double values[] = {1.0 / 3, 6.02214076e23,
+                           std::numeric_limits<double>::min(),
+                           std::numeric_limits<double>::max()};
+  for (const double val : values) {
+    std::ostringstream os;
+    os.precision(std::numeric_limits<double>::max_digits10);
+    os << "<A v=\"" << val << "\"/>";
+    const std::string str = os.str();
+    Document XML(str.data(), str.size());
+    BOOST_CHECK_EQUAL(XML.getNode("A").getAttribute("v").as<double>(), val);
+  }
+}
@@ -0,0 +1,82 @@
+#define BOOST_TEST_MODULE XmlWriter_test
+#include <boost/test/included/unit_test.hpp>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <magnet/xmlwriter.hpp>
+#include <random>
+
+using namespace magnet::xml;
+
+namespace {
+void writeDocument(XmlStream &XML, const std::vector<double> &values) {
+  XML << std::setprecision(std::numeric_limits<double>::digits10 + 2)
+      << prolog() << tag("Doc") << attr("N") << values.size();
+  for (const double &val : values)
+    XML << tag("V") << attr("x") << val << endtag("V");
+  XML << tag("Text") << chardata() << "some text" << endtag("Text");
+}
+
+std::vector<double> randomValues(size_t N) {
+  std::mt19937 RNG(12345);
+  std::uniform_real_distribution<double> mantissa(-1, 1);
+  std::uniform_int_distribution<int> exponent(-300, 300);
+  std::vector<double> values;
+  for (size_t i(0); i < N; ++i)
+    values.push_back(std::ldexp(mantissa(RNG), exponent(RNG)));
+  values.push_back(0);
+  values.push_back(1);
+  values.push_back(-0.1);
+  values.push_back(1e20);
+  values.push_back(std::numeric_limits<double>::min());
+  values.push_back(std::numeric_limits<double>::max());
+  return values;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(streaming_matches_memory) {
+  const std::vector<double> values = randomValues(10000);
+
+  XmlStream memory;
+  writeDocument(memory, values);
+  memory << endtag("Doc");
+  const std::string expected = memory.str();
+
+  {
+    // A tiny chunk size forces many writes to the file
+    XmlStream streaming("xmlwriter_test.xml", 17);
+    writeDocument(streaming, values);
+    streaming.close();
+  }
+
+  std::ifstream in("xmlwriter_test.xml", std::ios::binary);
+  const std::string written((std::istreambuf_iterator<char>(in)),
+                            std::istreambuf_iterator<char>());
+  BOOST_CHECK(written == expected);
+}
+
+BOOST_AUTO_TEST_CASE(doubles_round_trip) {
+  const std::vector<double> values = randomValues(100000);
+  for (const double &val : values) {
+    XmlStream XML;
+    XML << std::setprecision(std::numeric_limits<double>::digits10 + 2)
+        << val;
+    BOOST_CHECK_EQUAL(std::strtod(XML.str().c_str(), nullptr), val);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(limited_precision_matches_iostream) {
+  const std::vector<double> values = randomValues(10000);
+  for (int prec : {1, 6, 13}) {
+    XmlStream XML;
+    std::ostringstream os;
+    XML << std::setprecision(prec);
+    os << std::setprecision(prec);
+    for (const double &val : values) {
+      XML << val << " ";
+      os << val << " ";
+    }
+    BOOST_CHECK(XML.str() == os.str());
+  }
+}
@@ -23,6 +23,13 @@ from pydynamo.math import conv_to_14sf, print_to_14sf, roundSF
 from pydynamo.output_properties import OutputFile, validate_outputfile
 from pydynamo.weighted_types import KeyedArray, WeightedType
 
+# The in-process simulation bindings are only present in builds with
+# the PYTHON_MODULE_ENABLED cmake option
+try:
+    from pydynamo._dynamo import Simulation
+except ImportError:
+    Simulation = None
+
 
 class SkipThisPoint(BaseException):
     pass
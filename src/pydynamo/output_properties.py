@@ -272,8 +272,17 @@ class ChungLuConfigurationModel(OutputProperty):
         for particle in configfile.tree.findall('.//Pt'):
             G.add_node(int(particle.attrib['ID']))
 
-        for pair in configfile.tree.findall('.//Interaction/CaptureMap/Pair'):
-            G.add_edge(int(pair.attrib['ID1']), int(pair.attrib['ID2']))
+        capturemap = configfile.tree.find('.//Interaction/CaptureMap')
+        if capturemap.attrib.get('Format') == 'Binary':
+            # Sorted little-endian records of (uint64 pair key, uint64 value)
+            import base64, struct
+            # An empty map is written without any character data
+            data = base64.b64decode(''.join((capturemap.text or '').split()))
+            for key, val in struct.iter_unpack('<QQ', data):
+                G.add_edge(key & 0xFFFFFFFF, key >> 32)
+        else:
+            for pair in capturemap.findall('Pair'):
+                G.add_edge(int(pair.attrib['ID1']), int(pair.attrib['ID2']))
 
         degrees = dict(G.degree())
 
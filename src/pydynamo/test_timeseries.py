@@ -0,0 +1,29 @@
+import struct
+
+from pydynamo.timeseries import MAGIC, read_timeseries, read_timeseries_dict
+
+
+def write_file(path, columns, rows, trailing=b""):
+    with open(path, "wb") as f:
+        f.write(MAGIC)
+        f.write(struct.pack("=I", len(columns)))
+        for name in columns:
+            f.write(struct.pack("=I", len(name)))
+            f.write(name.encode())
+        for row in rows:
+            f.write(struct.pack("=" + "d" * len(columns), *row))
+        f.write(trailing)
+
+
+def test_read_timeseries(tmp_path):
+    path = str(tmp_path / "ts.dat")
+    rows = [(0.5 * i, float(i * i)) for i in range(100)]
+    # A partial row, as left by a run still writing the file
+    write_file(path, ["time", "value"], rows, trailing=struct.pack("=d", 1.0))
+
+    columns, read_rows = read_timeseries(path)
+    assert columns == ["time", "value"]
+    assert read_rows == rows
+
+    data = read_timeseries_dict(path)
+    assert list(data["value"]) == [r[1] for r in rows]
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""Reader for the binary time-series files streamed by DynamO plugins
+(e.g., the TimeSeries and PeriodicMSD output plugins).
+
+The file starts with the 8 byte magic b"MAGTSER1", a uint32 count of
+the columns, then each column name as a uint32 length and its
+characters. The rest of the file is the rows, one native double per
+column. A file may be read while the simulation is still writing it,
+any partial trailing row is ignored.
+"""
+import struct
+import sys
+
+MAGIC = b"MAGTSER1"
+
+
+def read_timeseries(filename):
+    """Returns (columns, rows), where columns is a list of the column
+    names and rows is a list of tuples of floats."""
+    with open(filename, "rb") as f:
+        data = f.read()
+
+    if data[:len(MAGIC)] != MAGIC:
+        raise RuntimeError('"' + filename + '" is not a DynamO time-series file')
+
+    offset = len(MAGIC)
+    (ncolumns,) = struct.unpack_from("=I", data, offset)
+    offset += 4
+    columns = []
+    for i in range(ncolumns):
+        (length,) = struct.unpack_from("=I", data, offset)
+        offset += 4
+        columns.append(data[offset:offset + length].decode())
+        offset += length
+
+    row_bytes = 8 * ncolumns
+    nrows = (len(data) - offset) // row_bytes
+    row = struct.Struct("=" + "d" * ncolumns)
+    rows = [row.unpack_from(data, offset + i * row_bytes) for i in range(nrows)]
+    return columns, rows
+
+
+def read_timeseries_dict(filename):
+    """Returns a dictionary of column name to a list of its values. If
+    numpy is available, the values are numpy arrays."""
+    columns, rows = read_timeseries(filename)
+    try:
+        import numpy
+        data = numpy.array(rows, dtype=float).reshape(len(rows), len(columns))
+        return {name: data[:, i] for i, name in enumerate(columns)}
+    except ImportError:
+        return {name: [r[i] for r in rows] for i, name in enumerate(columns)}
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        print("Usage: timeseries.py <file>\nPrints a time-series file as text columns.")
+        sys.exit(1)
+    columns, rows = read_timeseries(sys.argv[1])
+    print("# " + " ".join(columns))
+    for r in rows:
+        print(" ".join(repr(v) for v in r))